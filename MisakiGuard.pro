@@ -96,14 +96,22 @@ INCLUDEPATH += $$PWD \
                src
 
 SOURCES += src/main.cpp \
+    src/api/binary/binary_list.cpp \
+    src/api/binary/binary_validation.cpp \
     src/api/v1/auth/create_internal_token.cpp \
     src/api/v1/auth/create_token.cpp \
+    src/api/v1/auth/get_token_keys.cpp \
     src/api/v1/auth/list_user_projects.cpp \
+    src/api/v1/auth/refresh_token.cpp \
     src/api/v1/auth/renew_token.cpp \
+    src/api/v1/auth/revoke_refresh_token.cpp \
+    src/api/v1/auth/revoke_token.cpp \
     src/api/v1/auth/validate_access.cpp \
+    src/api/v1/auth/validate_access_batch.cpp \
     src/api/v1/project/create_project.cpp \
     src/api/v1/project/delete_project.cpp \
     src/api/v1/project/get_project.cpp \
+    src/api/v1/project/list_project_members.cpp \
     src/api/v1/project/list_projects.cpp \
     src/api/v1/user/add_project_to_user.cpp \
     src/api/v1/user/create_user.cpp \
@@ -111,21 +119,58 @@ SOURCES += src/main.cpp \
     src/api/v1/user/get_user.cpp \
     src/api/v1/user/list_users.cpp \
     src/api/v1/documentation/generate_rest_api_docu.cpp \
+    src/api/v1/metrics/get_metrics.cpp \
     src/api/v1/user/remove_project_from_user.cpp \
+    src/core/access_validation.cpp \
+    src/core/base64url.cpp \
+    src/core/credential_worker_pool.cpp \
+    src/core/ed25519_key.cpp \
+    src/core/hmac_key.cpp \
+    src/core/internal_token_cache.cpp \
+    src/core/json_writer.cpp \
+    src/core/latency_histogram.cpp \
+    src/core/memberships.cpp \
+    src/core/password_hashing.cpp \
+    src/core/policy_table.cpp \
+    src/core/rate_limiter.cpp \
+    src/core/rejected_token_cache.cpp \
+    src/core/revocation_list.cpp \
+    src/core/session_handler.cpp \
+    src/core/token_cache.cpp \
+    src/core/token_key_ring.cpp \
+    src/core/token_payload.cpp \
+    src/core/token_signer.cpp \
+    src/core/token_verifier.cpp \
+    src/database/prepared_sql_admin_table.cpp \
     src/database/projects_table.cpp \
+    src/database/revocations_table.cpp \
+    src/database/sessions_table.cpp \
+    src/database/sql_connection.cpp \
+    src/database/sql_connection_pool.cpp \
+    src/database/user_cache.cpp \
+    src/database/user_projects_table.cpp \
     src/misaki_root.cpp \
     src/database/users_table.cpp
 
 HEADERS += \
+    src/api/binary/binary_list.h \
+    src/api/binary/binary_validation.h \
     src/api/v1/auth/create_internal_token.h \
     src/api/v1/auth/create_token.h \
+    src/api/v1/auth/get_token_keys.h \
     src/api/v1/auth/list_user_projects.h \
+    src/api/v1/auth/refresh_token.h \
     src/api/v1/auth/renew_token.h \
+    src/api/v1/auth/revoke_refresh_token.h \
+    src/api/v1/auth/revoke_token.h \
     src/api/v1/auth/validate_access.h \
+    src/api/v1/auth/validate_access_batch.h \
     src/api/blossom_initializing.h \
+    src/api/response_types.h \
     src/api/v1/project/create_project.h \
     src/api/v1/project/delete_project.h \
     src/api/v1/project/get_project.h \
+    src/api/v1/project/list_project_members.h \
     src/api/v1/project/list_projects.h \
     src/api/v1/user/add_project_to_user.h \
     src/api/v1/user/create_user.h \
@@ -137,7 +182,36 @@ HEADERS += \
     src/callbacks.h \
     src/config.h \
     src/api/v1/documentation/generate_rest_api_docu.h \
+    src/api/v1/metrics/get_metrics.h \
+    src/core/access_validation.h \
+    src/core/base64url.h \
+    src/core/credential_worker_pool.h \
+    src/core/ed25519_key.h \
+    src/core/hmac_key.h \
+    src/core/internal_token_cache.h \
+    src/core/json_writer.h \
+    src/core/latency_histogram.h \
+    src/core/memberships.h \
+    src/core/password_hashing.h \
+    src/core/policy_table.h \
+    src/core/rate_limiter.h \
+    src/core/rejected_token_cache.h \
+    src/core/revocation_list.h \
+    src/core/session_handler.h \
+    src/core/token_cache.h \
+    src/core/token_key_ring.h \
+    src/core/token_claims.h \
+    src/core/token_payload.h \
+    src/core/token_signer.h \
+    src/core/token_verifier.h \
+    src/database/prepared_sql_admin_table.h \
     src/database/projects_table.h \
+    src/database/revocations_table.h \
+    src/database/sessions_table.h \
+    src/database/sql_connection.h \
+    src/database/sql_connection_pool.h \
+    src/database/user_cache.h \
+    src/database/user_projects_table.h \
     src/misaki_root.h \
     src/database/users_table.h
 
@@ -0,0 +1,133 @@
+/**
+ * @file        main.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include <core/password_hashing.h>
+
+/**
+ * Measures the number of PBKDF2-password-hashes per second for different numbers of
+ * iterations, with a single thread and with one thread per cpu-core, like the workers of the
+ * CredentialWorkerPool. This helps to choose the 'password_hash_iterations' and
+ * 'password_workers' of the config for the available hardware.
+ */
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+const uint64_t HASHES_PER_THREAD = 8;
+const std::vector<uint32_t> ITERATIONS = {10000, 100000, 310000, 600000};
+
+/**
+ * @brief get time in seconds between two time-points
+ */
+double
+getDuration(const TimePoint &start,
+            const TimePoint &end)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e9;
+}
+
+/**
+ * @brief hash a password multiple times
+ *
+ * @param iterations number of iterations of each hash
+ * @param failed reference for the result, which is set to true, if a hash failed
+ */
+void
+hashPasswords(const uint32_t iterations,
+              std::atomic<bool> &failed)
+{
+    const std::string password = "benchmark_password";
+    const std::string salt = "8f0b1a6c-3c0e-4d53-9a5e-2b7f6c1d4e90";
+
+    for(uint64_t i = 0; i < HASHES_PER_THREAD; i++)
+    {
+        std::string pwHash;
+        if(hashPassword(pwHash, password, salt, iterations) == false) {
+            failed = true;
+        }
+    }
+}
+
+/**
+ * @brief measure the hashes per second with a specific number of threads
+ *
+ * @param iterations number of iterations of each hash
+ * @param numberOfThreads number of threads, which hash at the same time
+ *
+ * @return hashes per second, or -1 if a hash failed
+ */
+double
+measureHashes(const uint32_t iterations,
+              const uint32_t numberOfThreads)
+{
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> threads;
+
+    const TimePoint start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < numberOfThreads; i++) {
+        threads.emplace_back(hashPasswords, iterations, std::ref(failed));
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+    const TimePoint end = std::chrono::steady_clock::now();
+
+    if(failed) {
+        return -1.0;
+    }
+
+    return (HASHES_PER_THREAD * numberOfThreads) / getDuration(start, end);
+}
+
+int
+main()
+{
+    uint32_t numberOfCores = std::thread::hardware_concurrency();
+    if(numberOfCores == 0) {
+        numberOfCores = 1;
+    }
+
+    std::cout << "cpu-cores: " << numberOfCores << std::endl;
+    std::cout << "iterations | hashes/s (1 thread) | hashes/s ("
+              << numberOfCores << " threads)" << std::endl;
+
+    for(const uint32_t iterations : ITERATIONS)
+    {
+        const double singleThread = measureHashes(iterations, 1);
+        const double allCores = measureHashes(iterations, numberOfCores);
+        if(singleThread < 0.0
+                || allCores < 0.0)
+        {
+            std::cout << "hashing failed" << std::endl;
+            return 1;
+        }
+
+        std::cout << iterations << " | " << singleThread << " | " << allCores << std::endl;
+    }
+
+    return 0;
+}
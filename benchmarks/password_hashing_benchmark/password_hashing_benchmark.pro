@@ -0,0 +1,28 @@
+QT -= qt core gui
+
+TARGET = password_hashing_benchmark
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+LIBS += -L../../../libKitsunemimiCommon/src -lKitsunemimiCommon
+LIBS += -L../../../libKitsunemimiCommon/src/debug -lKitsunemimiCommon
+LIBS += -L../../../libKitsunemimiCommon/src/release -lKitsunemimiCommon
+INCLUDEPATH += ../../../libKitsunemimiCommon/include
+
+LIBS += -L../../../libKitsunemimiCrypto/src -lKitsunemimiCrypto
+LIBS += -L../../../libKitsunemimiCrypto/src/debug -lKitsunemimiCrypto
+LIBS += -L../../../libKitsunemimiCrypto/src/release -lKitsunemimiCrypto
+INCLUDEPATH += ../../../libKitsunemimiCrypto/include
+
+LIBS += -lcryptopp -lssl -lcrypto -pthread
+
+INCLUDEPATH += $$PWD \
+               ../../src
+
+SOURCES += main.cpp \
+    ../../src/core/password_hashing.cpp \
+    ../../src/core/base64url.cpp
+
+HEADERS += \
+    ../../src/core/password_hashing.h \
+    ../../src/core/base64url.h
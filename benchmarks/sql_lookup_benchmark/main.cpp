@@ -0,0 +1,218 @@
+/**
+ * @file        main.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include <sqlite3.h>
+
+#include <libKitsunemimiCommon/items/table_item.h>
+#include <libKitsunemimiCommon/logger.h>
+
+#include <database/sql_connection.h>
+
+/**
+ * Compares the lookup of a user by its id with a prepared statement, which is reused like
+ * within the PreparedSqlAdminTable, against a new sql-string for each lookup, like the generic
+ * HanamiSqlAdminTable creates. Both run on the same database-file in WAL-mode.
+ */
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+const uint64_t NUMBER_OF_USERS = 10000;
+const uint64_t NUMBER_OF_LOOKUPS = 100000;
+const std::string DATABASE_PATH = "/tmp/misaki_sql_lookup_benchmark.db";
+
+/**
+ * @brief get time in nano-seconds between two time-points
+ */
+double
+getDuration(const TimePoint &start,
+            const TimePoint &end)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/**
+ * @brief get id of a test-user
+ */
+std::string
+getUserId(const uint64_t number)
+{
+    return "user_" + std::to_string(number);
+}
+
+/**
+ * @brief create a new database-file with a users-table and fill it with test-users
+ *
+ * @return false, if the database could not be created, else true
+ */
+bool
+createDatabase()
+{
+    std::remove(DATABASE_PATH.c_str());
+
+    sqlite3* db = nullptr;
+    if(sqlite3_open(DATABASE_PATH.c_str(), &db) != SQLITE_OK)
+    {
+        sqlite3_close(db);
+        return false;
+    }
+
+    std::string command = "CREATE TABLE users ("
+                          "id varchar(256) PRIMARY KEY, "
+                          "name varchar(256), "
+                          "is_admin bool, "
+                          "pw_hash varchar(256), "
+                          "salt varchar(64)); "
+                          "BEGIN TRANSACTION; ";
+    for(uint64_t i = 0; i < NUMBER_OF_USERS; i++)
+    {
+        command += "INSERT INTO users VALUES ('"
+                   + getUserId(i)
+                   + "', 'name', 0, 'hash', 'salt'); ";
+    }
+    command += "COMMIT;";
+
+    const bool success = sqlite3_exec(db, command.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+    sqlite3_close(db);
+
+    return success;
+}
+
+/**
+ * @brief lookup the users with a prepared statement
+ *
+ * @return duration in nano-seconds, or -1 if a lookup failed
+ */
+double
+runPreparedLookups(SqlConnection &connection)
+{
+    const std::string statement = "SELECT id, name, is_admin, pw_hash, salt "
+                                  "FROM users WHERE id = ?;";
+    Kitsunemimi::ErrorContainer error;
+
+    const TimePoint start = std::chrono::steady_clock::now();
+    for(uint64_t i = 0; i < NUMBER_OF_LOOKUPS; i++)
+    {
+        Kitsunemimi::TableItem result;
+        if(connection.execute(result, statement, {getUserId(i % NUMBER_OF_USERS)}, error) == false
+                || result.getNumberOfRows() != 1)
+        {
+            LOG_ERROR(error);
+            return -1.0;
+        }
+    }
+    const TimePoint end = std::chrono::steady_clock::now();
+
+    return getDuration(start, end);
+}
+
+/**
+ * @brief callback for the rows of sqlite3_exec, which counts the rows
+ */
+int
+countRows(void* numberOfRows, int, char**, char**)
+{
+    (*static_cast<uint64_t*>(numberOfRows))++;
+    return 0;
+}
+
+/**
+ * @brief lookup the users with a new sql-string for each lookup, which has to be parsed and
+ *        planed again by sqlite
+ *
+ * @return duration in nano-seconds, or -1 if a lookup failed
+ */
+double
+runStringLookups(sqlite3* db)
+{
+    const TimePoint start = std::chrono::steady_clock::now();
+    for(uint64_t i = 0; i < NUMBER_OF_LOOKUPS; i++)
+    {
+        const std::string command = "SELECT id, name, is_admin, pw_hash, salt "
+                                    "FROM users WHERE id = '"
+                                    + getUserId(i % NUMBER_OF_USERS)
+                                    + "';";
+        uint64_t numberOfRows = 0;
+        if(sqlite3_exec(db, command.c_str(), countRows, &numberOfRows, nullptr) != SQLITE_OK
+                || numberOfRows != 1)
+        {
+            return -1.0;
+        }
+    }
+    const TimePoint end = std::chrono::steady_clock::now();
+
+    return getDuration(start, end);
+}
+
+int
+main()
+{
+    if(createDatabase() == false)
+    {
+        std::cout << "failed to create database '" << DATABASE_PATH << "'" << std::endl;
+        return 1;
+    }
+
+    // the writer switches the database into WAL-mode, like the connection-pool does
+    Kitsunemimi::ErrorContainer error;
+    SqlConnection writer;
+    SqlConnection reader;
+    if(writer.openConnection(DATABASE_PATH, false, error) == false
+            || reader.openConnection(DATABASE_PATH, true, error) == false)
+    {
+        LOG_ERROR(error);
+        return 1;
+    }
+
+    sqlite3* db = nullptr;
+    if(sqlite3_open_v2(DATABASE_PATH.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK)
+    {
+        std::cout << "failed to open database '" << DATABASE_PATH << "'" << std::endl;
+        sqlite3_close(db);
+        return 1;
+    }
+
+    const double preparedDuration = runPreparedLookups(reader);
+    const double stringDuration = runStringLookups(db);
+    sqlite3_close(db);
+
+    if(preparedDuration < 0.0
+            || stringDuration < 0.0)
+    {
+        std::cout << "lookup failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "lookups:            " << NUMBER_OF_LOOKUPS << std::endl;
+    std::cout << "prepared statement: "
+              << preparedDuration / NUMBER_OF_LOOKUPS << " ns per lookup" << std::endl;
+    std::cout << "new sql-string:     "
+              << stringDuration / NUMBER_OF_LOOKUPS << " ns per lookup" << std::endl;
+
+    std::remove(DATABASE_PATH.c_str());
+
+    return 0;
+}
@@ -0,0 +1,21 @@
+QT -= qt core gui
+
+TARGET = sql_lookup_benchmark
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+LIBS += -L../../../libKitsunemimiCommon/src -lKitsunemimiCommon
+LIBS += -L../../../libKitsunemimiCommon/src/debug -lKitsunemimiCommon
+LIBS += -L../../../libKitsunemimiCommon/src/release -lKitsunemimiCommon
+INCLUDEPATH += ../../../libKitsunemimiCommon/include
+
+LIBS += -lsqlite3 -pthread
+
+INCLUDEPATH += $$PWD \
+               ../../src
+
+SOURCES += main.cpp \
+    ../../src/database/sql_connection.cpp
+
+HEADERS += \
+    ../../src/database/sql_connection.h
@@ -0,0 +1,198 @@
+/**
+ * @file        main.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiJson/json_item.h>
+
+#include <core/json_writer.h>
+#include <core/token_claims.h>
+
+/**
+ * Compares the allocations and the time per token-payload of the old path, where the user is
+ * copied into a JsonItem, which is modified and serialized, against the fixed claim-layout,
+ * which is written into a reusable buffer, like within the TokenSigner. The signature is not
+ * part of the measurement, because it is the same for both.
+ */
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+const uint64_t NUMBER_OF_TOKENS = 100000;
+
+std::atomic<uint64_t> numberOfAllocations(0);
+
+/**
+ * @brief count all allocations of the process
+ */
+void*
+operator new(std::size_t size)
+{
+    numberOfAllocations++;
+    void* ptr = std::malloc(size);
+    if(ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+/**
+ * @brief get time in nano-seconds between two time-points
+ */
+double
+getDuration(const TimePoint &start,
+            const TimePoint &end)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/**
+ * @brief create the payloads like the old login, which copied the user into a JsonItem
+ *
+ * @param claims claims with the values of the payload
+ *
+ * @return total size of the payloads, to prevent that the work is optimized away
+ */
+uint64_t
+createJsonItemPayloads(const TokenClaims &claims)
+{
+    uint64_t totalSize = 0;
+    for(uint64_t i = 0; i < NUMBER_OF_TOKENS; i++)
+    {
+        // user like read from the database
+        Kitsunemimi::JsonItem userData;
+        userData.insert("id", claims.id);
+        userData.insert("name", claims.name);
+        userData.insert("is_admin", claims.isAdmin);
+        userData.insert("pw_hash", std::string("$pbkdf2-sha256$i=600000$hash"));
+        userData.insert("salt", std::string("8f0b1a6c-3c0e-4d53-9a5e-2b7f6c1d4e90"));
+        userData.insert("projects", std::string("[]"));
+
+        // remove entries, which are not allowed to be part of the token, and add the project
+        userData.remove("pw_hash");
+        userData.remove("salt");
+        userData.remove("projects");
+        userData.insert("project_id", claims.projectId);
+        userData.insert("role", claims.role);
+        userData.insert("is_project_admin", claims.isProjectAdmin);
+        userData.insert("jti", claims.tokenId);
+        userData.insert("iat", static_cast<long>(claims.iat));
+        userData.insert("nbf", static_cast<long>(claims.nbf));
+        userData.insert("exp", static_cast<long>(claims.exp));
+
+        const std::string payload = userData.toString();
+        totalSize += payload.size();
+    }
+
+    return totalSize;
+}
+
+/**
+ * @brief create the payloads with the fixed claim-layout in a reusable buffer
+ *
+ * @param claims claims with the values of the payload
+ *
+ * @return total size of the payloads, to prevent that the work is optimized away
+ */
+uint64_t
+createFixedLayoutPayloads(const TokenClaims &claims)
+{
+    std::string payload;
+    uint64_t totalSize = 0;
+    for(uint64_t i = 0; i < NUMBER_OF_TOKENS; i++)
+    {
+        writeTokenPayload(payload, claims);
+        totalSize += payload.size();
+    }
+
+    return totalSize;
+}
+
+/**
+ * @brief print the result of a measurement
+ */
+void
+printResult(const std::string &name,
+            const uint64_t allocations,
+            const double duration)
+{
+    std::cout << name
+              << static_cast<double>(allocations) / NUMBER_OF_TOKENS << " allocations and "
+              << duration / NUMBER_OF_TOKENS << " ns per token" << std::endl;
+}
+
+int
+main()
+{
+    TokenClaims claims;
+    claims.id = "benchmark_user";
+    claims.name = "Benchmark User";
+    claims.projectId = "benchmark_project";
+    claims.role = "member";
+    claims.tokenId = "0b6f2c1e-7a4d-4f3b-9c8e-5d2a1f0e3b7c";
+    claims.iat = 1700000000;
+    claims.nbf = 1700000000;
+    claims.exp = 1700003600;
+
+    uint64_t allocationsBefore = numberOfAllocations;
+    TimePoint start = std::chrono::steady_clock::now();
+    const uint64_t jsonItemSize = createJsonItemPayloads(claims);
+    TimePoint end = std::chrono::steady_clock::now();
+    const uint64_t jsonItemAllocations = numberOfAllocations - allocationsBefore;
+    const double jsonItemDuration = getDuration(start, end);
+
+    allocationsBefore = numberOfAllocations;
+    start = std::chrono::steady_clock::now();
+    const uint64_t fixedLayoutSize = createFixedLayoutPayloads(claims);
+    end = std::chrono::steady_clock::now();
+    const uint64_t fixedLayoutAllocations = numberOfAllocations - allocationsBefore;
+    const double fixedLayoutDuration = getDuration(start, end);
+
+    if(jsonItemSize == 0
+            || fixedLayoutSize == 0)
+    {
+        std::cout << "failed to create payloads" << std::endl;
+        return 1;
+    }
+
+    std::cout << "tokens:       " << NUMBER_OF_TOKENS << std::endl;
+    printResult("JsonItem:     ", jsonItemAllocations, jsonItemDuration);
+    printResult("fixed layout: ", fixedLayoutAllocations, fixedLayoutDuration);
+
+    return 0;
+}
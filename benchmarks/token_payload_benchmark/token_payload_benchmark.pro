@@ -0,0 +1,27 @@
+QT -= qt core gui
+
+TARGET = token_payload_benchmark
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+LIBS += -L../../../libKitsunemimiJson/src -lKitsunemimiJson
+LIBS += -L../../../libKitsunemimiJson/src/debug -lKitsunemimiJson
+LIBS += -L../../../libKitsunemimiJson/src/release -lKitsunemimiJson
+INCLUDEPATH += ../../../libKitsunemimiJson/include
+
+LIBS += -L../../../libKitsunemimiCommon/src -lKitsunemimiCommon
+LIBS += -L../../../libKitsunemimiCommon/src/debug -lKitsunemimiCommon
+LIBS += -L../../../libKitsunemimiCommon/src/release -lKitsunemimiCommon
+INCLUDEPATH += ../../../libKitsunemimiCommon/include
+
+LIBS += -pthread
+
+INCLUDEPATH += $$PWD \
+               ../../src
+
+SOURCES += main.cpp \
+    ../../src/core/json_writer.cpp
+
+HEADERS += \
+    ../../src/core/json_writer.h \
+    ../../src/core/token_claims.h
@@ -0,0 +1,296 @@
+/**
+ * @file        binary_list.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "binary_list.h"
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+#include <libKitsunemimiCommon/items/table_item.h>
+#include <libKitsunemimiSakuraNetwork/session.h>
+
+#include <misaki_root.h>
+#include <api/response_types.h>
+#include <core/access_validation.h>
+#include <core/json_writer.h>
+
+// number of rows per chunk, if the request doesn't define it
+const uint32_t DEFAULT_LIST_CHUNK_SIZE = 1000;
+const uint32_t MAX_LIST_CHUNK_SIZE = 10000;
+// requests are processed on the receive-thread of the session, so the number of rows per
+// request is limited to not block the other requests of the session for too long
+const uint64_t MAX_LIST_ROWS_PER_REQUEST = 50000;
+
+/**
+ * @brief send a single chunk of a list-response
+ *
+ * @param session session, which received the request
+ * @param requestId id of the request to copy into the chunk
+ * @param statusCode status-code of the response
+ * @param isLast true, if this is the last chunk of the request
+ * @param hasMore true, if the request was stopped at the maximum number of rows
+ * @param numberOfRows number of rows within the payload
+ * @param payload json-array with the rows or the error-message
+ *
+ * @return false, if sending failed, else true
+ */
+static bool
+sendListChunk(Kitsunemimi::Sakura::Session* session,
+              const uint64_t requestId,
+              const uint16_t statusCode,
+              const bool isLast,
+              const bool hasMore,
+              const uint64_t numberOfRows,
+              const std::string &payload)
+{
+    // buffer is reused by all chunks of a thread to avoid allocations
+    thread_local std::string message;
+
+    BinaryListChunk header;
+    header.requestId = requestId;
+    header.statusCode = statusCode;
+    header.isLast = isLast;
+    header.hasMore = hasMore;
+    header.numberOfRows = static_cast<uint32_t>(numberOfRows);
+    header.payloadSize = static_cast<uint32_t>(payload.size());
+
+    message.assign((char*)&header, sizeof(header));
+    message.append(payload);
+
+    Kitsunemimi::ErrorContainer error;
+    if(session->sendStreamData(message.c_str(), message.size(), error) == false)
+    {
+        LOG_ERROR(error);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get a page of the requested list
+ *
+ * @param result reference for the rows of the page
+ * @param listType type of the requested list
+ * @param afterId id of the last entry of the previous page
+ * @param limit maximum number of rows
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+static bool
+getListPage(Kitsunemimi::TableItem &result,
+            const uint8_t listType,
+            const std::string &afterId,
+            const uint32_t limit,
+            Kitsunemimi::ErrorContainer &error)
+{
+    if(listType == USER_LIST) {
+        return MisakiRoot::usersTable->getUserPage(result, afterId, limit, error);
+    }
+
+    return MisakiRoot::projectsTable->getProjectPage(result, afterId, limit, error);
+}
+
+/**
+ * @brief convert the rows of a page into a json-array
+ *
+ * @param payload reference for the resulting json-string
+ * @param table rows of the page
+ */
+static void
+convertListPage(std::string &payload,
+                Kitsunemimi::TableItem &table)
+{
+    const uint64_t numberOfRows = table.getNumberOfRows();
+    const uint64_t numberOfColumns = table.getNumberOfColums();
+
+    payload.clear();
+    payload.push_back('[');
+    for(uint64_t row = 0; row < numberOfRows; row++)
+    {
+        if(row != 0) {
+            payload.push_back(',');
+        }
+
+        payload.push_back('[');
+        for(uint32_t col = 0; col < numberOfColumns; col++)
+        {
+            if(col != 0) {
+                payload.push_back(',');
+            }
+            appendJsonString(payload, table.getCell(col, row));
+        }
+        payload.push_back(']');
+    }
+    payload.push_back(']');
+}
+
+/**
+ * @brief process a binary list-request of an admin and send the users or projects back in
+ *        chunks. Each chunk is read as separate page from the database, so the complete list
+ *        is never hold in memory. A single request sends at most MAX_LIST_ROWS_PER_REQUEST rows
+ *        and marks its last chunk with hasMore, if further rows exist.
+ *
+ * @param session session, which received the request and is used to send the chunks
+ * @param data pointer to the incoming message
+ * @param dataSize size of the incoming message
+ *
+ * @return false, if the message is not a binary list-request, else true
+ */
+bool
+processBinaryList(Kitsunemimi::Sakura::Session* session,
+                  const void* data,
+                  const uint64_t dataSize)
+{
+    // check header
+    if(dataSize < sizeof(BinaryListRequest)) {
+        return false;
+    }
+    const BinaryListRequest* request = static_cast<const BinaryListRequest*>(data);
+    if(request->type != LIST_REQUEST_MESSAGE) {
+        return false;
+    }
+
+    const uint64_t requestId = request->requestId;
+
+    // the callbacks are registered before the initialization of the root-object is finished
+    if(MisakiRoot::isReady == false)
+    {
+        sendListChunk(session,
+                      requestId,
+                      SERVICE_UNAVAILABLE_STATUS,
+                      true,
+                      false,
+                      0,
+                      "Service is not initialized yet");
+        return true;
+    }
+
+    if(request->version != BINARY_LIST_VERSION)
+    {
+        sendListChunk(session,
+                      requestId,
+                      Kitsunemimi::Hanami::BAD_REQUEST_RTYPE,
+                      true,
+                      false,
+                      0,
+                      "Unsupported version of binary list-request");
+        return true;
+    }
+
+    // check sizes
+    const uint64_t payloadSize = static_cast<uint64_t>(request->tokenSize)
+                                 + request->afterIdSize;
+    if(payloadSize != dataSize - sizeof(BinaryListRequest)
+            || request->afterIdSize > 256
+            || request->chunkSize > MAX_LIST_CHUNK_SIZE
+            || (request->listType != USER_LIST && request->listType != PROJECT_LIST))
+    {
+        sendListChunk(session,
+                      requestId,
+                      Kitsunemimi::Hanami::BAD_REQUEST_RTYPE,
+                      true,
+                      false,
+                      0,
+                      "Invalid binary list-request");
+        return true;
+    }
+
+    // get strings behind the header
+    const char* pos = static_cast<const char*>(data) + sizeof(BinaryListRequest);
+    const std::string token(pos, request->tokenSize);
+    pos += request->tokenSize;
+    std::string afterId(pos, request->afterIdSize);
+
+    // only admins are allowed to list all users and projects, like with the list-blossoms
+    TokenClaims claims;
+    std::string publicError;
+    Kitsunemimi::ErrorContainer error;
+    if(validateToken(claims, token, publicError, error) == false
+            || claims.isAdmin == false)
+    {
+        if(publicError == "") {
+            publicError = "Access denied";
+        }
+        sendListChunk(session,
+                      requestId,
+                      Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE,
+                      true,
+                      false,
+                      0,
+                      publicError);
+        return true;
+    }
+
+    uint32_t chunkSize = request->chunkSize;
+    if(chunkSize == 0) {
+        chunkSize = DEFAULT_LIST_CHUNK_SIZE;
+    }
+
+    const uint32_t idColumn = request->listType == USER_LIST
+                              ? MisakiRoot::usersTable->getPageIdColumn()
+                              : MisakiRoot::projectsTable->getPageIdColumn();
+
+    // send one chunk per page, where each page starts behind the last id of the previous one
+    std::string payload;
+    uint64_t numberOfSentRows = 0;
+    while(true)
+    {
+        Kitsunemimi::TableItem table;
+        if(getListPage(table, request->listType, afterId, chunkSize, error) == false)
+        {
+            LOG_ERROR(error);
+            sendListChunk(session,
+                          requestId,
+                          Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE,
+                          true,
+                          false,
+                          0,
+                          "Failed to read list from database");
+            return true;
+        }
+
+        const uint64_t numberOfRows = table.getNumberOfRows();
+        numberOfSentRows += numberOfRows;
+        const bool isComplete = numberOfRows < chunkSize;
+        const bool hasMore = isComplete == false
+                             && numberOfSentRows >= MAX_LIST_ROWS_PER_REQUEST;
+        const bool isLast = isComplete || hasMore;
+        convertListPage(payload, table);
+        if(sendListChunk(session,
+                         requestId,
+                         Kitsunemimi::Hanami::OK_RTYPE,
+                         isLast,
+                         hasMore,
+                         numberOfRows,
+                         payload) == false)
+        {
+            return true;
+        }
+
+        if(isLast) {
+            break;
+        }
+        afterId = table.getCell(idColumn, numberOfRows - 1);
+    }
+
+    return true;
+}
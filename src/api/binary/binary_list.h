@@ -0,0 +1,99 @@
+/**
+ * @file        binary_list.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_BINARY_LIST_H
+#define MISAKIGUARD_BINARY_LIST_H
+
+#include <stdint.h>
+#include <string>
+
+#include <api/binary/binary_validation.h>
+
+namespace Kitsunemimi {
+namespace Sakura {
+class Session;
+}
+}
+
+// IMPORTANT: the layout of these messages must be the same as in libMisakiGuard, which is used
+//            by the other components to send the requests
+
+const uint8_t BINARY_LIST_VERSION = 1;
+
+enum BinaryListTypes
+{
+    UNDEFINED_LIST = 0,
+    USER_LIST = 1,
+    PROJECT_LIST = 2,
+};
+
+/**
+ * @brief header of a binary list-request, which is answered by one or more chunks. It is
+ *        directly followed by the token and the after-id without null-terminations.
+ */
+struct BinaryListRequest
+{
+    uint8_t type = LIST_REQUEST_MESSAGE;
+    uint8_t version = BINARY_LIST_VERSION;
+    uint8_t listType = UNDEFINED_LIST;
+    uint8_t padding = 0;
+    uint32_t tokenSize = 0;
+    // maximum number of rows per chunk (0 = default)
+    uint32_t chunkSize = 0;
+    // id of the last entry of a previous request (0 = start with the first entry)
+    uint16_t afterIdSize = 0;
+    uint16_t padding2 = 0;
+    // id, which is copied into the chunks to assign them to the request
+    uint64_t requestId = 0;
+} __attribute__((packed));
+
+static_assert(sizeof(BinaryListRequest) == 24);
+
+/**
+ * @brief header of a chunk of a list-response. It is directly followed by a json-array with
+ *        the rows in the same format like the body of the list-blossoms, or by the
+ *        error-message, if the status-code is not 200.
+ */
+struct BinaryListChunk
+{
+    uint8_t type = LIST_CHUNK_MESSAGE;
+    uint8_t version = BINARY_LIST_VERSION;
+    // http-like status-code (200 = OK, 400 = BAD_REQUEST, 401 = UNAUTHORIZED)
+    uint16_t statusCode = 0;
+    // 1 for the last chunk of the request
+    uint8_t isLast = 0;
+    // 1 in the last chunk, if the request was stopped at the maximum number of rows per
+    // request, so the remaining rows have to be requested again behind the last id
+    uint8_t hasMore = 0;
+    uint16_t padding2 = 0;
+    uint32_t numberOfRows = 0;
+    uint32_t payloadSize = 0;
+    uint64_t requestId = 0;
+} __attribute__((packed));
+
+static_assert(sizeof(BinaryListChunk) == 24);
+
+bool processBinaryList(Kitsunemimi::Sakura::Session* session,
+                       const void* data,
+                       const uint64_t dataSize);
+
+#endif // MISAKIGUARD_BINARY_LIST_H
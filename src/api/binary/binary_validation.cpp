@@ -0,0 +1,228 @@
+/**
+ * @file        binary_validation.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "binary_validation.h"
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+#include <misaki_root.h>
+#include <api/response_types.h>
+#include <core/access_validation.h>
+#include <core/latency_histogram.h>
+
+using Kitsunemimi::Hanami::HttpRequestType;
+
+/**
+ * @brief append a string to a response
+ *
+ * @param response response-buffer
+ * @param value string to append
+ *
+ * @return number of appended bytes, which has to be written into the header
+ */
+static uint16_t
+appendResponseString(std::string &response,
+                     const std::string &value)
+{
+    // values in the tokens are limited by the database-columns, so this cut is only a safeguard
+    const uint16_t size = value.size() > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(value.size());
+    response.append(value.c_str(), size);
+    return size;
+}
+
+/**
+ * @brief create a binary response
+ *
+ * @param response reference for the resulting response
+ * @param requestId id of the request to copy into the response
+ * @param statusCode status-code of the response
+ * @param claims claims of the validated token
+ * @param errorMessage error-message, which can be send back
+ */
+static void
+createResponse(std::string &response,
+               const uint64_t requestId,
+               const uint16_t statusCode,
+               const TokenClaims &claims,
+               const std::string &errorMessage)
+{
+    BinaryValidationResponse header;
+    header.requestId = requestId;
+    header.statusCode = statusCode;
+    header.isAdmin = claims.isAdmin;
+    header.isProjectAdmin = claims.isProjectAdmin;
+
+    // write strings behind the space for the header and copy the header at the end, because
+    // the sizes are only known after appending the strings
+    response.assign(sizeof(BinaryValidationResponse), '\0');
+    header.idSize = appendResponseString(response, claims.id);
+    header.nameSize = appendResponseString(response, claims.name);
+    header.projectIdSize = appendResponseString(response, claims.projectId);
+    header.roleSize = appendResponseString(response, claims.role);
+    header.errorMessageSize = appendResponseString(response, errorMessage);
+    response.replace(0, sizeof(BinaryValidationResponse), (char*)&header, sizeof(header));
+}
+
+/**
+ * @brief process a binary validation-request, which can be send by co-located components
+ *        instead of the json-based validate-blossom. Component and endpoint are checked with
+ *        the same limits like the fields of the blossom, before they are used for the
+ *        policy-lookup.
+ *
+ * @param response reference for the binary response
+ * @param data pointer to the incoming message
+ * @param dataSize size of the incoming message
+ *
+ * @return false, if the message is not a binary validation-request, else true
+ */
+bool
+processBinaryValidation(std::string &response,
+                        const void* data,
+                        const uint64_t dataSize)
+{
+    // buffers are reused by all requests of the same thread to avoid allocations
+    thread_local std::string token;
+    thread_local std::string component;
+    thread_local std::string endpoint;
+
+    const TokenClaims emptyClaims;
+
+    // check header
+    if(dataSize < sizeof(BinaryValidationRequest)) {
+        return false;
+    }
+    const BinaryValidationRequest* request = static_cast<const BinaryValidationRequest*>(data);
+    if(request->type != VALIDATION_REQUEST_MESSAGE) {
+        return false;
+    }
+
+    // the callbacks are registered before the initialization of the root-object is finished
+    if(MisakiRoot::isReady == false)
+    {
+        createResponse(response,
+                       request->requestId,
+                       SERVICE_UNAVAILABLE_STATUS,
+                       emptyClaims,
+                       "Service is not initialized yet");
+        return true;
+    }
+
+    // only recognized validation-requests are part of the latency-metrics
+    LatencyMeasurement measurement(MisakiRoot::validateLatency);
+
+    if(request->version != BINARY_VALIDATION_VERSION)
+    {
+        createResponse(response,
+                       request->requestId,
+                       Kitsunemimi::Hanami::BAD_REQUEST_RTYPE,
+                       emptyClaims,
+                       "Unsupported version of binary validation-request");
+        return true;
+    }
+
+    // check sizes
+    const uint64_t payloadSize = static_cast<uint64_t>(request->tokenSize)
+                                 + request->componentSize
+                                 + request->endpointSize;
+    if(payloadSize != dataSize - sizeof(BinaryValidationRequest)
+            || request->componentSize > 256
+            || request->endpointSize > 256
+            || request->httpType > 5
+            || (request->componentSize != 0 && request->httpType == 0))
+    {
+        createResponse(response,
+                       request->requestId,
+                       Kitsunemimi::Hanami::BAD_REQUEST_RTYPE,
+                       emptyClaims,
+                       "Invalid binary validation-request");
+        return true;
+    }
+
+    // get strings behind the header
+    const char* pos = static_cast<const char*>(data) + sizeof(BinaryValidationRequest);
+    token.assign(pos, request->tokenSize);
+    pos += request->tokenSize;
+    component.assign(pos, request->componentSize);
+    pos += request->componentSize;
+    endpoint.assign(pos, request->endpointSize);
+
+    if(component.size() != 0
+            && (isValidComponent(component) == false || isValidEndpoint(endpoint) == false))
+    {
+        createResponse(response,
+                       request->requestId,
+                       Kitsunemimi::Hanami::BAD_REQUEST_RTYPE,
+                       emptyClaims,
+                       "Invalid component or endpoint in binary validation-request");
+        return true;
+    }
+
+    // validate token
+    TokenClaims claims;
+    std::string publicError;
+    Kitsunemimi::ErrorContainer error;
+    if(validateToken(claims, token, publicError, error) == false)
+    {
+        createResponse(response,
+                       request->requestId,
+                       Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE,
+                       emptyClaims,
+                       publicError);
+        return true;
+    }
+
+    // check policy
+    if(component.size() != 0)
+    {
+        const HttpRequestType httpType = static_cast<HttpRequestType>(request->httpType);
+        if(checkPolicy(claims, component, endpoint, httpType) == false)
+        {
+            createResponse(response,
+                           request->requestId,
+                           Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE,
+                           emptyClaims,
+                           "Access denied by policy");
+            return true;
+        }
+    }
+
+    createResponse(response, request->requestId, Kitsunemimi::Hanami::OK_RTYPE, claims, "");
+
+    return true;
+}
+
+/**
+ * @brief create a binary response for a request-message, which is not a binary
+ *        validation-request, so the sender is not blocked until its timeout
+ *
+ * @param response reference for the binary response
+ */
+void
+createInvalidRequestResponse(std::string &response)
+{
+    const TokenClaims emptyClaims;
+    createResponse(response,
+                   0,
+                   Kitsunemimi::Hanami::BAD_REQUEST_RTYPE,
+                   emptyClaims,
+                   "Unknown or invalid request-message");
+}
@@ -0,0 +1,92 @@
+/**
+ * @file        binary_validation.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_BINARY_VALIDATION_H
+#define MISAKIGUARD_BINARY_VALIDATION_H
+
+#include <stdint.h>
+#include <string>
+
+// IMPORTANT: the layout of these messages must be the same as in libMisakiGuard, which is used
+//            by the other components to send the requests
+
+const uint8_t BINARY_VALIDATION_VERSION = 1;
+
+enum BinaryValidationMessageTypes
+{
+    UNDEFINED_VALIDATION_MESSAGE = 0,
+    VALIDATION_REQUEST_MESSAGE = 1,
+    VALIDATION_RESPONSE_MESSAGE = 2,
+    LIST_REQUEST_MESSAGE = 3,
+    LIST_CHUNK_MESSAGE = 4,
+};
+
+/**
+ * @brief header of a binary validation-request. It is directly followed by the token, the
+ *        component-name and the endpoint-name without null-terminations.
+ */
+struct BinaryValidationRequest
+{
+    uint8_t type = VALIDATION_REQUEST_MESSAGE;
+    uint8_t version = BINARY_VALIDATION_VERSION;
+    // http-type of the request (DELETE = 1, GET = 2, HEAD = 3, POST = 4, PUT = 5)
+    uint8_t httpType = 0;
+    uint8_t padding = 0;
+    uint32_t tokenSize = 0;
+    // component-size of 0 means, that only the token is validated without policy-check
+    uint16_t componentSize = 0;
+    uint16_t endpointSize = 0;
+    uint32_t padding2 = 0;
+    // id, which is copied into the response to assign responses to requests
+    uint64_t requestId = 0;
+} __attribute__((packed));
+
+static_assert(sizeof(BinaryValidationRequest) == 24);
+
+/**
+ * @brief header of a binary validation-response. It is directly followed by the user-id, the
+ *        user-name, the project-id, the role and the error-message without null-terminations.
+ */
+struct BinaryValidationResponse
+{
+    uint8_t type = VALIDATION_RESPONSE_MESSAGE;
+    uint8_t version = BINARY_VALIDATION_VERSION;
+    // http-like status-code (200 = OK, 400 = BAD_REQUEST, 401 = UNAUTHORIZED)
+    uint16_t statusCode = 0;
+    uint8_t isAdmin = 0;
+    uint8_t isProjectAdmin = 0;
+    uint16_t idSize = 0;
+    uint16_t nameSize = 0;
+    uint16_t projectIdSize = 0;
+    uint16_t roleSize = 0;
+    uint16_t errorMessageSize = 0;
+    uint64_t requestId = 0;
+} __attribute__((packed));
+
+static_assert(sizeof(BinaryValidationResponse) == 24);
+
+bool processBinaryValidation(std::string &response,
+                             const void* data,
+                             const uint64_t dataSize);
+void createInvalidRequestResponse(std::string &response);
+
+#endif // MISAKIGUARD_BINARY_VALIDATION_H
@@ -37,15 +37,23 @@
 #include <api/v1/project/create_project.h>
 #include <api/v1/project/get_project.h>
 #include <api/v1/project/list_projects.h>
+#include <api/v1/project/list_project_members.h>
 #include <api/v1/project/delete_project.h>
 
 #include  <api/v1/documentation/generate_rest_api_docu.h>
 
+#include <api/v1/metrics/get_metrics.h>
+
 #include <api/v1/auth/create_internal_token.h>
 #include <api/v1/auth/create_token.h>
+#include <api/v1/auth/get_token_keys.h>
 #include <api/v1/auth/validate_access.h>
+#include <api/v1/auth/validate_access_batch.h>
 #include <api/v1/auth/list_user_projects.h>
+#include <api/v1/auth/refresh_token.h>
 #include <api/v1/auth/renew_token.h>
+#include <api/v1/auth/revoke_refresh_token.h>
+#include <api/v1/auth/revoke_token.h>
 
 using Kitsunemimi::Hanami::HanamiMessaging;
 
@@ -72,6 +80,27 @@ tokenBlossomes()
                            group,
                            "renew");
 
+    assert(interface->addBlossom(group, "refresh", new RefreshToken()));
+    interface->addEndpoint("v1/token/refresh",
+                           Kitsunemimi::Hanami::POST_TYPE,
+                           Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                           group,
+                           "refresh");
+
+    assert(interface->addBlossom(group, "revoke_refresh", new RevokeRefreshToken()));
+    interface->addEndpoint("v1/token/refresh",
+                           Kitsunemimi::Hanami::DELETE_TYPE,
+                           Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                           group,
+                           "revoke_refresh");
+
+    assert(interface->addBlossom(group, "revoke", new RevokeToken()));
+    interface->addEndpoint("v1/token",
+                           Kitsunemimi::Hanami::DELETE_TYPE,
+                           Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                           group,
+                           "revoke");
+
     assert(interface->addBlossom(group, "create_internal", new CreateInternalToken()));
     interface->addEndpoint("v1/token/internal",
                            Kitsunemimi::Hanami::POST_TYPE,
@@ -79,12 +108,26 @@ tokenBlossomes()
                            group,
                            "create_internal");
 
+    assert(interface->addBlossom(group, "keys", new GetTokenKeys()));
+    interface->addEndpoint("v1/token/keys",
+                           Kitsunemimi::Hanami::GET_TYPE,
+                           Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                           group,
+                           "keys");
+
     assert(interface->addBlossom(group, "validate", new ValidateAccess()));
     interface->addEndpoint("v1/auth",
                            Kitsunemimi::Hanami::GET_TYPE,
                            Kitsunemimi::Hanami::BLOSSOM_TYPE,
                            group,
                            "validate");
+
+    assert(interface->addBlossom(group, "validate_batch", new ValidateAccessBatch()));
+    interface->addEndpoint("v1/auth/batch",
+                           Kitsunemimi::Hanami::POST_TYPE,
+                           Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                           group,
+                           "validate_batch");
 }
 
 /**
@@ -104,6 +147,23 @@ documentationBlossomes()
                            "generate_rest_api");
 }
 
+/**
+ * @brief init metrics endpoints
+ */
+void
+metricsBlossomes()
+{
+    HanamiMessaging* interface = HanamiMessaging::getInstance();
+    const std::string group = "metrics";
+
+    assert(interface->addBlossom(group, "get", new GetMetrics()));
+    interface->addEndpoint("v1/metrics",
+                           Kitsunemimi::Hanami::GET_TYPE,
+                           Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                           group,
+                           "get");
+}
+
 /**
  * @brief init user endpoints
  */
@@ -194,6 +254,13 @@ projectBlossomes()
                            group,
                            "list");
 
+    assert(interface->addBlossom(group, "list_members", new ListProjectMembers()));
+    interface->addEndpoint("v1/project/members",
+                           Kitsunemimi::Hanami::GET_TYPE,
+                           Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                           group,
+                           "list_members");
+
     assert(interface->addBlossom(group, "delete", new DeleteProject()));
     interface->addEndpoint("v1/project",
                            Kitsunemimi::Hanami::DELETE_TYPE,
@@ -208,6 +275,7 @@ initBlossoms()
     projectBlossomes();
     userBlossomes();
     documentationBlossomes();
+    metricsBlossomes();
     tokenBlossomes();
 }
 
@@ -0,0 +1,32 @@
+/**
+ * @file        response_types.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_RESPONSE_TYPES_H
+#define MISAKIGUARD_RESPONSE_TYPES_H
+
+#include <stdint.h>
+
+// response-types, which are not part of the HttpResponseTypes of the hanami-common-library
+const uint16_t TOO_MANY_REQUESTS_STATUS = 429;
+const uint16_t SERVICE_UNAVAILABLE_STATUS = 503;
+
+#endif // MISAKIGUARD_RESPONSE_TYPES_H
@@ -23,10 +23,9 @@
 #include "create_internal_token.h"
 
 #include <misaki_root.h>
+#include <api/response_types.h>
+#include <core/internal_token_cache.h>
 
-#include <libKitsunemimiCommon/methods/string_methods.h>
-#include <libKitsunemimiCrypto/hashes.h>
-#include <libKitsunemimiJwt/jwt.h>
 #include <libKitsunemimiJson/json_item.h>
 
 #include <libKitsunemimiHanamiCommon/enums.h>
@@ -38,8 +37,9 @@ using namespace Kitsunemimi::Hanami;
  * @brief constructor
  */
 CreateInternalToken::CreateInternalToken()
-    : Blossom("Create a JWT-access-token for a internal services, "
-              "which can not be used from the outside.")
+    : Blossom("Get a JWT-access-token for a internal service, which is EdDSA-signed with the "
+              "internal key, so it can be verified by other internal services with the public "
+              "internal key.")
 {
     //----------------------------------------------------------------------------------------------
     // input
@@ -74,27 +74,29 @@ CreateInternalToken::runTask(BlossomIO &blossomIO,
                              BlossomStatus &status,
                              Kitsunemimi::ErrorContainer &error)
 {
+    // internal tokens are only available, if an internal key is defined
+    InternalTokenCache* internalTokenCache = MisakiRoot::internalTokenCache;
+    if(internalTokenCache == nullptr)
+    {
+        status.errorMessage = "Internal tokens are disabled, because no internal_token_key_path "
+                              "is defined in the config of misaki.";
+        error.addMeesage(status.errorMessage);
+        status.statusCode = SERVICE_UNAVAILABLE_STATUS;
+        return false;
+    }
+
     // get information from request
     const std::string serviceName = blossomIO.input.get("service_name").getString();
 
-    // create struct with the payload for the token
-    Kitsunemimi::JsonItem serviceData;
-    serviceData.insert("name", new Kitsunemimi::DataValue(serviceName));
-
-    // TODO: make validation-time configurable
+    // get cached token, which is replaced in the background before it expires
     std::string jwtToken;
-    if(MisakiRoot::jwt->create_HS256_Token(jwtToken, serviceData, 3600, error) == false)
+    if(internalTokenCache->getToken(jwtToken, serviceName, error) == false)
     {
         error.addMeesage("Failed to create JWT-Token");
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
-    // cut of signature to make the token invalid for the usage for outside of the node
-    std::vector<std::string> splitedContent;
-    Kitsunemimi::splitStringByDelimiter(splitedContent, jwtToken, '.');
-    jwtToken = splitedContent.at(0) + "." + splitedContent.at(1) + "._";
-
     // create output
     blossomIO.output.insert("token", jwtToken);
 
@@ -22,10 +22,19 @@
 
 #include "create_token.h"
 
+#include <memory>
+
 #include <misaki_root.h>
+#include <api/response_types.h>
+#include <core/token_signer.h>
+#include <core/password_hashing.h>
+#include <core/credential_worker_pool.h>
+#include <core/latency_histogram.h>
+#include <core/rate_limiter.h>
+#include <core/memberships.h>
+#include <core/token_payload.h>
+#include <core/session_handler.h>
 
-#include <libKitsunemimiCrypto/hashes.h>
-#include <libKitsunemimiJwt/jwt.h>
 #include <libKitsunemimiJson/json_item.h>
 
 #include <libKitsunemimiHanamiCommon/enums.h>
@@ -33,6 +42,89 @@
 
 using namespace Kitsunemimi::Hanami;
 
+// number of limiter-buckets, which are shared by all unknown user-ids
+const size_t NUMBER_OF_UNKNOWN_USER_BUCKETS = 256;
+
+/**
+ * @brief replace the password-hash of a user in the background. If the worker-pool is busy,
+ *        this is skipped and done at a later login.
+ *
+ * @param userId id of the user
+ * @param password verified password of the user
+ * @param salt salt of the user
+ * @param oldPwHash outdated password-hash
+ * @param iterations number of iterations for the new hash
+ */
+static void
+rehashPassword(const std::string &userId,
+               const std::string &password,
+               const std::string &salt,
+               const std::string &oldPwHash,
+               const uint32_t iterations)
+{
+    // the password has to be copied, because the task runs after the request is finished. The
+    // copy is wiped, when the last copy of the task is destroyed, also if the task is skipped.
+    const std::shared_ptr<std::string> passwordCopy(new std::string(password),
+                                                    [](std::string* value) {
+        wipePassword(*value);
+        delete value;
+    });
+
+    // the other values are copied too, because they are not secret
+    const std::function<bool()> rehashTask = [=]() {
+        std::string newPwHash;
+        const bool success = hashPassword(newPwHash, *passwordCopy, salt, iterations);
+        wipePassword(*passwordCopy);
+        if(success == false) {
+            return false;
+        }
+
+        Kitsunemimi::ErrorContainer error;
+        if(MisakiRoot::usersTable->updatePasswordHash(userId, oldPwHash, newPwHash, error) == false)
+        {
+            LOG_ERROR(error);
+            return false;
+        }
+
+        return true;
+    };
+
+    MisakiRoot::credentialWorkerPool->addBackgroundTask(rehashTask);
+}
+
+/**
+ * @brief get the decoy-hash, which is checked for unknown users. It has the configured number
+ *        of iterations, like the hashes of the users after their rehash.
+ *
+ * @return decoy-hash, which is created only once
+ */
+static const std::string&
+getDecoyHash()
+{
+    static const std::string decoyHash = []() {
+        std::string pwHash;
+        createDecoyHash(pwHash, MisakiRoot::passwordHashIterations);
+        return pwHash;
+    }();
+
+    return decoyHash;
+}
+
+/**
+ * @brief get the key of the shared limiter-bucket for an unknown user-id. The key can not
+ *        collide with a real user-id, because user-ids are not allowed to start with '?'.
+ *
+ * @param userId unknown user-id
+ *
+ * @return key of one of the shared buckets
+ */
+static std::string
+getUnknownUserKey(const std::string &userId)
+{
+    const size_t bucketId = std::hash<std::string>{}(userId) % NUMBER_OF_UNKNOWN_USER_BUCKETS;
+    return "?unknown_" + std::to_string(bucketId);
+}
+
 /**
  * @brief constructor
  */
@@ -72,6 +164,9 @@ CreateToken::CreateToken()
     registerOutputField("token",
                         SAKURA_STRING_TYPE,
                         "New JWT-access-token for the user.");
+    registerOutputField("refresh_token",
+                        SAKURA_STRING_TYPE,
+                        "Opaque token to get a new access-token without password.");
 
     //----------------------------------------------------------------------------------------------
     //
@@ -87,29 +182,54 @@ CreateToken::runTask(BlossomIO &blossomIO,
                      BlossomStatus &status,
                      Kitsunemimi::ErrorContainer &error)
 {
+    LatencyMeasurement measurement(MisakiRoot::loginLatency);
+
     const std::string userId = blossomIO.input.get("id").getString();
 
-    // get data from table
-    Kitsunemimi::JsonItem userData;
-    if(MisakiRoot::usersTable->getUser(userData, userId, error, true) == false)
+    // version has to be read before the user, so a parallel change of the projects results in an
+    // outdated version within the token and not in outdated projects with a current version
+    const int64_t membershipVersion = MisakiRoot::membershipVersions->getVersion(userId);
+
+    // get only the values of the user, which are necessary for the login
+    UserCredentials credentials;
+    const bool userExists = MisakiRoot::usersTable->getUserCredentials(credentials,
+                                                                       userId,
+                                                                       error);
+
+    // unknown user-ids are throttled like existing users and only after the database-lookup for
+    // both, so the rate-limit doesn't show, if a user exists. They share a fixed number of
+    // buckets, so they can not fill the limiter
+    const std::string limiterKey = userExists ? userId : getUnknownUserKey(userId);
+    if(MisakiRoot::loginLimiter->allow(limiterKey) == false)
     {
-        status.errorMessage = "ACCESS DENIED!\n"
-                              "User or password is incorrect.";
+        status.errorMessage = "Too many login-attempts for this user. Please try again later.";
         error.addMeesage(status.errorMessage);
-        status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
+        status.statusCode = TOO_MANY_REQUESTS_STATUS;
         return false;
     }
 
-    // regenerate password-hash for comparism
-    std::string compareHash = "";
-    const std::string saltedPw = blossomIO.input.get("password").getString()
-                                 + userData.get("salt").getString();
-    Kitsunemimi::generate_SHA_256(compareHash, saltedPw);
+    // check password on the worker-pool, so the hashing doesn't block the token-validations.
+    // unknown users are checked against a decoy-hash, so they cost the same time and pass the
+    // same admission of the pool like existing users and the response doesn't show, if the
+    // user exists
+    const std::string password = blossomIO.input.get("password").getString();
+    const std::string &salt = credentials.salt;
+    const std::string &pwHash = userExists ? credentials.pwHash : getDecoyHash();
+    const std::function<bool()> checkTask = [&]() {
+        return checkPassword(password, salt, pwHash);
+    };
 
-    // check password
-    const std::string pwHash = userData.get("pw_hash").getString();
-    if(pwHash.size() != compareHash.size()
-            || memcmp(pwHash.c_str(), compareHash.c_str(), pwHash.size()) != 0)
+    bool passwordMatches = false;
+    if(MisakiRoot::credentialWorkerPool->runTask(passwordMatches, checkTask) == false)
+    {
+        status.errorMessage = "Too many login-requests at the moment. Please try again later.";
+        error.addMeesage(status.errorMessage);
+        status.statusCode = SERVICE_UNAVAILABLE_STATUS;
+        return false;
+    }
+
+    if(userExists == false
+            || passwordMatches == false)
     {
         status.errorMessage = "ACCESS DENIED!\n"
                               "User or password is incorrect.";
@@ -118,32 +238,15 @@ CreateToken::runTask(BlossomIO &blossomIO,
         return false;
     }
 
-    // remove entries, which are NOT allowed to be part of the token
-    std::string jwtToken;
-    userData.remove("pw_hash");
-    userData.remove("salt");
-
-    Kitsunemimi::JsonItem parsedProjects = userData.get("projects");
-
-    // get project
-    const bool isAdmin = userData.get("is_admin").getBool();
-    if(isAdmin)
-    {
-        // admin user get alway the admin-project per default
-        userData.insert("project_id", "admin");
-        userData.insert("role", "admin");
-        userData.insert("is_project_admin", true);
-        userData.remove("projects");
+    // replace outdated password-hash in the background, while the password is known
+    const uint32_t iterations = MisakiRoot::passwordHashIterations;
+    if(needsRehash(pwHash, iterations)) {
+        rehashPassword(userId, password, salt, pwHash, iterations);
     }
-    else if(parsedProjects.size() != 0)
-    {
-        // normal user get assigned to first project in their project-list at beginning
-        userData.insert("project_id", parsedProjects.get(0).get("project_id"));
-        userData.insert("role", parsedProjects.get(0).get("role"));
-        userData.insert("is_project_admin", parsedProjects.get(0).get("is_project_admin"));
-        userData.remove("projects");
-    }
-    else
+
+    // get project, where only the selected values of the user are copied into the claims
+    TokenClaims claims;
+    if(selectTokenProject(claims, credentials.user, "", membershipVersion) == false)
     {
         status.errorMessage = "User with id '" + userId + "' has no project assigned.";
         error.addMeesage(status.errorMessage);
@@ -152,18 +255,33 @@ CreateToken::runTask(BlossomIO &blossomIO,
     }
 
     // create token
-    // TODO: make validation-time configurable
-    if(MisakiRoot::jwt->create_HS256_Token(jwtToken, userData, 3600, error) == false)
+    std::string jwtToken;
+    if(MisakiRoot::tokenSigner->createToken(jwtToken,
+                                            claims,
+                                            MisakiRoot::tokenLifetime,
+                                            error) == false)
     {
         error.addMeesage("Failed to create JWT-Token");
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
+    // create session, so the token can be refreshed later without password
+    std::string refreshToken;
+    if(MisakiRoot::sessionHandler->createSession(refreshToken,
+                                                 userId,
+                                                 claims.projectId,
+                                                 error) == false)
+    {
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
     blossomIO.output.insert("id", userId);
-    blossomIO.output.insert("is_admin", isAdmin);
-    blossomIO.output.insert("name", userData.get("name").getString());
+    blossomIO.output.insert("is_admin", claims.isAdmin);
+    blossomIO.output.insert("name", claims.name);
     blossomIO.output.insert("token", jwtToken);
+    blossomIO.output.insert("refresh_token", refreshToken);
 
     return true;
 }
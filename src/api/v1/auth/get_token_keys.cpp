@@ -0,0 +1,87 @@
+/**
+ * @file        get_token_keys.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "get_token_keys.h"
+
+#include <libKitsunemimiCommon/items/data_items.h>
+#include <libKitsunemimiJson/json_item.h>
+
+#include <misaki_root.h>
+#include <core/ed25519_key.h>
+#include <core/token_key_ring.h>
+
+using namespace Kitsunemimi::Hanami;
+
+/**
+ * @brief constructor
+ */
+GetTokenKeys::GetTokenKeys()
+    : Blossom("Get the public keys, which can be used by other components to verify the "
+              "EdDSA-signed tokens locally.")
+{
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("keys",
+                        SAKURA_ARRAY_TYPE,
+                        "Json-array with the public keys as json-web-keys. It is empty, "
+                        "if the tokens are signed with a shared secret.");
+    registerOutputField("internal_keys",
+                        SAKURA_ARRAY_TYPE,
+                        "Json-array with the public keys of the internal tokens as "
+                        "json-web-keys. It is empty, if the internal tokens are disabled.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+GetTokenKeys::runTask(BlossomIO &blossomIO,
+                      const Kitsunemimi::DataMap &,
+                      BlossomStatus &,
+                      Kitsunemimi::ErrorContainer &)
+{
+    Kitsunemimi::DataArray* keys = new Kitsunemimi::DataArray();
+    for(const Ed25519Key* key : MisakiRoot::tokenKeyRing->getEd25519Keys())
+    {
+        Kitsunemimi::JsonItem jwk = key->getPublicJwk();
+        keys->append(jwk.stealItemContent());
+    }
+
+    blossomIO.output.insert("keys", keys);
+
+    Kitsunemimi::DataArray* internalKeys = new Kitsunemimi::DataArray();
+    if(MisakiRoot::internalKey != nullptr)
+    {
+        Kitsunemimi::JsonItem jwk = MisakiRoot::internalKey->getPublicJwk();
+        internalKeys->append(jwk.stealItemContent());
+    }
+
+    blossomIO.output.insert("internal_keys", internalKeys);
+
+    return true;
+}
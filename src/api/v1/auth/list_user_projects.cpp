@@ -26,7 +26,6 @@
 
 #include <libKitsunemimiCommon/methods/string_methods.h>
 #include <libKitsunemimiCrypto/hashes.h>
-#include <libKitsunemimiJwt/jwt.h>
 #include <libKitsunemimiJson/json_item.h>
 
 #include <libKitsunemimiHanamiCommon/enums.h>
@@ -92,25 +91,34 @@ ListUserProjects::runTask(BlossomIO &blossomIO,
     }
 
     // get data from table
-    Kitsunemimi::JsonItem userData;
-    if(MisakiRoot::usersTable->getUser(userData, userId, error, false) == false)
+    UserMemberships userData;
+    if(MisakiRoot::usersTable->getUserMemberships(userData, userId, error) == false)
     {
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
+    Kitsunemimi::DataArray* projects = new Kitsunemimi::DataArray();
+    for(const CachedProject &project : userData.projects)
+    {
+        Kitsunemimi::DataMap* entry = new Kitsunemimi::DataMap();
+        entry->insert("project_id", new Kitsunemimi::DataValue(project.projectId));
+        entry->insert("role", new Kitsunemimi::DataValue(project.role));
+        entry->insert("is_project_admin", new Kitsunemimi::DataValue(project.isProjectAdmin));
+        projects->append(entry);
+    }
+
     // if user is global admin, add the admin-project to the list of choosable projects
-    const bool isAdmin = userData.get("is_admin").getBool();
-    if(isAdmin)
+    if(userData.isAdmin)
     {
         Kitsunemimi::DataMap* adminProject = new Kitsunemimi::DataMap();
         adminProject->insert("project_id", new Kitsunemimi::DataValue("admin"));
         adminProject->insert("role", new Kitsunemimi::DataValue("admin"));
         adminProject->insert("is_project_admin", new Kitsunemimi::DataValue(true));
-        userData.get("projects").append(adminProject);
+        projects->append(adminProject);
     }
 
-    blossomIO.output.insert("projects", userData.get("projects").stealItemContent());
+    blossomIO.output.insert("projects", projects);
 
     return true;
 }
@@ -0,0 +1,167 @@
+/**
+ * @file        refresh_token.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "refresh_token.h"
+
+#include <libKitsunemimiJson/json_item.h>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+#include <misaki_root.h>
+#include <core/memberships.h>
+#include <core/session_handler.h>
+#include <core/token_payload.h>
+#include <core/token_signer.h>
+
+using namespace Kitsunemimi::Hanami;
+
+/**
+ * @brief constructor
+ */
+RefreshToken::RefreshToken()
+    : Blossom("Create a new JWT-access-token with a refresh-token from a previous login.")
+{
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("refresh_token",
+                       SAKURA_STRING_TYPE,
+                       true,
+                       "Refresh-token, which was returned together with the access-token.");
+    assert(addFieldBorder("refresh_token", 43, 43));
+    assert(addFieldRegex("refresh_token", "[a-zA-Z_\\-0-9]*"));
+
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("id",
+                        SAKURA_STRING_TYPE,
+                        "ID of the user.");
+    registerOutputField("name",
+                        SAKURA_STRING_TYPE,
+                        "Name of the user.");
+    registerOutputField("is_admin",
+                        SAKURA_BOOL_TYPE,
+                        "Show if the user is an admin or not.");
+    registerOutputField("token",
+                        SAKURA_STRING_TYPE,
+                        "New JWT-access-token for the user.");
+    registerOutputField("refresh_token",
+                        SAKURA_STRING_TYPE,
+                        "New refresh-token, which replaces the used one.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+RefreshToken::runTask(BlossomIO &blossomIO,
+                      const Kitsunemimi::DataMap &,
+                      BlossomStatus &status,
+                      Kitsunemimi::ErrorContainer &error)
+{
+    const std::string refreshToken = blossomIO.input.get("refresh_token").getString();
+
+    // get session
+    std::string userId;
+    std::string projectId;
+    int64_t expiresAt = 0;
+    if(MisakiRoot::sessionHandler->getSession(userId,
+                                              projectId,
+                                              expiresAt,
+                                              refreshToken,
+                                              error) == false)
+    {
+        status.errorMessage = "Refresh-token is invalid or expired.";
+        error.addMeesage(status.errorMessage);
+        status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
+        return false;
+    }
+
+    // version has to be read before the user, like at the creation of a new token
+    const int64_t version = MisakiRoot::membershipVersions->getVersion(userId);
+
+    // get user, to use the current state of the user and its projects for the new token
+    UserMemberships userData;
+    if(MisakiRoot::usersTable->getUserMemberships(userData, userId, error) == false)
+    {
+        status.errorMessage = "User of the refresh-token doesn't exist anymore.";
+        error.addMeesage(status.errorMessage);
+        status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
+        return false;
+    }
+
+    // select the project, which was selected at the login
+    TokenClaims claims;
+    if(selectTokenProject(claims, userData, projectId, version) == false)
+    {
+        status.errorMessage = "User with id '"
+                              + userId
+                              + "' is not assigned to the project with id '"
+                              + projectId
+                              + "' anymore.";
+        error.addMeesage(status.errorMessage);
+        status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
+        return false;
+    }
+
+    // create token
+    std::string jwtToken;
+    if(MisakiRoot::tokenSigner->createToken(jwtToken,
+                                            claims,
+                                            MisakiRoot::tokenLifetime,
+                                            error) == false)
+    {
+        error.addMeesage("Failed to create JWT-Token");
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
+    // replace the used refresh-token, so each refresh-token can be used only once
+    std::string newRefreshToken;
+    if(MisakiRoot::sessionHandler->rotateSession(newRefreshToken,
+                                                 refreshToken,
+                                                 userId,
+                                                 projectId,
+                                                 expiresAt,
+                                                 error) == false)
+    {
+        status.errorMessage = "Refresh-token is invalid or expired.";
+        error.addMeesage(status.errorMessage);
+        status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
+        return false;
+    }
+
+    blossomIO.output.insert("id", userId);
+    blossomIO.output.insert("is_admin", claims.isAdmin);
+    blossomIO.output.insert("name", claims.name);
+    blossomIO.output.insert("token", jwtToken);
+    blossomIO.output.insert("refresh_token", newRefreshToken);
+
+    return true;
+}
@@ -23,9 +23,12 @@
 #include "renew_token.h"
 
 #include <misaki_root.h>
+#include <core/token_signer.h>
+#include <core/access_validation.h>
+#include <core/memberships.h>
+#include <core/token_payload.h>
 
 #include <libKitsunemimiCrypto/hashes.h>
-#include <libKitsunemimiJwt/jwt.h>
 #include <libKitsunemimiJson/json_item.h>
 
 #include <libKitsunemimiHanamiCommon/enums.h>
@@ -85,29 +88,40 @@ RenewToken::runTask(BlossomIO &blossomIO,
     const Kitsunemimi::Hanami::UserContext userContext(context);
     const std::string projectId = blossomIO.input.get("project_id").getString();
 
-    // get data from table
-    Kitsunemimi::JsonItem userData;
-    if(MisakiRoot::usersTable->getUser(userData, userContext.userId, error, false) == false)
+    // switch the project without database-access, if the memberships within the presented
+    // token are still up-to-date
+    TokenClaims claims;
+    bool isMember = false;
+    bool usedToken = false;
+    if(MisakiRoot::tokenMemberships)
     {
-        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
-        return false;
+        usedToken = chooseProjectFromToken(claims,
+                                           isMember,
+                                           userContext.token,
+                                           userContext.userId,
+                                           projectId);
     }
 
-    Kitsunemimi::JsonItem parsedProjects = userData.get("projects");
-
-    // if user is global admin, add the admin-project to the list of choosable projects
-    const bool isAdmin = userData.get("is_admin").getBool();
-    if(isAdmin)
+    if(usedToken == false)
     {
-        Kitsunemimi::DataMap* adminProject = new Kitsunemimi::DataMap();
-        adminProject->insert("project_id", new Kitsunemimi::DataValue("admin"));
-        adminProject->insert("role", new Kitsunemimi::DataValue("admin"));
-        adminProject->insert("is_project_admin", new Kitsunemimi::DataValue(true));
-        parsedProjects.append(adminProject);
+        // version has to be read before the user, like at the creation of a new token
+        const int64_t version = MisakiRoot::membershipVersions->getVersion(userContext.userId);
+
+        // get data from table
+        UserMemberships userData;
+        if(MisakiRoot::usersTable->getUserMemberships(userData,
+                                                      userContext.userId,
+                                                      error) == false)
+        {
+            status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+            return false;
+        }
+
+        // select project
+        isMember = selectTokenProject(claims, userData, projectId, version);
     }
 
-    // select project
-    if(chooseProject(userData, parsedProjects, projectId) == false)
+    if(isMember == false)
     {
         status.errorMessage = "User with id '"
                               + userContext.userId
@@ -120,9 +134,11 @@ RenewToken::runTask(BlossomIO &blossomIO,
     }
 
     // create token
-    // TODO: make validation-time configurable
     std::string jwtToken;
-    if(MisakiRoot::jwt->create_HS256_Token(jwtToken, userData, 3600, error) == false)
+    if(MisakiRoot::tokenSigner->createToken(jwtToken,
+                                            claims,
+                                            MisakiRoot::tokenLifetime,
+                                            error) == false)
     {
         error.addMeesage("Failed to create JWT-Token");
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
@@ -130,39 +146,61 @@ RenewToken::runTask(BlossomIO &blossomIO,
     }
 
     blossomIO.output.insert("id", userContext.userId);
-    blossomIO.output.insert("is_admin", isAdmin);
-    blossomIO.output.insert("name", userData.get("name").getString());
+    blossomIO.output.insert("is_admin", claims.isAdmin);
+    blossomIO.output.insert("name", claims.name);
     blossomIO.output.insert("token", jwtToken);
 
     return true;
 }
 
 /**
- * @brief get project information for a new selected project from the user-assigned data
+ * @brief get project information for a new selected project from the memberships, which are
+ *        stored within the presented token. This is only possible, if the memberships of the
+ *        user were not changed since the token was created.
  *
- * @param userData user-data coming from database
- * @param parsedProjects list of projects, which are assigned to the user
+ * @param newClaims reference for the claims of the new token
+ * @param isMember reference for the result, if the user is member of the selected project
+ * @param token presented token of the user
+ * @param userId id of the user
  * @param selectedProjectId new desired project-id for the new token
  *
- * @return true, if selectedProjectId is available for the user, else false
+ * @return true, if the memberships of the token could be used, false, if the database has to be
+ *         used instead
  */
 bool
-RenewToken::chooseProject(Kitsunemimi::JsonItem &userData,
-                          Kitsunemimi::JsonItem &parsedProjects,
-                          const std::string selectedProjectId)
+RenewToken::chooseProjectFromToken(TokenClaims &newClaims,
+                                   bool &isMember,
+                                   const std::string &token,
+                                   const std::string &userId,
+                                   const std::string &selectedProjectId)
 {
-    for(uint64_t i = 0; i < parsedProjects.size(); i++)
+    // errors are ignored here, because the database is used as fallback
+    Kitsunemimi::ErrorContainer error;
+    std::string publicError;
+    TokenClaims claims;
+    if(validateToken(claims, token, publicError, error) == false
+            || claims.id != userId
+            || claims.memberships == ""
+            || claims.membershipVersion != MisakiRoot::membershipVersions->getVersion(userId))
     {
-        if(parsedProjects.get(i).get("project_id").getString() == selectedProjectId)
-        {
-            userData.insert("project_id", parsedProjects.get(i).get("project_id"));
-            userData.insert("role", parsedProjects.get(i).get("role"));
-            userData.insert("is_project_admin", parsedProjects.get(i).get("is_project_admin"));
-            userData.remove("projects");
+        return false;
+    }
 
-            return true;
-        }
+    std::string role;
+    bool isProjectAdmin = false;
+    isMember = Memberships::find(role, isProjectAdmin, claims.memberships, selectedProjectId);
+    if(isMember == false) {
+        return true;
     }
 
-    return false;
+    newClaims.id = claims.id;
+    newClaims.name = claims.name;
+    newClaims.isAdmin = claims.isAdmin;
+    newClaims.projectId = selectedProjectId;
+    newClaims.role = role;
+    newClaims.isProjectAdmin = isProjectAdmin;
+    newClaims.memberships = claims.memberships;
+    newClaims.membershipVersion = claims.membershipVersion;
+
+    return true;
 }
@@ -25,6 +25,8 @@
 
 #include <libKitsunemimiHanamiNetwork/blossom.h>
 
+#include <core/token_claims.h>
+
 class RenewToken
         : public Kitsunemimi::Hanami::Blossom
 {
@@ -37,9 +39,11 @@ protected:
                  Kitsunemimi::Hanami::BlossomStatus &status,
                  Kitsunemimi::ErrorContainer &error);
 private:
-    bool chooseProject(Kitsunemimi::JsonItem &userData,
-                       Kitsunemimi::JsonItem &parsedProjects,
-                       const std::string selectedProjectId);
+    bool chooseProjectFromToken(TokenClaims &newClaims,
+                                bool &isMember,
+                                const std::string &token,
+                                const std::string &userId,
+                                const std::string &selectedProjectId);
 };
 
 #endif // MISAKIGUARD_RENEW_TOKEN_H
@@ -0,0 +1,84 @@
+/**
+ * @file        revoke_refresh_token.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "revoke_refresh_token.h"
+
+#include <libKitsunemimiJson/json_item.h>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+#include <misaki_root.h>
+#include <core/session_handler.h>
+
+using namespace Kitsunemimi::Hanami;
+
+/**
+ * @brief constructor
+ */
+RevokeRefreshToken::RevokeRefreshToken()
+    : Blossom("Revoke a refresh-token, so no new access-tokens can be created with it.")
+{
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("refresh_token",
+                       SAKURA_STRING_TYPE,
+                       true,
+                       "Refresh-token, which should be revoked.");
+    assert(addFieldBorder("refresh_token", 43, 43));
+    assert(addFieldRegex("refresh_token", "[a-zA-Z_\\-0-9]*"));
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+RevokeRefreshToken::runTask(BlossomIO &blossomIO,
+                            const Kitsunemimi::DataMap &,
+                            BlossomStatus &status,
+                            Kitsunemimi::ErrorContainer &error)
+{
+    const std::string refreshToken = blossomIO.input.get("refresh_token").getString();
+
+    // delete session of the refresh-token
+    bool deleted = false;
+    if(MisakiRoot::sessionHandler->deleteSession(deleted, refreshToken, error) == false)
+    {
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
+    if(deleted == false)
+    {
+        status.errorMessage = "Refresh-token is invalid or expired.";
+        error.addMeesage(status.errorMessage);
+        status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file        revoke_token.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "revoke_token.h"
+
+#include <libKitsunemimiJson/json_item.h>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+#include <misaki_root.h>
+#include <core/access_validation.h>
+#include <core/revocation_list.h>
+
+using namespace Kitsunemimi::Hanami;
+
+/**
+ * @brief constructor
+ */
+RevokeToken::RevokeToken()
+    : Blossom("Revoke a JWT-access-token, so it is rejected by all following validations.")
+{
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("token",
+                       SAKURA_STRING_TYPE,
+                       true,
+                       "User specific JWT-access-token, which should be revoked.");
+    assert(addFieldRegex("token", "[a-zA-Z_.\\-0-9]*"));
+
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("token_id",
+                        SAKURA_STRING_TYPE,
+                        "ID of the revoked token.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+RevokeToken::runTask(BlossomIO &blossomIO,
+                     const Kitsunemimi::DataMap &,
+                     BlossomStatus &status,
+                     Kitsunemimi::ErrorContainer &error)
+{
+    const std::string token = blossomIO.input.get("token").getString();
+
+    // only valid tokens can be revoked
+    TokenClaims claims;
+    std::string publicError;
+    if(validateToken(claims, token, publicError, error) == false)
+    {
+        status.errorMessage = publicError;
+        status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
+        return false;
+    }
+
+    // tokens from older versions have no id
+    if(claims.tokenId == "")
+    {
+        status.errorMessage = "Token has no id and can not be revoked.";
+        status.statusCode = Kitsunemimi::Hanami::BAD_REQUEST_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    if(MisakiRoot::revocationList->revokeToken(claims.tokenId, claims.exp, error) == false)
+    {
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
+    blossomIO.output.insert("token_id", claims.tokenId);
+
+    return true;
+}
@@ -24,7 +24,6 @@
 
 #include <libKitsunemimiCommon/items/data_items.h>
 #include <libKitsunemimiCommon/methods/string_methods.h>
-#include <libKitsunemimiJwt/jwt.h>
 #include <libKitsunemimiJson/json_item.h>
 
 #include <libKitsunemimiHanamiCommon/component_support.h>
@@ -33,6 +32,8 @@
 #include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
 
 #include <misaki_root.h>
+#include <core/access_validation.h>
+#include <core/latency_histogram.h>
 
 using namespace Kitsunemimi::Hanami;
 using Kitsunemimi::Hanami::HttpRequestType;
@@ -117,16 +118,18 @@ ValidateAccess::runTask(BlossomIO &blossomIO,
                         BlossomStatus &status,
                         Kitsunemimi::ErrorContainer &error)
 {
+    LatencyMeasurement measurement(MisakiRoot::validateLatency);
+
     // collect information from the input
     const std::string token = blossomIO.input.get("token").getString();
     const std::string component = blossomIO.input.get("component").getString();
     const std::string endpoint = blossomIO.input.get("endpoint").getString();
 
     // validate token
+    TokenClaims claims;
     std::string publicError;
-    if(MisakiRoot::jwt->validateToken(blossomIO.output, token, publicError, error) == false)
+    if(validateToken(claims, token, publicError, error) == false)
     {
-        error.addMeesage("Misaki failed to validate JWT-Token");
         status.errorMessage = publicError;
         status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
         return false;
@@ -146,14 +149,8 @@ ValidateAccess::runTask(BlossomIO &blossomIO,
         const uint32_t httpTypeValue = blossomIO.input.get("http_type").getInt();
         const HttpRequestType httpType = static_cast<HttpRequestType>(httpTypeValue);
 
-        // process payload to get role of user
-        const std::string role = blossomIO.output.get("role").getString();
-
         // check policy
-        if(MisakiRoot::policies->checkUserAgainstPolicy(component,
-                                                        endpoint,
-                                                        httpType,
-                                                        role) == false)
+        if(checkPolicy(claims, component, endpoint, httpType) == false)
         {
             status.errorMessage = "Access denied by policy";
             status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
@@ -162,12 +159,8 @@ ValidateAccess::runTask(BlossomIO &blossomIO,
         }
     }
 
-    // remove irrelevant fields
-    blossomIO.output.remove("pw_hash");
-    blossomIO.output.remove("creator_id");
-    blossomIO.output.remove("exp");
-    blossomIO.output.remove("iat");
-    blossomIO.output.remove("nbf");
+    // create output
+    writeClaims(blossomIO.output, claims);
 
     return true;
 }
@@ -0,0 +1,234 @@
+/**
+ * @file        validate_access_batch.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "validate_access_batch.h"
+
+#include <libKitsunemimiCommon/items/data_items.h>
+#include <libKitsunemimiJson/json_item.h>
+
+#include <misaki_root.h>
+#include <core/access_validation.h>
+#include <core/latency_histogram.h>
+
+using namespace Kitsunemimi::Hanami;
+using Kitsunemimi::Hanami::HttpRequestType;
+
+/**
+ * @brief constructor
+ */
+ValidateAccessBatch::ValidateAccessBatch()
+    : Blossom("Checks multiple JWT-access-tokens within one request, each together with an "
+              "optional check, if the user is allowed by its roles and the policy to access "
+              "a specific endpoint.")
+{
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("requests",
+                       SAKURA_ARRAY_TYPE,
+                       true,
+                       "Json-array with the requests to validate. Each entry is a json-object "
+                       "with the fields 'token', 'component', 'endpoint' and 'http_type', "
+                       "which are the same like the input of the single validation.");
+
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("results",
+                        SAKURA_ARRAY_TYPE,
+                        "Json-array with one result for each request in the same order. Each "
+                        "result has the fields 'status_code' and 'error_message' and in case "
+                        "of a valid request also the output of the single validation.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+ValidateAccessBatch::runTask(BlossomIO &blossomIO,
+                             const Kitsunemimi::DataMap &,
+                             BlossomStatus &status,
+                             Kitsunemimi::ErrorContainer &error)
+{
+    // batches have their own histogram, because their latency depends on the number of tokens
+    LatencyMeasurement measurement(MisakiRoot::validateBatchLatency);
+
+    const Kitsunemimi::JsonItem requests = blossomIO.input.get("requests");
+
+    // check size of the batch
+    if(requests.size() > m_maxBatchSize)
+    {
+        status.errorMessage = "Batch has more than "
+                              + std::to_string(m_maxBatchSize)
+                              + " requests.";
+        status.statusCode = Kitsunemimi::Hanami::BAD_REQUEST_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    // process all requests, while tokens, which appear multiple times, are only validated once
+    std::unordered_map<std::string, TokenResult> validatedTokens;
+    Kitsunemimi::DataArray* results = new Kitsunemimi::DataArray();
+    for(uint64_t i = 0; i < requests.size(); i++)
+    {
+        Kitsunemimi::JsonItem result;
+        processRequest(result, requests.get(i), validatedTokens);
+        results->append(result.stealItemContent());
+    }
+
+    blossomIO.output.insert("results", results);
+
+    return true;
+}
+
+/**
+ * @brief check the fields of a single request with the same rules like the single validation
+ *
+ * @param errorMessage reference for the error-message in case of an invalid request
+ * @param request request to check
+ *
+ * @return true, if request is valid, else false
+ */
+bool
+ValidateAccessBatch::checkInput(std::string &errorMessage,
+                                const Kitsunemimi::JsonItem &request)
+{
+    if(request.isMap() == false)
+    {
+        errorMessage = "Request is not a json-object.";
+        return false;
+    }
+
+    // check token
+    const std::string token = request.get("token").getString();
+    if(token.size() == 0
+            || checkAllowedChars(token, "_.-", false) == false)
+    {
+        errorMessage = "Field 'token' is missing or invalid.";
+        return false;
+    }
+
+    // component and endpoint are optional like in the single validation
+    const std::string component = request.get("component").getString();
+    if(component == "") {
+        return true;
+    }
+
+    if(isValidComponent(component) == false)
+    {
+        errorMessage = "Field 'component' is invalid.";
+        return false;
+    }
+
+    const std::string endpoint = request.get("endpoint").getString();
+    if(isValidEndpoint(endpoint) == false)
+    {
+        errorMessage = "Field 'endpoint' is missing or invalid.";
+        return false;
+    }
+
+    if(request.contains("http_type") == false)
+    {
+        errorMessage = "Field 'http_type' is missing.";
+        return false;
+    }
+
+    const long httpType = request.get("http_type").getLong();
+    if(httpType < 1
+            || httpType > 5)
+    {
+        errorMessage = "Field 'http_type' is invalid.";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief process a single request of the batch
+ *
+ * @param result reference for the result of the request
+ * @param request request to process
+ * @param validatedTokens results of the tokens, which were already validated within this batch
+ */
+void
+ValidateAccessBatch::processRequest(Kitsunemimi::JsonItem &result,
+                                    const Kitsunemimi::JsonItem &request,
+                                    std::unordered_map<std::string, TokenResult> &validatedTokens)
+{
+    // check input
+    std::string errorMessage;
+    if(checkInput(errorMessage, request) == false)
+    {
+        result.insert("status_code", static_cast<int>(BAD_REQUEST_RTYPE));
+        result.insert("error_message", errorMessage);
+        return;
+    }
+
+    const std::string token = request.get("token").getString();
+    const std::string component = request.get("component").getString();
+    const std::string endpoint = request.get("endpoint").getString();
+
+    // validate token, if not already done within this batch
+    auto it = validatedTokens.find(token);
+    if(it == validatedTokens.end())
+    {
+        TokenResult tokenResult;
+        Kitsunemimi::ErrorContainer error;
+        tokenResult.valid = validateToken(tokenResult.claims,
+                                          token,
+                                          tokenResult.publicError,
+                                          error);
+        it = validatedTokens.emplace(token, tokenResult).first;
+    }
+
+    const TokenResult &tokenResult = it->second;
+    if(tokenResult.valid == false)
+    {
+        result.insert("status_code", static_cast<int>(UNAUTHORIZED_RTYPE));
+        result.insert("error_message", tokenResult.publicError);
+        return;
+    }
+
+    // check policy
+    if(component != "")
+    {
+        const int httpTypeValue = request.get("http_type").getInt();
+        const HttpRequestType httpType = static_cast<HttpRequestType>(httpTypeValue);
+        if(checkPolicy(tokenResult.claims, component, endpoint, httpType) == false)
+        {
+            result.insert("status_code", static_cast<int>(UNAUTHORIZED_RTYPE));
+            result.insert("error_message", "Access denied by policy");
+            return;
+        }
+    }
+
+    result.insert("status_code", static_cast<int>(OK_RTYPE));
+    result.insert("error_message", "");
+    writeClaims(result, tokenResult.claims);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file        validate_access_batch.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_VALIDATE_ACCESS_BATCH_H
+#define MISAKIGUARD_VALIDATE_ACCESS_BATCH_H
+
+#include <unordered_map>
+
+#include <libKitsunemimiHanamiNetwork/blossom.h>
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+#include <core/token_claims.h>
+
+class ValidateAccessBatch
+        : public Kitsunemimi::Hanami::Blossom
+{
+public:
+    ValidateAccessBatch();
+
+protected:
+    bool runTask(Kitsunemimi::Hanami::BlossomIO &blossomIO,
+                 const Kitsunemimi::DataMap &,
+                 Kitsunemimi::Hanami::BlossomStatus &status,
+                 Kitsunemimi::ErrorContainer &error);
+
+private:
+    struct TokenResult
+    {
+        bool valid = false;
+        std::string publicError = "";
+        TokenClaims claims;
+    };
+
+    const uint64_t m_maxBatchSize = 1000;
+
+    void processRequest(Kitsunemimi::JsonItem &result,
+                        const Kitsunemimi::JsonItem &request,
+                        std::unordered_map<std::string, TokenResult> &validatedTokens);
+    bool checkInput(std::string &errorMessage,
+                    const Kitsunemimi::JsonItem &request);
+};
+
+#endif // MISAKIGUARD_VALIDATE_ACCESS_BATCH_H
@@ -0,0 +1,287 @@
+/**
+ * @file        get_metrics.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "get_metrics.h"
+
+#include <misaki_root.h>
+#include <core/token_cache.h>
+#include <core/rejected_token_cache.h>
+#include <core/policy_table.h>
+#include <core/revocation_list.h>
+#include <core/token_key_ring.h>
+#include <core/credential_worker_pool.h>
+#include <core/latency_histogram.h>
+#include <core/rate_limiter.h>
+#include <core/memberships.h>
+#include <core/session_handler.h>
+#include <core/internal_token_cache.h>
+#include <database/sql_connection_pool.h>
+#include <database/user_cache.h>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+using namespace Kitsunemimi::Hanami;
+
+/**
+ * @brief convert a latency-histogram into a map with the most important percentiles
+ *
+ * @param histogram histogram to convert
+ *
+ * @return new map with the values
+ */
+static Kitsunemimi::DataMap*
+createLatencyMetrics(const LatencyHistogram* histogram)
+{
+    Kitsunemimi::DataMap* result = new Kitsunemimi::DataMap();
+    const long count = histogram->getNumberOfValues();
+    const long p50 = histogram->getPercentile(0.5);
+    const long p99 = histogram->getPercentile(0.99);
+    const long p999 = histogram->getPercentile(0.999);
+    result->insert("count", new Kitsunemimi::DataValue(count));
+    result->insert("p50", new Kitsunemimi::DataValue(p50));
+    result->insert("p99", new Kitsunemimi::DataValue(p99));
+    result->insert("p999", new Kitsunemimi::DataValue(p999));
+
+    return result;
+}
+
+/**
+ * @brief constructor
+ */
+GetMetrics::GetMetrics()
+    : Blossom("Get internal counters of misaki.")
+{
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("token_cache",
+                        SAKURA_MAP_TYPE,
+                        "Counters of the cache for already validated tokens.");
+    registerOutputField("rejected_tokens",
+                        SAKURA_MAP_TYPE,
+                        "Counters of rejected token-validations.");
+    registerOutputField("policy_table",
+                        SAKURA_MAP_TYPE,
+                        "Size of the table with the compiled policy-decisions.");
+    registerOutputField("revocations",
+                        SAKURA_MAP_TYPE,
+                        "Counters of the list of revoked tokens.");
+    registerOutputField("token_keys",
+                        SAKURA_MAP_TYPE,
+                        "Number of accepted keys and key-rotations.");
+    registerOutputField("credential_workers",
+                        SAKURA_MAP_TYPE,
+                        "Counters of the worker-pool, which checks the passwords of logins.");
+    registerOutputField("login_limiter",
+                        SAKURA_MAP_TYPE,
+                        "Counters of the rate-limiter for login-attempts.");
+    registerOutputField("memberships",
+                        SAKURA_MAP_TYPE,
+                        "Number of users with changed project-memberships since the start.");
+    registerOutputField("sessions",
+                        SAKURA_MAP_TYPE,
+                        "Counters of the sessions of the refresh-tokens.");
+    registerOutputField("internal_tokens",
+                        SAKURA_MAP_TYPE,
+                        "Counters of the cache for the tokens of internal services.");
+    registerOutputField("user_cache",
+                        SAKURA_MAP_TYPE,
+                        "Counters and estimated memory-usage in bytes of the cache for the users.");
+    registerOutputField("sql_statements",
+                        SAKURA_MAP_TYPE,
+                        "Counters of the database-connections and their prepared statements.");
+    registerOutputField("latency",
+                        SAKURA_MAP_TYPE,
+                        "Latencies in micro-seconds of logins, token-validations and batches.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+GetMetrics::runTask(BlossomIO &blossomIO,
+                    const Kitsunemimi::DataMap &context,
+                    BlossomStatus &status,
+                    Kitsunemimi::ErrorContainer &)
+{
+    // check if admin
+    if(context.getBoolByKey("is_admin") == false)
+    {
+        status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
+        return false;
+    }
+
+    // counters of the token-cache
+    TokenCache* tokenCache = MisakiRoot::tokenCache;
+    Kitsunemimi::DataMap* tokenCacheMetrics = new Kitsunemimi::DataMap();
+    tokenCacheMetrics->insert("hits",
+                              new Kitsunemimi::DataValue((long)tokenCache->getNumberOfHits()));
+    tokenCacheMetrics->insert("misses",
+                              new Kitsunemimi::DataValue((long)tokenCache->getNumberOfMisses()));
+    tokenCacheMetrics->insert("evictions",
+                              new Kitsunemimi::DataValue((long)tokenCache->getNumberOfEvictions()));
+    tokenCacheMetrics->insert("entries",
+                              new Kitsunemimi::DataValue((long)tokenCache->getNumberOfEntries()));
+    blossomIO.output.insert("token_cache", tokenCacheMetrics);
+
+    // counters of rejected tokens
+    RejectedTokenCache* rejectedCache = MisakiRoot::rejectedTokenCache;
+    Kitsunemimi::DataMap* rejectedMetrics = new Kitsunemimi::DataMap();
+    const long rejections = rejectedCache->getNumberOfRejections();
+    const long cachedRejections = rejectedCache->getNumberOfCachedRejections();
+    const long rejectedEntries = rejectedCache->getNumberOfEntries();
+    rejectedMetrics->insert("rejections", new Kitsunemimi::DataValue(rejections));
+    rejectedMetrics->insert("cached_rejections", new Kitsunemimi::DataValue(cachedRejections));
+    rejectedMetrics->insert("entries", new Kitsunemimi::DataValue(rejectedEntries));
+    blossomIO.output.insert("rejected_tokens", rejectedMetrics);
+
+    // size of the compiled policy
+    PolicyTable* policyTable = MisakiRoot::policyTable;
+    Kitsunemimi::DataMap* policyTableMetrics = new Kitsunemimi::DataMap();
+    const long numberOfEndpoints = policyTable->getNumberOfEndpoints();
+    const long numberOfRoles = policyTable->getNumberOfRoles();
+    policyTableMetrics->insert("endpoints", new Kitsunemimi::DataValue(numberOfEndpoints));
+    policyTableMetrics->insert("roles", new Kitsunemimi::DataValue(numberOfRoles));
+    blossomIO.output.insert("policy_table", policyTableMetrics);
+
+    // counters of the revocation-list
+    RevocationList* revocationList = MisakiRoot::revocationList;
+    Kitsunemimi::DataMap* revocationMetrics = new Kitsunemimi::DataMap();
+    const long revokedTokens = revocationList->getNumberOfRevokedTokens();
+    const long revokedUsers = revocationList->getNumberOfRevokedUsers();
+    const long filterHits = revocationList->getNumberOfFilterHits();
+    const long revokedRequests = revocationList->getNumberOfRevokedRequests();
+    revocationMetrics->insert("revoked_tokens", new Kitsunemimi::DataValue(revokedTokens));
+    revocationMetrics->insert("revoked_users", new Kitsunemimi::DataValue(revokedUsers));
+    revocationMetrics->insert("filter_hits", new Kitsunemimi::DataValue(filterHits));
+    revocationMetrics->insert("revoked_requests", new Kitsunemimi::DataValue(revokedRequests));
+    blossomIO.output.insert("revocations", revocationMetrics);
+
+    // state of the key-ring
+    TokenKeyRing* keyRing = MisakiRoot::tokenKeyRing;
+    Kitsunemimi::DataMap* keyMetrics = new Kitsunemimi::DataMap();
+    const long numberOfKeys = keyRing->getNumberOfKeys();
+    const long rotations = keyRing->getNumberOfRotations();
+    keyMetrics->insert("keys", new Kitsunemimi::DataValue(numberOfKeys));
+    keyMetrics->insert("rotations", new Kitsunemimi::DataValue(rotations));
+    blossomIO.output.insert("token_keys", keyMetrics);
+
+    // counters of the credential-workers
+    CredentialWorkerPool* workerPool = MisakiRoot::credentialWorkerPool;
+    Kitsunemimi::DataMap* workerMetrics = new Kitsunemimi::DataMap();
+    const long queuedTasks = workerPool->getNumberOfQueuedTasks();
+    const long processedTasks = workerPool->getNumberOfProcessedTasks();
+    const long rejectedTasks = workerPool->getNumberOfRejectedTasks();
+    const long timedOutTasks = workerPool->getNumberOfTimedOutTasks();
+    const long waitingCallers = workerPool->getNumberOfWaitingCallers();
+    workerMetrics->insert("queued", new Kitsunemimi::DataValue(queuedTasks));
+    workerMetrics->insert("processed", new Kitsunemimi::DataValue(processedTasks));
+    workerMetrics->insert("rejected", new Kitsunemimi::DataValue(rejectedTasks));
+    workerMetrics->insert("timed_out", new Kitsunemimi::DataValue(timedOutTasks));
+    workerMetrics->insert("waiting", new Kitsunemimi::DataValue(waitingCallers));
+    blossomIO.output.insert("credential_workers", workerMetrics);
+
+    // counters of the login-limiter
+    RateLimiter* loginLimiter = MisakiRoot::loginLimiter;
+    Kitsunemimi::DataMap* limiterMetrics = new Kitsunemimi::DataMap();
+    const long throttled = loginLimiter->getNumberOfThrottled();
+    const long limiterEntries = loginLimiter->getNumberOfEntries();
+    limiterMetrics->insert("throttled", new Kitsunemimi::DataValue(throttled));
+    limiterMetrics->insert("entries", new Kitsunemimi::DataValue(limiterEntries));
+    blossomIO.output.insert("login_limiter", limiterMetrics);
+
+    // changed memberships
+    Kitsunemimi::DataMap* membershipMetrics = new Kitsunemimi::DataMap();
+    const long changedUsers = MisakiRoot::membershipVersions->getNumberOfEntries();
+    const long versionResets = MisakiRoot::membershipVersions->getNumberOfResets();
+    membershipMetrics->insert("changed_users", new Kitsunemimi::DataValue(changedUsers));
+    membershipMetrics->insert("resets", new Kitsunemimi::DataValue(versionResets));
+    blossomIO.output.insert("memberships", membershipMetrics);
+
+    // counters of the sessions
+    SessionHandler* sessionHandler = MisakiRoot::sessionHandler;
+    Kitsunemimi::DataMap* sessionMetrics = new Kitsunemimi::DataMap();
+    const long createdSessions = sessionHandler->getNumberOfCreatedSessions();
+    const long refreshes = sessionHandler->getNumberOfRefreshes();
+    sessionMetrics->insert("created", new Kitsunemimi::DataValue(createdSessions));
+    sessionMetrics->insert("refreshes", new Kitsunemimi::DataValue(refreshes));
+    blossomIO.output.insert("sessions", sessionMetrics);
+
+    // counters of the internal tokens, which are empty, if the internal tokens are disabled
+    InternalTokenCache* internalTokenCache = MisakiRoot::internalTokenCache;
+    Kitsunemimi::DataMap* internalMetrics = new Kitsunemimi::DataMap();
+    if(internalTokenCache != nullptr)
+    {
+        const long internalHits = internalTokenCache->getNumberOfHits();
+        const long internalCreated = internalTokenCache->getNumberOfCreatedTokens();
+        const long internalEntries = internalTokenCache->getNumberOfEntries();
+        const long internalEvictions = internalTokenCache->getNumberOfEvictions();
+        internalMetrics->insert("hits", new Kitsunemimi::DataValue(internalHits));
+        internalMetrics->insert("created", new Kitsunemimi::DataValue(internalCreated));
+        internalMetrics->insert("entries", new Kitsunemimi::DataValue(internalEntries));
+        internalMetrics->insert("evictions", new Kitsunemimi::DataValue(internalEvictions));
+    }
+    blossomIO.output.insert("internal_tokens", internalMetrics);
+
+    // counters of the user-cache
+    UserCache* userCache = MisakiRoot::userCache;
+    Kitsunemimi::DataMap* userCacheMetrics = new Kitsunemimi::DataMap();
+    const long userHits = userCache->getNumberOfHits();
+    const long userMisses = userCache->getNumberOfMisses();
+    const long userEvictions = userCache->getNumberOfEvictions();
+    const long userEntries = userCache->getNumberOfEntries();
+    const long userMemory = userCache->getMemoryUsage();
+    userCacheMetrics->insert("hits", new Kitsunemimi::DataValue(userHits));
+    userCacheMetrics->insert("misses", new Kitsunemimi::DataValue(userMisses));
+    userCacheMetrics->insert("evictions", new Kitsunemimi::DataValue(userEvictions));
+    userCacheMetrics->insert("entries", new Kitsunemimi::DataValue(userEntries));
+    userCacheMetrics->insert("memory", new Kitsunemimi::DataValue(userMemory));
+    blossomIO.output.insert("user_cache", userCacheMetrics);
+
+    // database-connections and prepared sql-statements
+    SqlConnectionPool* connectionPool = MisakiRoot::sqlConnectionPool;
+    Kitsunemimi::DataMap* sqlMetrics = new Kitsunemimi::DataMap();
+    const long readers = connectionPool->getNumberOfReaders();
+    const long waitingReads = connectionPool->getNumberOfWaitingReads();
+    const long preparedStatements = connectionPool->getNumberOfPreparedStatements();
+    const long reusedStatements = connectionPool->getNumberOfReusedStatements();
+    sqlMetrics->insert("readers", new Kitsunemimi::DataValue(readers));
+    sqlMetrics->insert("waiting_reads", new Kitsunemimi::DataValue(waitingReads));
+    sqlMetrics->insert("prepared", new Kitsunemimi::DataValue(preparedStatements));
+    sqlMetrics->insert("reused", new Kitsunemimi::DataValue(reusedStatements));
+    blossomIO.output.insert("sql_statements", sqlMetrics);
+
+    // latencies of logins and validations
+    Kitsunemimi::DataMap* latencyMetrics = new Kitsunemimi::DataMap();
+    latencyMetrics->insert("login", createLatencyMetrics(MisakiRoot::loginLatency));
+    latencyMetrics->insert("validate", createLatencyMetrics(MisakiRoot::validateLatency));
+    latencyMetrics->insert("validate_batch",
+                           createLatencyMetrics(MisakiRoot::validateBatchLatency));
+    blossomIO.output.insert("latency", latencyMetrics);
+
+    return true;
+}
@@ -102,37 +102,32 @@ CreateProject::runTask(BlossomIO &blossomIO,
     const std::string projectName = blossomIO.input.get("name").getString();
     const std::string creatorId = context.getStringByKey("id");
 
-    // check if user already exist within the table
-    Kitsunemimi::JsonItem getResult;
-    if(MisakiRoot::projectsTable->getProject(getResult, projectId, error))
-    {
-        status.errorMessage = "Project with id '" + projectId + "' already exist.";
-        status.statusCode = Kitsunemimi::Hanami::CONFLICT_RTYPE;
-        return false;
-    }
-
     // convert values
     Kitsunemimi::JsonItem userData;
     userData.insert("id", projectId);
     userData.insert("name", projectName);
     userData.insert("creator_id", creatorId);
 
-    // add new user to table
-    if(MisakiRoot::projectsTable->addProject(userData, error) == false)
+    // add new project to table, which fails, if the id is already used
+    bool added = false;
+    if(MisakiRoot::projectsTable->addProject(added, userData, error) == false)
     {
         status.errorMessage = error.toString();
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
-    // get new created user from database
-    if(MisakiRoot::projectsTable->getProject(blossomIO.output,
-                                                   projectId,
-                                                   error) == false)
+    if(added == false)
     {
-        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        status.errorMessage = "Project with id '" + projectId + "' already exist.";
+        status.statusCode = Kitsunemimi::Hanami::CONFLICT_RTYPE;
         return false;
     }
 
+    // create output from the new values instead of reading the new project again
+    blossomIO.output.insert("id", projectId);
+    blossomIO.output.insert("name", projectName);
+    blossomIO.output.insert("creator_id", creatorId);
+
     return true;
 }
@@ -23,6 +23,9 @@
 #include "delete_project.h"
 
 #include <misaki_root.h>
+#include <core/memberships.h>
+#include <core/revocation_list.h>
+#include <database/user_cache.h>
 
 #include <libKitsunemimiJson/json_item.h>
 
@@ -74,8 +77,14 @@ DeleteProject::runTask(BlossomIO &blossomIO,
     const std::string projectId = blossomIO.input.get("id").getString();
 
     // check if user exist within the table
-    Kitsunemimi::JsonItem result;
-    if(MisakiRoot::projectsTable->getProject(result, projectId, error) == false)
+    bool exists = false;
+    if(MisakiRoot::projectsTable->existsProject(exists, projectId, error) == false)
+    {
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
+    if(exists == false)
     {
         status.errorMessage = "Project with id '" + projectId + "' not found.";
         status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
@@ -83,12 +92,50 @@ DeleteProject::runTask(BlossomIO &blossomIO,
         return false;
     }
 
-    // get data from table
-    if(MisakiRoot::projectsTable->deleteProject(projectId, error) == false)
+    // delete project and remove it from all its members
+    bool deleted = false;
+    std::vector<std::string> memberIds;
+    if(MisakiRoot::projectsTable->deleteProjectWithMemberships(deleted,
+                                                               memberIds,
+                                                               projectId,
+                                                               error) == false)
     {
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
+    // update cached users and memberships of all former members first, so a failed revocation
+    // can not leave the deleted project in the cache of the remaining members
+    for(const std::string &userId : memberIds)
+    {
+        MisakiRoot::membershipVersions->updateVersion(userId);
+        MisakiRoot::userCache->removeProject(userId, projectId);
+    }
+
+    // invalidate the tokens of the former members, because they can still contain the project.
+    // A failed revocation doesn't stop the revocation of the other members.
+    bool revocationFailed = false;
+    for(const std::string &userId : memberIds)
+    {
+        if(MisakiRoot::revocationList->revokeUser(userId, error) == false) {
+            revocationFailed = true;
+        }
+    }
+
+    if(revocationFailed)
+    {
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
+    // project was deleted by a parallel request, but remaining memberships are still removed
+    if(deleted == false)
+    {
+        status.errorMessage = "Project with id '" + projectId + "' not found.";
+        status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
     return true;
 }
@@ -0,0 +1,115 @@
+/**
+ * @file        list_project_members.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "list_project_members.h"
+
+#include <misaki_root.h>
+
+#include <libKitsunemimiJson/json_item.h>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+#include <libKitsunemimiHanamiCommon/defines.h>
+#include <libKitsunemimiHanamiCommon/structs.h>
+
+using namespace Kitsunemimi::Hanami;
+
+/**
+ * @brief constructor
+ */
+ListProjectMembers::ListProjectMembers()
+    : Blossom("List all users, which are assigned to a specific project.")
+{
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("id",
+                       SAKURA_STRING_TYPE,
+                       true,
+                       "ID of the project.");
+    // column in database is limited to 256 characters size
+    assert(addFieldBorder("id", 4, 256));
+    assert(addFieldRegex("id", ID_REGEX));
+
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("members",
+                        SAKURA_ARRAY_TYPE,
+                        "Json-array with all members of the project "
+                        "together with role and project-admin-status.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+ListProjectMembers::runTask(BlossomIO &blossomIO,
+                            const Kitsunemimi::DataMap &context,
+                            BlossomStatus &status,
+                            Kitsunemimi::ErrorContainer &error)
+{
+    const Kitsunemimi::Hanami::UserContext userContext(context);
+    const std::string projectId = blossomIO.input.get("id").getString();
+
+    // only admins and the admins of the project itself are allowed to see the members
+    if(userContext.isAdmin == false
+            && (userContext.isProjectAdmin == false || userContext.projectId != projectId))
+    {
+        status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
+        return false;
+    }
+
+    // check if project exist within the table
+    bool exists = false;
+    if(MisakiRoot::projectsTable->existsProject(exists, projectId, error) == false)
+    {
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
+    if(exists == false)
+    {
+        status.errorMessage = "Project with id '" + projectId + "' not found.";
+        status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    // get members by the reverse index of the memberships
+    Kitsunemimi::DataArray* members = new Kitsunemimi::DataArray();
+    if(MisakiRoot::userProjectsTable->getMembersOfProject(*members, projectId, error) == false)
+    {
+        delete members;
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
+    blossomIO.output.insert("members", members);
+
+    return true;
+}
@@ -34,6 +34,24 @@ using namespace Kitsunemimi::Hanami;
 ListProjects::ListProjects()
     : Blossom("Get information of all registered user as table.")
 {
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("limit",
+                       SAKURA_INT_TYPE,
+                       false,
+                       "Maximum number of projects within the response. If not set, all projects "
+                       "behind 'after_id' are returned.");
+    assert(addFieldBorder("limit", 1, 10000));
+
+    registerInputField("after_id",
+                       SAKURA_STRING_TYPE,
+                       false,
+                       "ID of the last project of the previous page. The response starts with the "
+                       "next project ordered by ID.");
+    assert(addFieldBorder("after_id", 1, 256));
+
     //----------------------------------------------------------------------------------------------
     // output
     //----------------------------------------------------------------------------------------------
@@ -47,6 +65,10 @@ ListProjects::ListProjects()
     registerOutputField("body",
                         SAKURA_ARRAY_TYPE,
                         "Array with all rows of the table, which array arrays too.");
+    registerOutputField("next_after_id",
+                        SAKURA_STRING_TYPE,
+                        "Value for 'after_id' to get the next page, or empty, if there are no "
+                        "further projects.");
 
     //----------------------------------------------------------------------------------------------
     //
@@ -69,16 +91,37 @@ ListProjects::runTask(BlossomIO &blossomIO,
         return false;
     }
 
-    // get data from table
+    // without limit all remaining projects are requested
+    int64_t limit = -1;
+    if(blossomIO.input.contains("limit")) {
+        limit = blossomIO.input.get("limit").getLong();
+    }
+    std::string afterId = "";
+    if(blossomIO.input.contains("after_id")) {
+        afterId = blossomIO.input.get("after_id").getString();
+    }
+
+    // get page from table
     Kitsunemimi::TableItem table;
-    if(MisakiRoot::projectsTable->getAllProjects(table, error) == false)
+    if(MisakiRoot::projectsTable->getProjectPage(table, afterId, limit, error) == false)
     {
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
+    // a full page can be followed by further projects, which start behind its last id
+    std::string nextAfterId = "";
+    const uint64_t numberOfRows = table.getNumberOfRows();
+    if(limit > 0
+            && numberOfRows == static_cast<uint64_t>(limit))
+    {
+        const uint32_t idColumn = MisakiRoot::projectsTable->getPageIdColumn();
+        nextAfterId = table.getCell(idColumn, numberOfRows - 1);
+    }
+
     blossomIO.output.insert("header", table.getInnerHeader());
     blossomIO.output.insert("body", table.getBody());
+    blossomIO.output.insert("next_after_id", nextAfterId);
 
     return true;
 }
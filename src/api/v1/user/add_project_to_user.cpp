@@ -23,6 +23,7 @@
 #include "add_project_to_user.h"
 
 #include <misaki_root.h>
+#include <core/memberships.h>
 #include <libKitsunemimiHanamiCommon/uuid.h>
 #include <libKitsunemimiHanamiCommon/enums.h>
 #include <libKitsunemimiHanamiCommon/defines.h>
@@ -120,57 +121,49 @@ AddProjectToUser::runTask(BlossomIO &blossomIO,
     const std::string creatorId = context.getStringByKey("id");
 
     // check if user already exist within the table
-    Kitsunemimi::JsonItem getResult;
-    if(MisakiRoot::usersTable->getUser(getResult, userId, error, false) == false)
+    if(MisakiRoot::usersTable->getUser(blossomIO.output, userId, error, false) == false)
     {
         status.errorMessage = "User with id '" + userId + "' not found.";
         status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
         return false;
     }
 
-    // check if project is already assigned to user
-    Kitsunemimi::JsonItem parsedProjects = getResult.get("projects");
-    for(uint64_t i = 0; i < parsedProjects.size(); i++)
-    {
-        if(parsedProjects.get(i).get("project_id").getString() == projectId)
-        {
-            status.errorMessage = "Project with ID '"
-                                  + projectId
-                                  + "' is already assigned to user with id '"
-                                  + userId
-                                  + "'.";
-            error.addMeesage(status.errorMessage);
-            status.statusCode = Kitsunemimi::Hanami::CONFLICT_RTYPE;
-            return false;
-        }
-    }
-
-    // create new entry
-    Kitsunemimi::JsonItem newEntry;
-    newEntry.insert("project_id", projectId);
-    newEntry.insert("role", role);
-    newEntry.insert("is_project_admin", isProjectAdmin);
-    parsedProjects.append(newEntry);
-
-    // updated projects of user in database
-    if(MisakiRoot::usersTable->updateProjectsOfUser(userId,
-                                                    parsedProjects.toString(),
-                                                    error) == false)
+    // add project with a single insert, which doesn't change anything, if the project is
+    // already assigned to the user
+    bool added = false;
+    if(MisakiRoot::usersTable->addProjectToUser(added,
+                                                userId,
+                                                projectId,
+                                                role,
+                                                isProjectAdmin,
+                                                error) == false)
     {
         error.addMeesage("Failed to update projects of user with id '" + userId + "'.");
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
-    // get new created user from database
-    if(MisakiRoot::usersTable->getUser(blossomIO.output,
-                                       userId,
-                                       error,
-                                       false) == false)
+    if(added == false)
     {
-        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        status.errorMessage = "Project with ID '"
+                              + projectId
+                              + "' is already assigned to user with id '"
+                              + userId
+                              + "'.";
+        error.addMeesage(status.errorMessage);
+        status.statusCode = Kitsunemimi::Hanami::CONFLICT_RTYPE;
         return false;
     }
 
+    // memberships within existing tokens of the user are outdated now
+    MisakiRoot::membershipVersions->updateVersion(userId);
+
+    // add new entry to the output instead of reading the user again
+    Kitsunemimi::JsonItem newEntry;
+    newEntry.insert("project_id", projectId);
+    newEntry.insert("role", role);
+    newEntry.insert("is_project_admin", isProjectAdmin);
+    blossomIO.output.get("projects").append(newEntry);
+
     return true;
 }
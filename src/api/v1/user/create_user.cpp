@@ -23,11 +23,13 @@
 #include "create_user.h"
 
 #include <misaki_root.h>
+#include <api/response_types.h>
+#include <core/password_hashing.h>
+#include <core/credential_worker_pool.h>
 #include <libKitsunemimiHanamiCommon/uuid.h>
 #include <libKitsunemimiHanamiCommon/enums.h>
 #include <libKitsunemimiHanamiCommon/defines.h>
 
-#include <libKitsunemimiCrypto/hashes.h>
 #include <libKitsunemimiCommon/methods/string_methods.h>
 #include <libKitsunemimiJson/json_item.h>
 
@@ -114,20 +116,28 @@ CreateUser::runTask(BlossomIO &blossomIO,
     const std::string newUserId = blossomIO.input.get("id").getString();
     const std::string creatorId = context.getStringByKey("id");
 
-    // check if user already exist within the table
-    Kitsunemimi::JsonItem getResult;
-    if(MisakiRoot::usersTable->getUser(getResult, newUserId, error, false))
+    // genreate hash from password and random salt on the worker-pool for the credentials
+    std::string pwHash;
+    const std::string salt = Kitsunemimi::Hanami::generateUuid().toString();
+    const std::string password = blossomIO.input.get("password").getString();
+    const std::function<bool()> hashTask = [&]() {
+        return hashPassword(pwHash, password, salt, MisakiRoot::passwordHashIterations);
+    };
+
+    bool hashSuccess = false;
+    if(MisakiRoot::credentialWorkerPool->runTask(hashSuccess, hashTask) == false)
     {
-        status.errorMessage = "User with id '" + newUserId + "' already exist.";
-        status.statusCode = Kitsunemimi::Hanami::CONFLICT_RTYPE;
+        status.errorMessage = "Too many password-requests at the moment. Please try again later.";
+        error.addMeesage(status.errorMessage);
+        status.statusCode = SERVICE_UNAVAILABLE_STATUS;
+        return false;
+    }
+    if(hashSuccess == false)
+    {
+        error.addMeesage("Failed to hash password of new user");
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
-
-    // genreate hash from password and random salt
-    std::string pwHash;
-    const std::string salt = Kitsunemimi::Hanami::generateUuid().toString();
-    const std::string saltedPw = blossomIO.input.get("password").getString() + salt;
-    Kitsunemimi::generate_SHA_256(pwHash, saltedPw);
 
     // convert values
     Kitsunemimi::JsonItem userData;
@@ -139,23 +149,28 @@ CreateUser::runTask(BlossomIO &blossomIO,
     userData.insert("creator_id", creatorId);
     userData.insert("salt", salt);
 
-    // add new user to table
-    if(MisakiRoot::usersTable->addUser(userData, error) == false)
+    // add new user to table, which fails, if the id is already used
+    bool added = false;
+    if(MisakiRoot::usersTable->addUser(added, userData, error) == false)
     {
         status.errorMessage = error.toString();
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
-    // get new created user from database
-    if(MisakiRoot::usersTable->getUser(blossomIO.output,
-                                       newUserId,
-                                       error,
-                                       false) == false)
+    if(added == false)
     {
-        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        status.errorMessage = "User with id '" + newUserId + "' already exist.";
+        status.statusCode = Kitsunemimi::Hanami::CONFLICT_RTYPE;
         return false;
     }
 
+    // create output from the new values instead of reading the new user again
+    blossomIO.output.insert("id", newUserId);
+    blossomIO.output.insert("name", userData.get("name").getString());
+    blossomIO.output.insert("is_admin", userData.get("is_admin").getBool());
+    blossomIO.output.insert("creator_id", creatorId);
+    blossomIO.output.insert("projects", new Kitsunemimi::DataArray());
+
     return true;
 }
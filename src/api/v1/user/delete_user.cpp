@@ -23,6 +23,9 @@
 #include "delete_user.h"
 
 #include <misaki_root.h>
+#include <core/revocation_list.h>
+#include <core/memberships.h>
+#include <core/session_handler.h>
 
 #include <libKitsunemimiJson/json_item.h>
 
@@ -75,8 +78,14 @@ DeleteUser::runTask(BlossomIO &blossomIO,
     const std::string userId = blossomIO.input.get("id").getString();
 
     // check if user exist within the table
-    Kitsunemimi::JsonItem result;
-    if(MisakiRoot::usersTable->getUser(result, userId, error, false) == false)
+    bool exists = false;
+    if(MisakiRoot::usersTable->existsUser(exists, userId, error) == false)
+    {
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
+    if(exists == false)
     {
         status.errorMessage = "User with id '" + userId + "' not found.";
         status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
@@ -85,7 +94,7 @@ DeleteUser::runTask(BlossomIO &blossomIO,
     }
 
     // prevent user from deleting himself
-    if(result.get("id").getString() == deleterId)
+    if(userId == deleterId)
     {
         status.errorMessage = "User with id '"
                               + userId
@@ -102,5 +111,22 @@ DeleteUser::runTask(BlossomIO &blossomIO,
         return false;
     }
 
+    // remove sessions, so the user can not get new tokens with its refresh-tokens
+    if(MisakiRoot::sessionHandler->deleteSessionsOfUser(userId, error) == false)
+    {
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
+    // invalidate all tokens, which were issued for the deleted user
+    if(MisakiRoot::revocationList->revokeUser(userId, error) == false)
+    {
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
+    }
+
+    // the version isn't necessary anymore, because all old tokens of the user are revoked
+    MisakiRoot::membershipVersions->removeUser(userId);
+
     return true;
 }
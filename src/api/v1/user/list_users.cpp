@@ -34,6 +34,24 @@ using namespace Kitsunemimi::Hanami;
 ListUsers::ListUsers()
     : Blossom("Get information of all registered users.")
 {
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("limit",
+                       SAKURA_INT_TYPE,
+                       false,
+                       "Maximum number of users within the response. If not set, all users "
+                       "behind 'after_id' are returned.");
+    assert(addFieldBorder("limit", 1, 10000));
+
+    registerInputField("after_id",
+                       SAKURA_STRING_TYPE,
+                       false,
+                       "ID of the last user of the previous page. The response starts with the "
+                       "next user ordered by ID.");
+    assert(addFieldBorder("after_id", 1, 256));
+
     //----------------------------------------------------------------------------------------------
     // output
     //----------------------------------------------------------------------------------------------
@@ -49,6 +67,10 @@ ListUsers::ListUsers()
     registerOutputField("body",
                         SAKURA_ARRAY_TYPE,
                         "Array with all rows of the table, which array arrays too.");
+    registerOutputField("next_after_id",
+                        SAKURA_STRING_TYPE,
+                        "Value for 'after_id' to get the next page, or empty, if there are no "
+                        "further users.");
 
     //----------------------------------------------------------------------------------------------
     //
@@ -71,16 +93,37 @@ ListUsers::runTask(BlossomIO &blossomIO,
         return false;
     }
 
-    // get data from table
+    // without limit all remaining users are requested
+    int64_t limit = -1;
+    if(blossomIO.input.contains("limit")) {
+        limit = blossomIO.input.get("limit").getLong();
+    }
+    std::string afterId = "";
+    if(blossomIO.input.contains("after_id")) {
+        afterId = blossomIO.input.get("after_id").getString();
+    }
+
+    // get page from table
     Kitsunemimi::TableItem table;
-    if(MisakiRoot::usersTable->getAllUser(table, error) == false)
+    if(MisakiRoot::usersTable->getUserPage(table, afterId, limit, error) == false)
     {
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
+    // a full page can be followed by further users, which start behind its last id
+    std::string nextAfterId = "";
+    const uint64_t numberOfRows = table.getNumberOfRows();
+    if(limit > 0
+            && numberOfRows == static_cast<uint64_t>(limit))
+    {
+        const uint32_t idColumn = MisakiRoot::usersTable->getPageIdColumn();
+        nextAfterId = table.getCell(idColumn, numberOfRows - 1);
+    }
+
     blossomIO.output.insert("header", table.getInnerHeader());
     blossomIO.output.insert("body", table.getBody());
+    blossomIO.output.insert("next_after_id", nextAfterId);
 
     return true;
 }
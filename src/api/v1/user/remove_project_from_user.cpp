@@ -23,6 +23,8 @@
 #include "remove_project_from_user.h"
 
 #include <misaki_root.h>
+#include <core/revocation_list.h>
+#include <core/memberships.h>
 #include <libKitsunemimiHanamiCommon/uuid.h>
 #include <libKitsunemimiHanamiCommon/enums.h>
 #include <libKitsunemimiHanamiCommon/defines.h>
@@ -105,29 +107,29 @@ RemoveProjectFromUser::runTask(BlossomIO &blossomIO,
     const std::string creatorId = context.getStringByKey("id");
 
     // check if user already exist within the table
-    Kitsunemimi::JsonItem getResult;
-    if(MisakiRoot::usersTable->getUser(getResult, userId, error, false) == false)
+    if(MisakiRoot::usersTable->getUser(blossomIO.output, userId, error, false) == false)
     {
         status.errorMessage = "User with id '" + userId + "' not found.";
         status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
         return false;
     }
 
-    // check if project is assigned to user and remove it if found
-    bool found = false;
-    Kitsunemimi::JsonItem parsedProjects = getResult.get("projects");
-    for(uint64_t i = 0; i < parsedProjects.size(); i++)
+    // remove project with a single delete
+    bool removed = false;
+    if(MisakiRoot::usersTable->removeProjectFromUser(removed,
+                                                     userId,
+                                                     projectId,
+                                                     error) == false)
     {
-        if(parsedProjects.get(i).get("project_id").getString() == projectId)
-        {
-            parsedProjects.remove(i);
-            found = true;
-            break;
-        }
+        error.addMeesage("Failed to update projects of user with id '"
+                         + userId
+                         + "'.");
+        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
+        return false;
     }
 
     // handle error that project is not assigned to user
-    if(found == false)
+    if(removed == false)
     {
         status.errorMessage = "Project with ID '"
                               + projectId
@@ -139,26 +141,25 @@ RemoveProjectFromUser::runTask(BlossomIO &blossomIO,
         return false;
     }
 
-    // updated projects of user in database
-    if(MisakiRoot::usersTable->updateProjectsOfUser(userId,
-                                                    parsedProjects.toString(),
-                                                    error) == false)
+    // memberships within existing tokens of the user are outdated now
+    MisakiRoot::membershipVersions->updateVersion(userId);
+
+    // invalidate old tokens of the user, because they can still contain the removed project
+    if(MisakiRoot::revocationList->revokeUser(userId, error) == false)
     {
-        error.addMeesage("Failed to update projects of user with id '"
-                         + userId
-                         + "'.");
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
-    // get new created user from database
-    if(MisakiRoot::usersTable->getUser(blossomIO.output,
-                                       userId,
-                                       error,
-                                       false) == false)
+    // remove entry from the output instead of reading the user again
+    Kitsunemimi::JsonItem projects = blossomIO.output.get("projects");
+    for(uint64_t i = 0; i < projects.size(); i++)
     {
-        status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
-        return false;
+        if(projects.get(i).get("project_id").getString() == projectId)
+        {
+            projects.remove(i);
+            break;
+        }
     }
 
     return true;
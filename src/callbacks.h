@@ -26,21 +26,53 @@
 #include <libKitsunemimiSakuraNetwork/session.h>
 #include <libKitsunemimiJson/json_item.h>
 
+#include <api/binary/binary_validation.h>
+#include <api/binary/binary_list.h>
+
+/**
+ * @brief handle binary validation- and list-requests, which were send as stream-message. The
+ *        responses are send back as stream-messages too and can be assigned by the request-id.
+ */
 void streamDataCallback(void*,
-                        Kitsunemimi::Sakura::Session*,
-                        const void*,
-                        const uint64_t)
+                        Kitsunemimi::Sakura::Session* session,
+                        const void* data,
+                        const uint64_t dataSize)
 {
+    thread_local std::string response;
+    if(processBinaryValidation(response, data, dataSize) == false)
+    {
+        // lists are send in multiple chunks, so they are send directly while reading
+        processBinaryList(session, data, dataSize);
+        return;
+    }
 
+    Kitsunemimi::ErrorContainer error;
+    if(session->sendStreamData(response.c_str(), response.size(), error) == false) {
+        LOG_ERROR(error);
+    }
 }
 
-void genericCallback(Kitsunemimi::Sakura::Session*,
+/**
+ * @brief handle binary validation-requests, which were send as request-message and so are
+ *        answered with a response-message. Other request-messages are answered with an error.
+ */
+void genericCallback(Kitsunemimi::Sakura::Session* session,
                      const uint32_t,
-                     void*,
-                     const uint64_t,
-                     const uint64_t)
+                     void* data,
+                     const uint64_t dataSize,
+                     const uint64_t blockerId)
 {
+    thread_local std::string response;
+    if(processBinaryValidation(response, data, dataSize) == false)
+    {
+        // the sender waits for a response, so it is also send for unknown messages
+        createInvalidRequestResponse(response);
+    }
 
+    Kitsunemimi::ErrorContainer error;
+    if(session->sendResponse(response.c_str(), response.size(), blockerId, error) == false) {
+        LOG_ERROR(error);
+    }
 }
 
 #endif // MISAKIGUARD_CALLBACKS_H
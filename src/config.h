@@ -35,8 +35,37 @@ registerConfigs(Kitsunemimi::ErrorContainer &error)
 {
     Kitsunemimi::Hanami::registerBasicConfigs(error);
 
-    REGISTER_STRING_CONFIG("misaki", "token_key_path", error, "", true);
+    REGISTER_STRING_CONFIG("misaki", "token_key_path", error, "");
+    REGISTER_STRING_CONFIG("misaki", "token_key_dir", error, "");
+    REGISTER_INT_CONFIG("misaki", "token_previous_keys", error, 2);
+    REGISTER_INT_CONFIG("misaki", "token_key_reload_interval", error, 60);
+    REGISTER_STRING_CONFIG("misaki", "token_algorithm", error, "HS256");
+    REGISTER_STRING_CONFIG("misaki", "token_private_key_path", error, "");
+    REGISTER_STRING_CONFIG("misaki", "token_previous_private_key_path", error, "");
+    REGISTER_BOOL_CONFIG("misaki", "token_accept_hs256", error, true);
+    REGISTER_INT_CONFIG("misaki", "token_lifetime", error, 3600);
+    REGISTER_BOOL_CONFIG("misaki", "token_memberships", error, false);
+    REGISTER_INT_CONFIG("misaki", "membership_versions_size", error, 100000);
+    REGISTER_STRING_CONFIG("misaki", "internal_token_key_path", error, "");
+    REGISTER_INT_CONFIG("misaki", "internal_token_lifetime", error, 3600);
+    REGISTER_INT_CONFIG("misaki", "internal_token_renew_before", error, 300);
     REGISTER_STRING_CONFIG("misaki", "policies", error, "", true);
+    REGISTER_INT_CONFIG("misaki", "token_cache_size", error, 10000);
+    REGISTER_INT_CONFIG("misaki", "rejected_token_cache_size", error, 10000);
+    REGISTER_INT_CONFIG("misaki", "rejected_token_cache_time", error, 60);
+    REGISTER_INT_CONFIG("misaki", "password_workers", error, 4);
+    REGISTER_INT_CONFIG("misaki", "password_queue_size", error, 64);
+    REGISTER_INT_CONFIG("misaki", "password_max_waiting_requests", error, 4);
+    REGISTER_INT_CONFIG("misaki", "password_wait_timeout", error, 2000);
+    REGISTER_INT_CONFIG("misaki", "password_hash_iterations", error, 600000);
+    REGISTER_INT_CONFIG("misaki", "login_attempts_per_minute", error, 10);
+    REGISTER_INT_CONFIG("misaki", "login_burst_size", error, 5);
+    REGISTER_INT_CONFIG("misaki", "login_limiter_size", error, 10000);
+    REGISTER_INT_CONFIG("misaki", "refresh_token_lifetime", error, 2592000);
+    REGISTER_INT_CONFIG("misaki", "session_cleanup_interval", error, 600);
+    REGISTER_INT_CONFIG("misaki", "database_read_connections", error, 4);
+    REGISTER_INT_CONFIG("misaki", "user_cache_size", error, 10000);
+    REGISTER_INT_CONFIG("misaki", "user_cache_ttl", error, 300);
 
 }
 
@@ -0,0 +1,230 @@
+/**
+ * @file        access_validation.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "access_validation.h"
+
+#include <chrono>
+
+#include <libKitsunemimiJson/json_item.h>
+
+#include <misaki_root.h>
+#include <core/token_cache.h>
+#include <core/rejected_token_cache.h>
+#include <core/policy_table.h>
+#include <core/token_verifier.h>
+#include <core/revocation_list.h>
+
+/**
+ * @brief check if a verified token was revoked
+ *
+ * @param claims claims of the verified token
+ * @param token jwt-token, which belongs to the claims
+ * @param publicError reference for error-message, which can be send back to the user
+ * @param error reference for error-output
+ *
+ * @return false, if token was revoked, else true
+ */
+bool
+checkRevocation(const TokenClaims &claims,
+                const std::string &token,
+                std::string &publicError,
+                Kitsunemimi::ErrorContainer &error)
+{
+    if(MisakiRoot::revocationList->isRevoked(claims))
+    {
+        // a revoked token never becomes valid again
+        MisakiRoot::rejectedTokenCache->add(token);
+        publicError = "Token was revoked";
+        error.addMeesage("Token with id '" + claims.tokenId + "' was revoked");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief validate a jwt-token and get its claims
+ *
+ * @param claims reference for the claims of the token
+ * @param token jwt-token to validate
+ * @param publicError reference for error-message, which can be send back to the user
+ * @param error reference for error-output
+ *
+ * @return true, if token is valid, else false
+ */
+bool
+validateToken(TokenClaims &claims,
+              const std::string &token,
+              std::string &publicError,
+              Kitsunemimi::ErrorContainer &error)
+{
+    // skip validation, if token was already validated before
+    if(MisakiRoot::tokenCache->get(claims, token)) {
+        return checkRevocation(claims, token, publicError, error);
+    }
+
+    // generation has to be read before the validation, so a key-rotation in the meantime
+    // prevents the caching of the token
+    const uint64_t cacheGeneration = MisakiRoot::tokenCache->getGeneration();
+
+    // reject recently rejected tokens directly without validating them again
+    if(MisakiRoot::rejectedTokenCache->isRejected(token))
+    {
+        publicError = "Invalid token";
+        return false;
+    }
+
+    bool unknownKey = false;
+    if(MisakiRoot::tokenVerifier->verifyToken(claims, unknownKey, token, publicError) == false)
+    {
+        // tokens, which are not valid yet or are signed with a key, which is not loaded yet,
+        // can become valid later, so they are not cached
+        const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                                std::chrono::system_clock::now().time_since_epoch()).count();
+        if(unknownKey == false
+                && claims.nbf <= now)
+        {
+            MisakiRoot::rejectedTokenCache->add(token);
+        }
+
+        error.addMeesage("Misaki failed to validate JWT-Token");
+        return false;
+    }
+
+    if(checkRevocation(claims, token, publicError, error) == false) {
+        return false;
+    }
+
+    MisakiRoot::tokenCache->add(token, claims, cacheGeneration);
+
+    return true;
+}
+
+/**
+ * @brief check if the role of a validated token allows the access to an endpoint
+ *
+ * @param claims claims of the already validated token
+ * @param component requested component
+ * @param endpoint requested endpoint within the component
+ * @param httpType http-type of the request
+ *
+ * @return true, if access is allowed by the policy, else false
+ */
+bool
+checkPolicy(const TokenClaims &claims,
+            const std::string &component,
+            const std::string &endpoint,
+            const Kitsunemimi::Hanami::HttpRequestType httpType)
+{
+    return MisakiRoot::policyTable->checkUserAgainstPolicy(component,
+                                                           endpoint,
+                                                           httpType,
+                                                           claims.role);
+}
+
+/**
+ * @brief write the claims of a token, which are visible for other components, into an output
+ *
+ * @param output reference for the output
+ * @param claims claims of the validated token
+ */
+void
+writeClaims(Kitsunemimi::JsonItem &output,
+            const TokenClaims &claims)
+{
+    output.insert("id", claims.id);
+    output.insert("name", claims.name);
+    output.insert("is_admin", claims.isAdmin);
+    output.insert("project_id", claims.projectId);
+    output.insert("role", claims.role);
+    output.insert("is_project_admin", claims.isProjectAdmin);
+}
+
+/**
+ * @brief check if all characters of a string are part of the allowed characters
+ *
+ * @param input string to check
+ * @param allowedSpecialChars allowed characters in addition to letters and numbers
+ * @param mustStartWithLetter true, if the first character must be a letter
+ *
+ * @return true, if string is valid, else false
+ */
+bool
+checkAllowedChars(const std::string &input,
+                  const std::string &allowedSpecialChars,
+                  const bool mustStartWithLetter)
+{
+    for(uint64_t i = 0; i < input.size(); i++)
+    {
+        const char c = input[i];
+        const bool isLetter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        const bool isNumber = c >= '0' && c <= '9';
+
+        if(i == 0
+                && mustStartWithLetter
+                && isLetter == false)
+        {
+            return false;
+        }
+
+        if(isLetter == false
+                && isNumber == false
+                && allowedSpecialChars.find(c) == std::string::npos)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief check a component-name with the same limits like the validate-blossom, which are
+ *        a length between 4 and 256 and the regex '[a-zA-Z][a-zA-Z_0-9]*'
+ *
+ * @param component component-name to check
+ *
+ * @return true, if valid, else false
+ */
+bool
+isValidComponent(const std::string &component)
+{
+    return component.size() >= 4
+           && component.size() <= 256
+           && checkAllowedChars(component, "_", true);
+}
+
+/**
+ * @brief check an endpoint with the same limits like the validate-blossom, which are a length
+ *        between 4 and 256 and the regex '[a-zA-Z][a-zA-Z_/0-9]*'
+ *
+ * @param endpoint endpoint to check
+ *
+ * @return true, if valid, else false
+ */
+bool
+isValidEndpoint(const std::string &endpoint)
+{
+    return endpoint.size() >= 4
+           && endpoint.size() <= 256
+           && checkAllowedChars(endpoint, "_/", true);
+}
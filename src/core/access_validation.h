@@ -0,0 +1,56 @@
+/**
+ * @file        access_validation.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_ACCESS_VALIDATION_H
+#define MISAKIGUARD_ACCESS_VALIDATION_H
+
+#include <string>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+#include <core/token_claims.h>
+
+namespace Kitsunemimi {
+class JsonItem;
+}
+
+bool validateToken(TokenClaims &claims,
+                   const std::string &token,
+                   std::string &publicError,
+                   Kitsunemimi::ErrorContainer &error);
+
+bool checkPolicy(const TokenClaims &claims,
+                 const std::string &component,
+                 const std::string &endpoint,
+                 const Kitsunemimi::Hanami::HttpRequestType httpType);
+
+void writeClaims(Kitsunemimi::JsonItem &output,
+                 const TokenClaims &claims);
+
+bool checkAllowedChars(const std::string &input,
+                       const std::string &allowedSpecialChars,
+                       const bool mustStartWithLetter);
+bool isValidComponent(const std::string &component);
+bool isValidEndpoint(const std::string &endpoint);
+
+#endif // MISAKIGUARD_ACCESS_VALIDATION_H
@@ -0,0 +1,184 @@
+/**
+ * @file        base64url.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "base64url.h"
+
+const char base64UrlChars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/**
+ * @brief convert a base64url-character into its 6-bit value
+ *
+ * @param c character to convert
+ *
+ * @return value of the character or -1, if the character is invalid
+ */
+inline int32_t
+getCharValue(const char c)
+{
+    if(c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    }
+    if(c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    }
+    if(c >= '0' && c <= '9') {
+        return c - '0' + 52;
+    }
+    if(c == '-') {
+        return 62;
+    }
+    if(c == '_') {
+        return 63;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief encode data into base64url without padding
+ *
+ * @param output reference for the result, which is appended
+ * @param data pointer to the data to encode
+ * @param dataSize number of bytes to encode
+ */
+void
+encodeBase64Url(std::string &output,
+                const void* data,
+                const uint64_t dataSize)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    output.reserve(output.size() + ((dataSize + 2) / 3) * 4);
+
+    uint64_t i = 0;
+    for(; i + 2 < dataSize; i += 3)
+    {
+        const uint32_t block = (bytes[i] << 16) | (bytes[i + 1] << 8) | bytes[i + 2];
+        output.push_back(base64UrlChars[(block >> 18) & 0x3F]);
+        output.push_back(base64UrlChars[(block >> 12) & 0x3F]);
+        output.push_back(base64UrlChars[(block >> 6) & 0x3F]);
+        output.push_back(base64UrlChars[block & 0x3F]);
+    }
+
+    // handle remaining bytes without padding
+    const uint64_t remaining = dataSize - i;
+    if(remaining == 1)
+    {
+        const uint32_t block = bytes[i] << 16;
+        output.push_back(base64UrlChars[(block >> 18) & 0x3F]);
+        output.push_back(base64UrlChars[(block >> 12) & 0x3F]);
+    }
+    else if(remaining == 2)
+    {
+        const uint32_t block = (bytes[i] << 16) | (bytes[i + 1] << 8);
+        output.push_back(base64UrlChars[(block >> 18) & 0x3F]);
+        output.push_back(base64UrlChars[(block >> 12) & 0x3F]);
+        output.push_back(base64UrlChars[(block >> 6) & 0x3F]);
+    }
+}
+
+/**
+ * @brief decode base64url-encoded data into a buffer with fixed size
+ *
+ * @param output pointer to the buffer for the decoded data
+ * @param outputSize reference for the number of decoded bytes
+ * @param maxOutputSize size of the output-buffer
+ * @param input pointer to the base64url-string
+ * @param inputSize length of the base64url-string
+ *
+ * @return false, if input is invalid or doesn't fit into the buffer, else true
+ */
+bool
+decodeBase64Url(uint8_t* output,
+                uint64_t &outputSize,
+                const uint64_t maxOutputSize,
+                const char* input,
+                uint64_t inputSize)
+{
+    // ignore optional padding
+    while(inputSize > 0
+          && input[inputSize - 1] == '=')
+    {
+        inputSize--;
+    }
+
+    if(inputSize % 4 == 1) {
+        return false;
+    }
+
+    outputSize = 0;
+    uint32_t block = 0;
+    uint32_t numberOfBits = 0;
+    for(uint64_t i = 0; i < inputSize; i++)
+    {
+        const int32_t value = getCharValue(input[i]);
+        if(value < 0) {
+            return false;
+        }
+
+        block = (block << 6) | static_cast<uint32_t>(value);
+        numberOfBits += 6;
+        if(numberOfBits >= 8)
+        {
+            numberOfBits -= 8;
+            if(outputSize >= maxOutputSize) {
+                return false;
+            }
+            output[outputSize] = static_cast<uint8_t>((block >> numberOfBits) & 0xFF);
+            outputSize++;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief decode base64url-encoded data into a string, which is used as buffer
+ *
+ * @param output reference for the result, which is resized but keeps its capacity
+ * @param input pointer to the base64url-string
+ * @param inputSize length of the base64url-string
+ *
+ * @return false, if input is invalid, else true
+ */
+bool
+decodeBase64Url(std::string &output,
+                const char* input,
+                const uint64_t inputSize)
+{
+    const uint64_t maxOutputSize = (inputSize * 3) / 4 + 3;
+    output.resize(maxOutputSize);
+
+    uint64_t outputSize = 0;
+    if(decodeBase64Url(reinterpret_cast<uint8_t*>(&output[0]),
+                       outputSize,
+                       maxOutputSize,
+                       input,
+                       inputSize) == false)
+    {
+        output.clear();
+        return false;
+    }
+
+    output.resize(outputSize);
+
+    return true;
+}
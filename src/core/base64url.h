@@ -0,0 +1,41 @@
+/**
+ * @file        base64url.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_BASE64URL_H
+#define MISAKIGUARD_BASE64URL_H
+
+#include <string>
+#include <stdint.h>
+
+void encodeBase64Url(std::string &output,
+                     const void* data,
+                     const uint64_t dataSize);
+bool decodeBase64Url(std::string &output,
+                     const char* input,
+                     const uint64_t inputSize);
+bool decodeBase64Url(uint8_t* output,
+                     uint64_t &outputSize,
+                     const uint64_t maxOutputSize,
+                     const char* input,
+                     const uint64_t inputSize);
+
+#endif // MISAKIGUARD_BASE64URL_H
@@ -0,0 +1,257 @@
+/**
+ * @file        credential_worker_pool.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "credential_worker_pool.h"
+
+#include <algorithm>
+
+/**
+ * @brief constructor
+ *
+ * @param numberOfWorkers number of threads, which process the tasks
+ * @param maxQueueSize maximum number of tasks, which can wait for a free worker
+ * @param maxWaitingCallers maximum number of threads, which can be blocked at the same time by
+ *                          waiting for the result of their task
+ * @param timeout maximum time in milliseconds, which a caller waits for a free worker
+ */
+CredentialWorkerPool::CredentialWorkerPool(const uint32_t numberOfWorkers,
+                                           const uint32_t maxQueueSize,
+                                           const uint32_t maxWaitingCallers,
+                                           const uint32_t timeout)
+    : m_timeout(timeout)
+{
+    m_maxQueueSize = maxQueueSize;
+    m_maxWaitingCallers = maxWaitingCallers;
+    m_processedTasks = 0;
+    m_rejectedTasks = 0;
+    m_timedOutTasks = 0;
+    m_waitingCallers = 0;
+
+    for(uint32_t i = 0; i < numberOfWorkers; i++) {
+        m_workers.push_back(new std::thread(&CredentialWorkerPool::workerLoop, this));
+    }
+}
+
+/**
+ * @brief destructor
+ */
+CredentialWorkerPool::~CredentialWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_abort = true;
+    }
+    m_queueCondition.notify_all();
+
+    for(std::thread* worker : m_workers)
+    {
+        worker->join();
+        delete worker;
+    }
+
+    // release callers, whose tasks were not processed anymore
+    for(Task* task : m_queue)
+    {
+        if(task->result != nullptr) {
+            task->result->set_value(false);
+        } else {
+            delete task;
+        }
+    }
+}
+
+/**
+ * @brief run a task on one of the workers and wait for its result. The expensive hashing of the
+ *        credentials is so limited to the workers of the pool and can not occupy all threads,
+ *        which also have to handle the token-validations. The number of blocked callers is
+ *        limited and a task, which doesn't get a free worker within the timeout, is removed
+ *        again from the queue. A task, which is already running, is always finished, because
+ *        it uses the values of the caller.
+ *
+ * @param result reference for the result of the task
+ * @param task task to run
+ *
+ * @return false, if the task was rejected or not started within the timeout, else true
+ */
+bool
+CredentialWorkerPool::runTask(bool &result,
+                              const std::function<bool()> &task)
+{
+    // keep enough threads free for the token-validations
+    if(m_waitingCallers.fetch_add(1) >= m_maxWaitingCallers)
+    {
+        m_waitingCallers--;
+        m_rejectedTasks++;
+        return false;
+    }
+
+    std::promise<bool> promise;
+    std::future<bool> future = promise.get_future();
+
+    Task newTask;
+    newTask.function = task;
+    newTask.result = &promise;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        // fail fast instead of letting the requests pile up
+        if(m_queue.size() >= m_maxQueueSize)
+        {
+            m_waitingCallers--;
+            m_rejectedTasks++;
+            return false;
+        }
+
+        m_queue.push_back(&newTask);
+    }
+    m_queueCondition.notify_one();
+
+    if(future.wait_for(m_timeout) == std::future_status::timeout)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        const auto it = std::find(m_queue.begin(), m_queue.end(), &newTask);
+        if(it != m_queue.end())
+        {
+            m_queue.erase(it);
+            m_waitingCallers--;
+            m_timedOutTasks++;
+            return false;
+        }
+    }
+
+    result = future.get();
+    m_waitingCallers--;
+
+    return true;
+}
+
+/**
+ * @brief add a task to the queue without waiting for its result
+ *
+ * @param task task to run
+ *
+ * @return false, if the queue is full and the task was rejected, else true
+ */
+bool
+CredentialWorkerPool::addBackgroundTask(const std::function<bool()> &task)
+{
+    Task* newTask = new Task();
+    newTask->function = task;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        if(m_queue.size() >= m_maxQueueSize)
+        {
+            m_rejectedTasks++;
+            delete newTask;
+            return false;
+        }
+
+        m_queue.push_back(newTask);
+    }
+    m_queueCondition.notify_one();
+
+    return true;
+}
+
+/**
+ * @brief loop of the worker-threads
+ */
+void
+CredentialWorkerPool::workerLoop()
+{
+    while(true)
+    {
+        Task* task = nullptr;
+
+        {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_queueCondition.wait(guard, [this] { return m_abort || m_queue.size() > 0; });
+            if(m_abort) {
+                return;
+            }
+
+            task = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        const bool result = task->function();
+        m_processedTasks++;
+
+        if(task->result != nullptr) {
+            task->result->set_value(result);
+        } else {
+            delete task;
+        }
+    }
+}
+
+/**
+ * @brief get number of tasks, which wait for a free worker
+ */
+uint64_t
+CredentialWorkerPool::getNumberOfQueuedTasks()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_queue.size();
+}
+
+/**
+ * @brief get number of processed tasks
+ */
+uint64_t
+CredentialWorkerPool::getNumberOfProcessedTasks() const
+{
+    return m_processedTasks;
+}
+
+/**
+ * @brief get number of tasks, which were rejected, because the queue or the number of waiting
+ *        callers was full
+ */
+uint64_t
+CredentialWorkerPool::getNumberOfRejectedTasks() const
+{
+    return m_rejectedTasks;
+}
+
+/**
+ * @brief get number of tasks, which were removed, because they didn't get a free worker
+ *        within the timeout
+ */
+uint64_t
+CredentialWorkerPool::getNumberOfTimedOutTasks() const
+{
+    return m_timedOutTasks;
+}
+
+/**
+ * @brief get number of callers, which currently wait for the result of their task
+ */
+uint64_t
+CredentialWorkerPool::getNumberOfWaitingCallers() const
+{
+    return m_waitingCallers;
+}
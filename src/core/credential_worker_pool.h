@@ -0,0 +1,81 @@
+/**
+ * @file        credential_worker_pool.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_CREDENTIAL_WORKER_POOL_H
+#define MISAKIGUARD_CREDENTIAL_WORKER_POOL_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <future>
+#include <functional>
+#include <condition_variable>
+
+class CredentialWorkerPool
+{
+public:
+    CredentialWorkerPool(const uint32_t numberOfWorkers,
+                         const uint32_t maxQueueSize,
+                         const uint32_t maxWaitingCallers,
+                         const uint32_t timeout);
+    ~CredentialWorkerPool();
+
+    bool runTask(bool &result, const std::function<bool()> &task);
+    bool addBackgroundTask(const std::function<bool()> &task);
+
+    uint64_t getNumberOfQueuedTasks();
+    uint64_t getNumberOfProcessedTasks() const;
+    uint64_t getNumberOfRejectedTasks() const;
+    uint64_t getNumberOfTimedOutTasks() const;
+    uint64_t getNumberOfWaitingCallers() const;
+
+private:
+    struct Task
+    {
+        std::function<bool()> function;
+        // nullptr for background-tasks, which are deleted by the worker
+        std::promise<bool>* result = nullptr;
+    };
+
+    uint32_t m_maxQueueSize = 0;
+    uint32_t m_maxWaitingCallers = 0;
+    // maximum time in milliseconds, which a caller waits for a free worker
+    std::chrono::milliseconds m_timeout;
+
+    std::mutex m_lock;
+    std::condition_variable m_queueCondition;
+    std::deque<Task*> m_queue;
+    std::vector<std::thread*> m_workers;
+    bool m_abort = false;
+
+    std::atomic<uint64_t> m_processedTasks;
+    std::atomic<uint64_t> m_rejectedTasks;
+    std::atomic<uint64_t> m_timedOutTasks;
+    std::atomic<uint64_t> m_waitingCallers;
+
+    void workerLoop();
+};
+
+#endif // MISAKIGUARD_CREDENTIAL_WORKER_POOL_H
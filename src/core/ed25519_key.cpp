@@ -0,0 +1,117 @@
+/**
+ * @file        ed25519_key.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "ed25519_key.h"
+
+#include <cryptopp/sha.h>
+
+#include <libKitsunemimiJson/json_item.h>
+
+#include <core/base64url.h>
+
+/**
+ * @brief constructor
+ *
+ * @param privateKey pointer to the 32 byte private key
+ */
+Ed25519Key::Ed25519Key(const uint8_t* privateKey)
+    : m_signer(privateKey),
+      m_verifier(m_signer)
+{
+    const uint8_t* publicKey = m_verifier.GetPublicKey().GetPublicKeyBytePtr();
+    encodeBase64Url(m_encodedPublicKey, publicKey, PUBLIC_KEY_SIZE);
+
+    // key-id is derived from the public key, so it is stable over restarts
+    uint8_t hash[CryptoPP::SHA256::DIGESTSIZE];
+    CryptoPP::SHA256().CalculateDigest(hash, publicKey, PUBLIC_KEY_SIZE);
+    encodeBase64Url(m_keyId, hash, 12);
+}
+
+/**
+ * @brief destructor
+ */
+Ed25519Key::~Ed25519Key() {}
+
+/**
+ * @brief create an Ed25519-signature
+ *
+ * @param signature pointer to the buffer for the 64 byte signature
+ * @param data pointer to the data to sign
+ * @param dataSize number of bytes to sign
+ */
+void
+Ed25519Key::sign(uint8_t* signature,
+                 const void* data,
+                 const uint64_t dataSize) const
+{
+    // Ed25519 is deterministic, so no random-number-generator is necessary
+    m_signer.SignMessage(CryptoPP::NullRNG(),
+                         static_cast<const CryptoPP::byte*>(data),
+                         dataSize,
+                         signature);
+}
+
+/**
+ * @brief verify an Ed25519-signature
+ *
+ * @param signature pointer to the 64 byte signature
+ * @param data pointer to the signed data
+ * @param dataSize number of signed bytes
+ *
+ * @return true, if signature is valid, else false
+ */
+bool
+Ed25519Key::verify(const uint8_t* signature,
+                   const void* data,
+                   const uint64_t dataSize) const
+{
+    return m_verifier.VerifyMessage(static_cast<const CryptoPP::byte*>(data),
+                                    dataSize,
+                                    signature,
+                                    SIGNATURE_SIZE);
+}
+
+/**
+ * @brief get id of the key, which is written as kid into the token-header
+ */
+const std::string&
+Ed25519Key::getKeyId() const
+{
+    return m_keyId;
+}
+
+/**
+ * @brief get public key as json-web-key (RFC 8037), so other components can verify the tokens
+ */
+Kitsunemimi::JsonItem
+Ed25519Key::getPublicJwk() const
+{
+    Kitsunemimi::JsonItem jwk;
+    jwk.insert("kty", "OKP");
+    jwk.insert("crv", "Ed25519");
+    jwk.insert("alg", "EdDSA");
+    jwk.insert("use", "sig");
+    jwk.insert("kid", m_keyId);
+    jwk.insert("x", m_encodedPublicKey);
+
+    return jwk;
+}
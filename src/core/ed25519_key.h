@@ -0,0 +1,61 @@
+/**
+ * @file        ed25519_key.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_ED25519_KEY_H
+#define MISAKIGUARD_ED25519_KEY_H
+
+#include <string>
+
+#include <cryptopp/xed25519.h>
+
+namespace Kitsunemimi {
+class JsonItem;
+}
+
+class Ed25519Key
+{
+public:
+    static const uint32_t PRIVATE_KEY_SIZE = 32;
+    static const uint32_t PUBLIC_KEY_SIZE = 32;
+    static const uint32_t SIGNATURE_SIZE = 64;
+
+    Ed25519Key(const uint8_t* privateKey);
+    ~Ed25519Key();
+
+    void sign(uint8_t* signature,
+              const void* data,
+              const uint64_t dataSize) const;
+    bool verify(const uint8_t* signature,
+                const void* data,
+                const uint64_t dataSize) const;
+
+    const std::string& getKeyId() const;
+    Kitsunemimi::JsonItem getPublicJwk() const;
+
+private:
+    CryptoPP::ed25519::Signer m_signer;
+    CryptoPP::ed25519::Verifier m_verifier;
+    std::string m_keyId = "";
+    std::string m_encodedPublicKey = "";
+};
+
+#endif // MISAKIGUARD_ED25519_KEY_H
@@ -0,0 +1,151 @@
+/**
+ * @file        hmac_key.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "hmac_key.h"
+
+#include <cstring>
+
+#include <cryptopp/misc.h>
+
+std::atomic<uint64_t> HmacKey::m_keyIdCounter(1);
+
+/**
+ * @brief constructor
+ *
+ * @param key secret key for the HMAC-SHA256
+ */
+HmacKey::HmacKey(const CryptoPP::SecByteBlock &key)
+    : m_key(key)
+{
+    // unique id to find the pre-keyed states of this key within the threads
+    m_keyId = m_keyIdCounter.fetch_add(1);
+}
+
+/**
+ * @brief destructor
+ */
+HmacKey::~HmacKey() {}
+
+/**
+ * @brief get the pre-keyed inner and outer hash-states of the current thread. They are created
+ *        only once per thread and key, so the key-schedule of the HMAC is not repeated for
+ *        each operation and no lock is necessary to access them.
+ *
+ * @return reference to the hash-states of the key
+ */
+const HmacKey::PreKeyedState&
+HmacKey::getThreadState() const
+{
+    thread_local std::vector<PreKeyedState> states;
+
+    for(const PreKeyedState &state : states)
+    {
+        if(state.keyId == m_keyId) {
+            return state;
+        }
+    }
+
+    // remove oldest state, if there are too many keys used within this thread
+    if(states.size() >= MAX_STATES_PER_THREAD) {
+        states.erase(states.begin());
+    }
+
+    // keys longer than the block-size are hashed first
+    uint8_t keyBlock[CryptoPP::SHA256::BLOCKSIZE];
+    memset(keyBlock, 0, CryptoPP::SHA256::BLOCKSIZE);
+    if(m_key.size() > CryptoPP::SHA256::BLOCKSIZE)
+    {
+        CryptoPP::SHA256 keyHash;
+        keyHash.Update(m_key.data(), m_key.size());
+        keyHash.Final(keyBlock);
+    }
+    else
+    {
+        memcpy(keyBlock, m_key.data(), m_key.size());
+    }
+
+    // absorb the padded keys into the inner and outer hash
+    uint8_t innerPad[CryptoPP::SHA256::BLOCKSIZE];
+    uint8_t outerPad[CryptoPP::SHA256::BLOCKSIZE];
+    for(uint32_t i = 0; i < CryptoPP::SHA256::BLOCKSIZE; i++)
+    {
+        innerPad[i] = keyBlock[i] ^ 0x36;
+        outerPad[i] = keyBlock[i] ^ 0x5c;
+    }
+
+    PreKeyedState newState;
+    newState.keyId = m_keyId;
+    newState.innerHash.Update(innerPad, CryptoPP::SHA256::BLOCKSIZE);
+    newState.outerHash.Update(outerPad, CryptoPP::SHA256::BLOCKSIZE);
+    states.push_back(newState);
+
+    memset(keyBlock, 0, CryptoPP::SHA256::BLOCKSIZE);
+    memset(innerPad, 0, CryptoPP::SHA256::BLOCKSIZE);
+    memset(outerPad, 0, CryptoPP::SHA256::BLOCKSIZE);
+
+    return states.back();
+}
+
+/**
+ * @brief calculate the HMAC-SHA256 of some data with clones of the pre-keyed hash-states
+ *
+ * @param mac pointer to a buffer of 32 bytes for the resulting mac
+ * @param data pointer to the data to sign
+ * @param dataSize number of bytes to sign
+ */
+void
+HmacKey::calculateMac(uint8_t* mac,
+                      const void* data,
+                      const uint64_t dataSize) const
+{
+    const PreKeyedState &state = getThreadState();
+    uint8_t innerDigest[CryptoPP::SHA256::DIGESTSIZE];
+
+    CryptoPP::SHA256 innerHash(state.innerHash);
+    innerHash.Update(static_cast<const uint8_t*>(data), dataSize);
+    innerHash.Final(innerDigest);
+
+    CryptoPP::SHA256 outerHash(state.outerHash);
+    outerHash.Update(innerDigest, CryptoPP::SHA256::DIGESTSIZE);
+    outerHash.Final(mac);
+}
+
+/**
+ * @brief check the HMAC-SHA256 of some data
+ *
+ * @param mac pointer to the 32 bytes of the mac, which has to be checked
+ * @param data pointer to the signed data
+ * @param dataSize number of signed bytes
+ *
+ * @return true, if the mac matches, else false
+ */
+bool
+HmacKey::verifyMac(const uint8_t* mac,
+                   const void* data,
+                   const uint64_t dataSize) const
+{
+    uint8_t calculatedMac[CryptoPP::SHA256::DIGESTSIZE];
+    calculateMac(calculatedMac, data, dataSize);
+
+    // compare in constant time
+    return CryptoPP::VerifyBufsEqual(mac, calculatedMac, CryptoPP::SHA256::DIGESTSIZE);
+}
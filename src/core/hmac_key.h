@@ -0,0 +1,64 @@
+/**
+ * @file        hmac_key.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_HMAC_KEY_H
+#define MISAKIGUARD_HMAC_KEY_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include <cryptopp/secblock.h>
+#include <cryptopp/sha.h>
+
+class HmacKey
+{
+public:
+    HmacKey(const CryptoPP::SecByteBlock &key);
+    ~HmacKey();
+
+    void calculateMac(uint8_t* mac,
+                      const void* data,
+                      const uint64_t dataSize) const;
+    bool verifyMac(const uint8_t* mac,
+                   const void* data,
+                   const uint64_t dataSize) const;
+
+private:
+    struct PreKeyedState
+    {
+        uint64_t keyId = 0;
+        CryptoPP::SHA256 innerHash;
+        CryptoPP::SHA256 outerHash;
+    };
+
+    static std::atomic<uint64_t> m_keyIdCounter;
+    // number of keys per thread, for which the pre-keyed states are hold at the same time
+    static const uint32_t MAX_STATES_PER_THREAD = 8;
+
+    uint64_t m_keyId = 0;
+    CryptoPP::SecByteBlock m_key;
+
+    const PreKeyedState& getThreadState() const;
+};
+
+#endif // MISAKIGUARD_HMAC_KEY_H
@@ -0,0 +1,276 @@
+/**
+ * @file        internal_token_cache.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "internal_token_cache.h"
+
+#include <chrono>
+#include <vector>
+
+#include <libKitsunemimiJson/json_item.h>
+
+#include <core/token_signer.h>
+
+/**
+ * @brief constructor
+ *
+ * @param signer signer with the internal key
+ * @param tokenLifetime time in seconds, for which a new internal token is valid
+ * @param renewBefore time in seconds before the expiration, at which a token is replaced
+ */
+InternalTokenCache::InternalTokenCache(const TokenSigner* signer,
+                                       const uint32_t tokenLifetime,
+                                       const uint32_t renewBefore)
+{
+    m_signer = signer;
+    m_tokenLifetime = tokenLifetime;
+    m_renewBefore = renewBefore;
+
+    m_abort = false;
+    m_hits = 0;
+    m_createdTokens = 0;
+    m_evictions = 0;
+}
+
+/**
+ * @brief destructor
+ */
+InternalTokenCache::~InternalTokenCache()
+{
+    if(m_renewThread != nullptr)
+    {
+        m_abort = true;
+        m_renewThread->join();
+        delete m_renewThread;
+    }
+}
+
+/**
+ * @brief get current time in seconds
+ */
+int64_t
+InternalTokenCache::getCurrentTime() const
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief create a new signed internal token for a service
+ *
+ * @param cachedToken reference for the new token
+ * @param serviceName name of the service
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+InternalTokenCache::createToken(CachedToken &cachedToken,
+                                const std::string &serviceName,
+                                Kitsunemimi::ErrorContainer &error)
+{
+    Kitsunemimi::JsonItem serviceData;
+    serviceData.insert("name", new Kitsunemimi::DataValue(serviceName));
+
+    const int64_t now = getCurrentTime();
+    if(m_signer->createToken(cachedToken.token, serviceData, m_tokenLifetime, error) == false)
+    {
+        error.addMeesage("Failed to create internal token for service '" + serviceName + "'");
+        return false;
+    }
+    cachedToken.expiresAt = now + m_tokenLifetime;
+    m_createdTokens++;
+
+    return true;
+}
+
+/**
+ * @brief get an internal token for a service. Tokens are created only, if there is no valid
+ *        token for the service in the cache, so usually no signing is necessary.
+ *
+ * @param token reference for the token
+ * @param serviceName name of the service
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+InternalTokenCache::getToken(std::string &token,
+                             const std::string &serviceName,
+                             Kitsunemimi::ErrorContainer &error)
+{
+    const int64_t now = getCurrentTime();
+
+    // tokens within the renew-period are still returned, because they are replaced by the
+    // renew-thread in the background
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        const auto it = m_tokens.find(serviceName);
+        if(it != m_tokens.end()
+                && it->second.expiresAt > now)
+        {
+            m_usageList.splice(m_usageList.begin(), m_usageList, it->second.position);
+            token = it->second.token;
+            m_hits++;
+            return true;
+        }
+    }
+
+    CachedToken newToken;
+    if(createToken(newToken, serviceName, error) == false) {
+        return false;
+    }
+    token = newToken.token;
+
+    addToken(serviceName, newToken, false);
+
+    return true;
+}
+
+/**
+ * @brief add a token to the cache or replace the existing token of the service. If the cache
+ *        is full, the least recently used token is removed.
+ *
+ * @param serviceName name of the service
+ * @param newToken new token for the service
+ * @param onlyReplace true to add the token only, if the service is still in the cache
+ */
+void
+InternalTokenCache::addToken(const std::string &serviceName,
+                             const CachedToken &newToken,
+                             const bool onlyReplace)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    const auto it = m_tokens.find(serviceName);
+    if(it != m_tokens.end())
+    {
+        it->second.token = newToken.token;
+        it->second.expiresAt = newToken.expiresAt;
+        return;
+    }
+
+    // the token was evicted while it was renewed
+    if(onlyReplace) {
+        return;
+    }
+
+    if(m_tokens.size() >= MAX_ENTRIES)
+    {
+        m_tokens.erase(m_usageList.back());
+        m_usageList.pop_back();
+        m_evictions++;
+    }
+
+    m_usageList.push_front(serviceName);
+    CachedToken entry = newToken;
+    entry.position = m_usageList.begin();
+    m_tokens.emplace(serviceName, entry);
+}
+
+/**
+ * @brief start thread, which replaces tokens shortly before their expiration
+ */
+void
+InternalTokenCache::startRenewThread()
+{
+    if(m_renewThread != nullptr) {
+        return;
+    }
+
+    m_renewThread = new std::thread(&InternalTokenCache::renewLoop, this);
+}
+
+/**
+ * @brief loop of the renew-thread
+ */
+void
+InternalTokenCache::renewLoop()
+{
+    while(m_abort == false)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // collect services with tokens, which expire soon
+        const int64_t renewTime = getCurrentTime() + m_renewBefore;
+        std::vector<std::string> serviceNames;
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            for(auto it = m_tokens.begin(); it != m_tokens.end(); it++)
+            {
+                if(it->second.expiresAt <= renewTime) {
+                    serviceNames.push_back(it->first);
+                }
+            }
+        }
+
+        // sign outside of the lock, so requests are not blocked by the signing
+        for(const std::string &serviceName : serviceNames)
+        {
+            CachedToken newToken;
+            Kitsunemimi::ErrorContainer error;
+            if(createToken(newToken, serviceName, error) == false)
+            {
+                LOG_ERROR(error);
+                continue;
+            }
+
+            addToken(serviceName, newToken, true);
+        }
+    }
+}
+
+/**
+ * @brief get number of requests, which were answered with a cached token
+ */
+uint64_t
+InternalTokenCache::getNumberOfHits() const
+{
+    return m_hits;
+}
+
+/**
+ * @brief get number of signed internal tokens since the start
+ */
+uint64_t
+InternalTokenCache::getNumberOfCreatedTokens() const
+{
+    return m_createdTokens;
+}
+
+/**
+ * @brief get number of services with a cached token
+ */
+uint64_t
+InternalTokenCache::getNumberOfEntries()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_tokens.size();
+}
+
+/**
+ * @brief get number of tokens, which were removed, because the cache was full
+ */
+uint64_t
+InternalTokenCache::getNumberOfEvictions() const
+{
+    return m_evictions;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file        internal_token_cache.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_INTERNAL_TOKEN_CACHE_H
+#define MISAKIGUARD_INTERNAL_TOKEN_CACHE_H
+
+#include <string>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+#include <libKitsunemimiCommon/logger.h>
+
+class TokenSigner;
+
+class InternalTokenCache
+{
+public:
+    InternalTokenCache(const TokenSigner* signer,
+                       const uint32_t tokenLifetime,
+                       const uint32_t renewBefore);
+    ~InternalTokenCache();
+
+    bool getToken(std::string &token,
+                  const std::string &serviceName,
+                  Kitsunemimi::ErrorContainer &error);
+
+    void startRenewThread();
+
+    uint64_t getNumberOfHits() const;
+    uint64_t getNumberOfCreatedTokens() const;
+    uint64_t getNumberOfEntries();
+    uint64_t getNumberOfEvictions() const;
+
+private:
+    struct CachedToken
+    {
+        std::string token = "";
+        int64_t expiresAt = 0;
+        // position of the service within the usage-list
+        std::list<std::string>::iterator position;
+    };
+
+    // the number of internal services is small, so this limit is only a protection against
+    // requests with random service-names, where the least recently used token is removed
+    static const uint32_t MAX_ENTRIES = 1024;
+
+    const TokenSigner* m_signer = nullptr;
+    uint32_t m_tokenLifetime = 0;
+    uint32_t m_renewBefore = 0;
+
+    std::mutex m_lock;
+    // service-names sorted by their last usage, with the most recently used at the front
+    std::list<std::string> m_usageList;
+    std::unordered_map<std::string, CachedToken> m_tokens;
+
+    std::thread* m_renewThread = nullptr;
+    std::atomic<bool> m_abort;
+    std::atomic<uint64_t> m_hits;
+    std::atomic<uint64_t> m_createdTokens;
+    std::atomic<uint64_t> m_evictions;
+
+    bool createToken(CachedToken &cachedToken,
+                     const std::string &serviceName,
+                     Kitsunemimi::ErrorContainer &error);
+    void addToken(const std::string &serviceName,
+                  const CachedToken &newToken,
+                  const bool onlyReplace);
+    int64_t getCurrentTime() const;
+    void renewLoop();
+};
+
+#endif // MISAKIGUARD_INTERNAL_TOKEN_CACHE_H
@@ -0,0 +1,104 @@
+/**
+ * @file        json_writer.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "json_writer.h"
+
+#include <stdint.h>
+
+/**
+ * @brief append a string as escaped json-string to a buffer
+ *
+ * @param output buffer, where the string should be appended
+ * @param value string to append
+ */
+void
+appendJsonString(std::string &output,
+                 const std::string &value)
+{
+    const char hexChars[] = "0123456789abcdef";
+
+    output.push_back('"');
+    for(const char c : value)
+    {
+        if(c == '"'
+                || c == '\\')
+        {
+            output.push_back('\\');
+            output.push_back(c);
+        }
+        else if(static_cast<uint8_t>(c) < 0x20)
+        {
+            output.append("\\u00");
+            output.push_back(hexChars[(c >> 4) & 0xf]);
+            output.push_back(hexChars[c & 0xf]);
+        }
+        else
+        {
+            output.push_back(c);
+        }
+    }
+    output.push_back('"');
+}
+
+/**
+ * @brief write the claims of a token with a fixed layout as json-object into a buffer, which
+ *        can be reused for all tokens of a thread
+ *
+ * @param payload buffer for the json-object, which is cleared before
+ * @param claims claims of the token
+ */
+void
+writeTokenPayload(std::string &payload,
+                  const TokenClaims &claims)
+{
+    payload.clear();
+
+    payload.append("{\"id\":");
+    appendJsonString(payload, claims.id);
+    payload.append(",\"name\":");
+    appendJsonString(payload, claims.name);
+    payload.append(claims.isAdmin ? ",\"is_admin\":true" : ",\"is_admin\":false");
+    payload.append(",\"project_id\":");
+    appendJsonString(payload, claims.projectId);
+    payload.append(",\"role\":");
+    appendJsonString(payload, claims.role);
+    payload.append(claims.isProjectAdmin ? ",\"is_project_admin\":true"
+                                         : ",\"is_project_admin\":false");
+    if(claims.memberships.size() != 0)
+    {
+        payload.append(",\"pm\":");
+        appendJsonString(payload, claims.memberships);
+        payload.append(",\"mv\":");
+        payload.append(std::to_string(claims.membershipVersion));
+    }
+    payload.append(",\"jti\":");
+    appendJsonString(payload, claims.tokenId);
+    payload.append(",\"iat\":");
+    payload.append(std::to_string(claims.iat));
+    payload.append(",\"iat_us\":");
+    payload.append(std::to_string(claims.iatMicros));
+    payload.append(",\"nbf\":");
+    payload.append(std::to_string(claims.nbf));
+    payload.append(",\"exp\":");
+    payload.append(std::to_string(claims.exp));
+    payload.push_back('}');
+}
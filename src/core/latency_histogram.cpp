@@ -0,0 +1,111 @@
+/**
+ * @file        latency_histogram.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "latency_histogram.h"
+
+/**
+ * @brief constructor
+ */
+LatencyHistogram::LatencyHistogram()
+{
+    for(uint32_t i = 0; i < NUMBER_OF_BUCKETS; i++) {
+        m_buckets[i] = 0;
+    }
+    m_numberOfValues = 0;
+}
+
+/**
+ * @brief destructor
+ */
+LatencyHistogram::~LatencyHistogram() {}
+
+/**
+ * @brief add a new measured latency
+ *
+ * @param microSeconds latency in micro-seconds
+ */
+void
+LatencyHistogram::addValue(const uint64_t microSeconds)
+{
+    uint32_t bucket = 0;
+    uint64_t value = microSeconds;
+    while(value > 1
+          && bucket < NUMBER_OF_BUCKETS - 1)
+    {
+        value >>= 1;
+        bucket++;
+    }
+
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_numberOfValues.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief add the latency from a start-point until now
+ *
+ * @param start start-point of the measurement
+ */
+void
+LatencyHistogram::addValue(const std::chrono::steady_clock::time_point &start)
+{
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    addValue(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+}
+
+/**
+ * @brief get number of measured latencies
+ */
+uint64_t
+LatencyHistogram::getNumberOfValues() const
+{
+    return m_numberOfValues;
+}
+
+/**
+ * @brief get a percentile of the measured latencies
+ *
+ * @param percentile requested percentile between 0.0 and 1.0
+ *
+ * @return upper border of the bucket, which contains the percentile, in micro-seconds
+ */
+uint64_t
+LatencyHistogram::getPercentile(const double percentile) const
+{
+    const uint64_t numberOfValues = m_numberOfValues;
+    if(numberOfValues == 0) {
+        return 0;
+    }
+
+    const uint64_t threshold = static_cast<uint64_t>(percentile * numberOfValues);
+    uint64_t counter = 0;
+    for(uint32_t i = 0; i < NUMBER_OF_BUCKETS; i++)
+    {
+        counter += m_buckets[i].load(std::memory_order_relaxed);
+        if(counter > threshold
+                || counter >= numberOfValues)
+        {
+            return 1ULL << (i + 1);
+        }
+    }
+
+    return 1ULL << NUMBER_OF_BUCKETS;
+}
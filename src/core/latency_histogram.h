@@ -0,0 +1,72 @@
+/**
+ * @file        latency_histogram.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_LATENCY_HISTOGRAM_H
+#define MISAKIGUARD_LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+    ~LatencyHistogram();
+
+    void addValue(const uint64_t microSeconds);
+    void addValue(const std::chrono::steady_clock::time_point &start);
+
+    uint64_t getNumberOfValues() const;
+    uint64_t getPercentile(const double percentile) const;
+
+private:
+    // bucket i contains all values between 2^i and 2^(i+1) micro-seconds
+    static const uint32_t NUMBER_OF_BUCKETS = 32;
+
+    std::atomic<uint64_t> m_buckets[NUMBER_OF_BUCKETS];
+    std::atomic<uint64_t> m_numberOfValues;
+};
+
+/**
+ * @brief measure the time from the creation until the destruction of this object, so all
+ *        return-paths of a function are covered
+ */
+class LatencyMeasurement
+{
+public:
+    LatencyMeasurement(LatencyHistogram* histogram)
+    {
+        m_histogram = histogram;
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    ~LatencyMeasurement()
+    {
+        m_histogram->addValue(m_start);
+    }
+
+private:
+    LatencyHistogram* m_histogram = nullptr;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#endif // MISAKIGUARD_LATENCY_HISTOGRAM_H
@@ -0,0 +1,258 @@
+/**
+ * @file        memberships.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "memberships.h"
+
+#include <chrono>
+#include <mutex>
+
+#include <database/user_cache.h>
+
+/**
+ * @brief constructor
+ *
+ * @param maxTokenLifetime maximum number of seconds, which a token is valid
+ * @param maxEntries maximum number of users with changed memberships, which are tracked
+ */
+MembershipVersions::MembershipVersions(const uint32_t maxTokenLifetime,
+                                       const uint64_t maxEntries)
+{
+    // versions are only hold in memory, so all tokens from before the start have an older
+    // version and are handled like tokens with changed memberships
+    m_baseVersion = getCurrentTime();
+    m_maxTokenLifetime = static_cast<int64_t>(maxTokenLifetime) * 1000000;
+    m_maxEntries = maxEntries;
+    m_nextCleanup = m_baseVersion + m_cleanupInterval;
+
+    m_resets = 0;
+}
+
+/**
+ * @brief destructor
+ */
+MembershipVersions::~MembershipVersions() {}
+
+/**
+ * @brief get current time in micro-seconds
+ */
+int64_t
+MembershipVersions::getCurrentTime() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief get current membership-version of a user
+ *
+ * @param userId id of the user
+ *
+ * @return version of the project-memberships of the user
+ */
+int64_t
+MembershipVersions::getVersion(const std::string &userId)
+{
+    std::shared_lock<std::shared_mutex> guard(m_lock);
+
+    const auto it = m_versions.find(userId);
+    if(it == m_versions.end()) {
+        return m_baseVersion;
+    }
+
+    return it->second;
+}
+
+/**
+ * @brief update the membership-version of a user, after its project-memberships were changed
+ *
+ * @param userId id of the user
+ */
+void
+MembershipVersions::updateVersion(const std::string &userId)
+{
+    const int64_t now = getCurrentTime();
+
+    std::unique_lock<std::shared_mutex> guard(m_lock);
+
+    removeOutdated(now);
+
+    const auto it = m_versions.find(userId);
+    const int64_t oldVersion = it == m_versions.end() ? m_baseVersion : it->second;
+    const int64_t newVersion = now > oldVersion ? now : oldVersion + 1;
+
+    if(it == m_versions.end()
+            && m_versions.size() >= m_maxEntries)
+    {
+        // entries can only be removed, when all tokens with the older version are expired. If
+        // the limit is reached before, the base-version is raised instead, so all existing
+        // tokens are handled like tokens with changed memberships.
+        m_versions.clear();
+        m_baseVersion = newVersion;
+        m_resets++;
+        return;
+    }
+
+    m_versions[userId] = newVersion;
+}
+
+/**
+ * @brief remove a deleted user. This must only be called, after all tokens of the user were
+ *        revoked, because its older tokens get the base-version again.
+ *
+ * @param userId id of the user
+ */
+void
+MembershipVersions::removeUser(const std::string &userId)
+{
+    std::unique_lock<std::shared_mutex> guard(m_lock);
+    m_versions.erase(userId);
+}
+
+/**
+ * @brief remove all entries, which are older than the lifetime of the tokens. All tokens,
+ *        which were created before such a change, are expired, so the base-version can not
+ *        match a token with outdated memberships anymore. Newer tokens of the user only
+ *        fall back to the database. This is only done once per cleanup-interval.
+ *
+ * @param now current time in micro-seconds
+ */
+void
+MembershipVersions::removeOutdated(const int64_t now)
+{
+    if(now < m_nextCleanup) {
+        return;
+    }
+    m_nextCleanup = now + m_cleanupInterval;
+
+    for(auto it = m_versions.begin(); it != m_versions.end(); )
+    {
+        if(it->second + m_maxTokenLifetime <= now) {
+            it = m_versions.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+/**
+ * @brief get number of users with changed memberships since the start
+ */
+uint64_t
+MembershipVersions::getNumberOfEntries()
+{
+    std::shared_lock<std::shared_mutex> guard(m_lock);
+    return m_versions.size();
+}
+
+/**
+ * @brief get number of resets of the versions, because the maximum number of entries was
+ *        reached
+ */
+uint64_t
+MembershipVersions::getNumberOfResets() const
+{
+    return m_resets;
+}
+
+/**
+ * @brief encode the project-memberships of a user into a compact string for the token in the
+ *        format 'PROJECT_ID:ROLE:IS_PROJECT_ADMIN,...'. Project-ids and roles are restricted
+ *        to letters, numbers and '_', so they can not contain the separators.
+ *
+ * @param result reference for the encoded memberships
+ * @param projects projects of the user from the database
+ * @param isAdmin true, if user is global admin and so also member of the admin-project
+ */
+void
+Memberships::encode(std::string &result,
+                    const std::vector<CachedProject> &projects,
+                    const bool isAdmin)
+{
+    result.clear();
+
+    for(const CachedProject &project : projects)
+    {
+        if(result.size() != 0) {
+            result.push_back(',');
+        }
+        result.append(project.projectId);
+        result.push_back(':');
+        result.append(project.role);
+        result.append(project.isProjectAdmin ? ":1" : ":0");
+    }
+
+    if(isAdmin)
+    {
+        if(result.size() != 0) {
+            result.push_back(',');
+        }
+        result.append("admin:admin:1");
+    }
+}
+
+/**
+ * @brief search a project within encoded memberships
+ *
+ * @param role reference for the role of the user within the project
+ * @param isProjectAdmin reference for the project-admin-status of the user
+ * @param memberships encoded memberships
+ * @param projectId id of the project to search
+ *
+ * @return true, if user is member of the project, else false
+ */
+bool
+Memberships::find(std::string &role,
+                  bool &isProjectAdmin,
+                  const std::string &memberships,
+                  const std::string &projectId)
+{
+    uint64_t start = 0;
+    while(start < memberships.size())
+    {
+        uint64_t end = memberships.find(',', start);
+        if(end == std::string::npos) {
+            end = memberships.size();
+        }
+
+        // split entry into project-id, role and admin-flag
+        const uint64_t firstColon = memberships.find(':', start);
+        const uint64_t lastColon = memberships.rfind(':', end - 1);
+        if(firstColon == std::string::npos
+                || firstColon >= end
+                || lastColon <= firstColon)
+        {
+            return false;
+        }
+
+        if(firstColon - start == projectId.size()
+                && memberships.compare(start, firstColon - start, projectId) == 0)
+        {
+            role = memberships.substr(firstColon + 1, lastColon - firstColon - 1);
+            isProjectAdmin = memberships.compare(lastColon + 1, end - lastColon - 1, "1") == 0;
+            return true;
+        }
+
+        start = end + 1;
+    }
+
+    return false;
+}
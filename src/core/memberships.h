@@ -0,0 +1,77 @@
+/**
+ * @file        memberships.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_MEMBERSHIPS_H
+#define MISAKIGUARD_MEMBERSHIPS_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+
+struct CachedProject;
+
+class MembershipVersions
+{
+public:
+    MembershipVersions(const uint32_t maxTokenLifetime,
+                       const uint64_t maxEntries);
+    ~MembershipVersions();
+
+    int64_t getVersion(const std::string &userId);
+    void updateVersion(const std::string &userId);
+    void removeUser(const std::string &userId);
+
+    uint64_t getNumberOfEntries();
+    uint64_t getNumberOfResets() const;
+
+private:
+    // interval in micro-seconds to remove the entries, which are older than all tokens
+    const int64_t m_cleanupInterval = 60000000;
+
+    std::shared_mutex m_lock;
+    std::unordered_map<std::string, int64_t> m_versions;
+    int64_t m_baseVersion = 0;
+    int64_t m_maxTokenLifetime = 0;
+    uint64_t m_maxEntries = 0;
+    int64_t m_nextCleanup = 0;
+
+    std::atomic<uint64_t> m_resets;
+
+    int64_t getCurrentTime() const;
+    void removeOutdated(const int64_t now);
+};
+
+namespace Memberships
+{
+void encode(std::string &result,
+            const std::vector<CachedProject> &projects,
+            const bool isAdmin);
+
+bool find(std::string &role,
+          bool &isProjectAdmin,
+          const std::string &memberships,
+          const std::string &projectId);
+}
+
+#endif // MISAKIGUARD_MEMBERSHIPS_H
@@ -0,0 +1,231 @@
+/**
+ * @file        password_hashing.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "password_hashing.h"
+
+#include <cryptopp/misc.h>
+#include <cryptopp/sha.h>
+#include <cryptopp/pwdbased.h>
+
+#include <libKitsunemimiCrypto/hashes.h>
+
+#include <core/base64url.h>
+
+/**
+ * @brief get the number of iterations out of a versioned password-hash
+ *
+ * @param iterations reference for the resulting number of iterations
+ * @param encodedHash reference for the position of the encoded hash within the password-hash
+ * @param pwHash password-hash to parse
+ *
+ * @return false, if the hash has not the PBKDF2-format, else true
+ */
+bool
+parsePbkdf2Hash(uint32_t &iterations,
+                uint64_t &encodedHash,
+                const std::string &pwHash)
+{
+    if(pwHash.compare(0, PBKDF2_SHA256_PREFIX.size(), PBKDF2_SHA256_PREFIX) != 0) {
+        return false;
+    }
+
+    uint64_t pos = PBKDF2_SHA256_PREFIX.size();
+    uint64_t value = 0;
+    while(pos < pwHash.size()
+          && pwHash[pos] >= '0'
+          && pwHash[pos] <= '9')
+    {
+        value = value * 10 + (pwHash[pos] - '0');
+        if(value > 0xFFFFFFFF) {
+            return false;
+        }
+        pos++;
+    }
+
+    if(pos == PBKDF2_SHA256_PREFIX.size()
+            || value == 0
+            || pos >= pwHash.size()
+            || pwHash[pos] != '$')
+    {
+        return false;
+    }
+
+    iterations = static_cast<uint32_t>(value);
+    encodedHash = pos + 1;
+
+    return true;
+}
+
+/**
+ * @brief derive the PBKDF2-HMAC-SHA256-hash of a password
+ *
+ * @param hash pointer to the buffer for the 32 byte hash
+ * @param password password to hash
+ * @param salt salt of the user
+ * @param iterations number of iterations
+ */
+void
+derivePbkdf2(uint8_t* hash,
+             const std::string &password,
+             const std::string &salt,
+             const uint32_t iterations)
+{
+    CryptoPP::PKCS5_PBKDF2_HMAC<CryptoPP::SHA256> pbkdf;
+    pbkdf.DeriveKey(hash,
+                    CryptoPP::SHA256::DIGESTSIZE,
+                    0,
+                    (const CryptoPP::byte*)password.c_str(),
+                    password.size(),
+                    (const CryptoPP::byte*)salt.c_str(),
+                    salt.size(),
+                    iterations);
+}
+
+/**
+ * @brief create a versioned PBKDF2-HMAC-SHA256-hash of a password
+ *
+ * @param pwHash reference for the resulting password-hash
+ * @param password password to hash
+ * @param salt salt of the user
+ * @param iterations number of iterations, which defines the cost of the hash
+ *
+ * @return false, if number of iterations is invalid, else true
+ */
+bool
+hashPassword(std::string &pwHash,
+             const std::string &password,
+             const std::string &salt,
+             const uint32_t iterations)
+{
+    if(iterations == 0) {
+        return false;
+    }
+
+    uint8_t hash[CryptoPP::SHA256::DIGESTSIZE];
+    derivePbkdf2(hash, password, salt, iterations);
+
+    pwHash = PBKDF2_SHA256_PREFIX;
+    pwHash.append(std::to_string(iterations));
+    pwHash.push_back('$');
+    encodeBase64Url(pwHash, hash, CryptoPP::SHA256::DIGESTSIZE);
+
+    return true;
+}
+
+/**
+ * @brief check a password against the stored hash of a user, which can be in any of the
+ *        supported versions
+ *
+ * @param password password to check
+ * @param salt salt of the user
+ * @param pwHash stored password-hash of the user
+ *
+ * @return true, if password matches, else false
+ */
+bool
+checkPassword(const std::string &password,
+              const std::string &salt,
+              const std::string &pwHash)
+{
+    std::string compareHash = "";
+
+    uint32_t iterations = 0;
+    uint64_t encodedHash = 0;
+    if(parsePbkdf2Hash(iterations, encodedHash, pwHash))
+    {
+        uint8_t hash[CryptoPP::SHA256::DIGESTSIZE];
+        derivePbkdf2(hash, password, salt, iterations);
+        compareHash = pwHash.substr(0, encodedHash);
+        encodeBase64Url(compareHash, hash, CryptoPP::SHA256::DIGESTSIZE);
+    }
+    else
+    {
+        // old unversioned hash
+        const std::string saltedPw = password + salt;
+        Kitsunemimi::generate_SHA_256(compareHash, saltedPw);
+    }
+
+    if(pwHash.size() != compareHash.size()) {
+        return false;
+    }
+
+    return CryptoPP::VerifyBufsEqual((const CryptoPP::byte*)pwHash.c_str(),
+                                     (const CryptoPP::byte*)compareHash.c_str(),
+                                     pwHash.size());
+}
+
+/**
+ * @brief check if a stored password-hash should be replaced by a new one
+ *
+ * @param pwHash stored password-hash of the user
+ * @param iterations currently configured number of iterations
+ *
+ * @return true, if hash is outdated, else false
+ */
+bool
+needsRehash(const std::string &pwHash,
+            const uint32_t iterations)
+{
+    uint32_t hashIterations = 0;
+    uint64_t encodedHash = 0;
+    if(parsePbkdf2Hash(hashIterations, encodedHash, pwHash) == false) {
+        return true;
+    }
+
+    return hashIterations != iterations;
+}
+
+/**
+ * @brief create a password-hash, which doesn't match any password, but costs the same time to
+ *        check like a real hash with the same number of iterations. It is checked for unknown
+ *        users, so the response-time doesn't show, if a user exists.
+ *
+ * @param pwHash reference for the resulting password-hash
+ * @param iterations number of iterations, which defines the cost of the check
+ */
+void
+createDecoyHash(std::string &pwHash,
+                const uint32_t iterations)
+{
+    const uint8_t hash[CryptoPP::SHA256::DIGESTSIZE] = {0};
+
+    pwHash = PBKDF2_SHA256_PREFIX;
+    pwHash.append(std::to_string(iterations));
+    pwHash.push_back('$');
+    encodeBase64Url(pwHash, hash, CryptoPP::SHA256::DIGESTSIZE);
+}
+
+/**
+ * @brief overwrite a plaintext password in memory, before it is released, so it doesn't stay
+ *        within the freed memory
+ *
+ * @param password password to wipe, which is empty afterwards
+ */
+void
+wipePassword(std::string &password)
+{
+    if(password.size() > 0) {
+        CryptoPP::SecureWipeBuffer(reinterpret_cast<CryptoPP::byte*>(&password[0]),
+                                   password.size());
+    }
+    password.clear();
+}
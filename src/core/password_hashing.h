@@ -0,0 +1,51 @@
+/**
+ * @file        password_hashing.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_PASSWORD_HASHING_H
+#define MISAKIGUARD_PASSWORD_HASHING_H
+
+#include <string>
+#include <string_view>
+
+// prefix of the password-hashes, which are created with PBKDF2-HMAC-SHA256. The complete
+// format is '$pbkdf2-sha256$i=<ITERATIONS>$<BASE64URL_HASH>'. Hashes without '$' at the
+// beginning are the old unversioned SHA-256-hashes.
+inline constexpr std::string_view PBKDF2_SHA256_PREFIX = "$pbkdf2-sha256$i=";
+
+bool hashPassword(std::string &pwHash,
+                  const std::string &password,
+                  const std::string &salt,
+                  const uint32_t iterations);
+
+bool checkPassword(const std::string &password,
+                   const std::string &salt,
+                   const std::string &pwHash);
+
+bool needsRehash(const std::string &pwHash,
+                 const uint32_t iterations);
+
+void createDecoyHash(std::string &pwHash,
+                     const uint32_t iterations);
+
+void wipePassword(std::string &password);
+
+#endif // MISAKIGUARD_PASSWORD_HASHING_H
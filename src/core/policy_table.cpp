@@ -0,0 +1,248 @@
+/**
+ * @file        policy_table.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "policy_table.h"
+
+#include <string_view>
+#include <vector>
+#include <mutex>
+
+#include <libKitsunemimiCommon/methods/string_methods.h>
+#include <libKitsunemimiHanamiPolicies/policy.h>
+
+using Kitsunemimi::Hanami::HttpRequestType;
+
+/**
+ * @brief constructor
+ *
+ * @param policy pointer to the parsed policy-file, which is the source of all decisions
+ * @param policyFileContent content of the policy-file, which names the compiled endpoints
+ */
+PolicyTable::PolicyTable(Kitsunemimi::Hanami::Policy* policy,
+                         const std::string &policyFileContent)
+{
+    m_policy = policy;
+    compileEndpoints(policyFileContent);
+}
+
+/**
+ * @brief destructor
+ */
+PolicyTable::~PolicyTable() {}
+
+/**
+ * @brief add all endpoints, which are named by the policy-file, to the table. Only the names
+ *        are read from the file, the decisions itself are still evaluated by the parsed policy.
+ *
+ * @param policyFileContent content of the policy-file
+ */
+void
+PolicyTable::compileEndpoints(const std::string &policyFileContent)
+{
+    // decisions for all endpoints, which have no rule within the policy-file
+    m_noRuleDecision[0] = false;
+    for(uint32_t i = 1; i < NUMBER_OF_HTTP_TYPES; i++)
+    {
+        const HttpRequestType type = static_cast<HttpRequestType>(i);
+        m_noRuleDecision[i] = m_policy->checkUserAgainstPolicy("", "", type, "");
+    }
+
+    std::vector<std::string> lines;
+    Kitsunemimi::splitStringByDelimiter(lines, policyFileContent, '\n');
+
+    std::string component = "";
+    for(std::string &line : lines)
+    {
+        Kitsunemimi::trim(line);
+
+        // component-header in the format '[component]'
+        if(line.size() > 2
+                && line.front() == '['
+                && line.back() == ']')
+        {
+            component = line.substr(1, line.size() - 2);
+            Kitsunemimi::trim(component);
+            continue;
+        }
+
+        // endpoint in the format '- endpoint' within the last component
+        if(line.size() > 1
+                && line.front() == '-'
+                && component != "")
+        {
+            EndpointEntry newEntry;
+            newEntry.component = component;
+            newEntry.endpoint = line.substr(1);
+            Kitsunemimi::trim(newEntry.endpoint);
+            for(uint32_t i = 0; i < NUMBER_OF_HTTP_TYPES; i++) {
+                newEntry.allowedRoles[i] = 0;
+            }
+
+            // an endpoint, whose key collides with another one, is not added and checked
+            // directly against the policy instead
+            const uint64_t key = getEndpointKey(newEntry.component, newEntry.endpoint);
+            m_endpoints.emplace(key, newEntry);
+        }
+    }
+}
+
+/**
+ * @brief get key of an endpoint within the table
+ *
+ * @param component name of the component
+ * @param endpoint name of the endpoint within the component
+ *
+ * @return combined hash of component- and endpoint-name
+ */
+uint64_t
+PolicyTable::getEndpointKey(const std::string &component,
+                            const std::string &endpoint) const
+{
+    const uint64_t componentHash = std::hash<std::string_view>{}(component);
+    const uint64_t endpointHash = std::hash<std::string_view>{}(endpoint);
+
+    return componentHash ^ (endpointHash + 0x9e3779b97f4a7c15 + (componentHash << 6));
+}
+
+/**
+ * @brief check if a role is allowed to access an endpoint with a specific http-type
+ *
+ * @param component name of the requested component
+ * @param endpoint requested endpoint within the component
+ * @param type http-type of the request
+ * @param role role of the user, who made the request
+ *
+ * @return true, if access is allowed by the policy, else false
+ */
+bool
+PolicyTable::checkUserAgainstPolicy(const std::string &component,
+                                    const std::string &endpoint,
+                                    const HttpRequestType type,
+                                    const std::string &role)
+{
+    const uint32_t typeId = static_cast<uint32_t>(type);
+    if(typeId == 0
+            || typeId >= NUMBER_OF_HTTP_TYPES)
+    {
+        return false;
+    }
+
+    const uint64_t key = getEndpointKey(component, endpoint);
+    bool knownEndpoint = false;
+
+    // fast path with already compiled decisions
+    {
+        std::shared_lock<std::shared_mutex> readGuard(m_lock);
+
+        // endpoints, which are not named by the policy-file, share the same decision and are
+        // not added to the table
+        const auto endpointIt = m_endpoints.find(key);
+        if(endpointIt == m_endpoints.end()) {
+            return m_noRuleDecision[typeId];
+        }
+
+        const EndpointEntry &entry = endpointIt->second;
+        knownEndpoint = entry.component == component
+                        && entry.endpoint == endpoint;
+        if(knownEndpoint)
+        {
+            const auto roleIt = m_roleIds.find(role);
+            if(roleIt != m_roleIds.end())
+            {
+                const uint64_t roleBit = 1ULL << roleIt->second;
+                return (entry.allowedRoles[typeId] & roleBit) != 0;
+            }
+        }
+    }
+
+    // compile decisions of a new role once for all endpoints
+    if(knownEndpoint
+            && compileRole(role))
+    {
+        return checkUserAgainstPolicy(component, endpoint, type, role);
+    }
+
+    // fallback for colliding keys or if the table has no free role
+    return m_policy->checkUserAgainstPolicy(component, endpoint, type, role);
+}
+
+/**
+ * @brief evaluate the policy for a new role for all endpoints and http-types and write the
+ *        result as bits into the table
+ *
+ * @param role role of the user, who made the request
+ *
+ * @return false, if the table has no free role, else true
+ */
+bool
+PolicyTable::compileRole(const std::string &role)
+{
+    std::unique_lock<std::shared_mutex> writeGuard(m_lock);
+
+    // role was already compiled by another request
+    if(m_roleIds.find(role) != m_roleIds.end()) {
+        return true;
+    }
+
+    if(m_roleIds.size() >= MAX_NUMBER_OF_ROLES) {
+        return false;
+    }
+
+    const uint32_t roleId = m_roleIds.size();
+    m_roleIds.emplace(role, roleId);
+
+    // evaluate policy for each endpoint and http-type
+    const uint64_t roleBit = 1ULL << roleId;
+    for(auto it = m_endpoints.begin(); it != m_endpoints.end(); it++)
+    {
+        EndpointEntry &entry = it->second;
+        for(uint32_t i = 1; i < NUMBER_OF_HTTP_TYPES; i++)
+        {
+            const HttpRequestType type = static_cast<HttpRequestType>(i);
+            if(m_policy->checkUserAgainstPolicy(entry.component, entry.endpoint, type, role)) {
+                entry.allowedRoles[i] |= roleBit;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief get number of compiled endpoints
+ */
+uint64_t
+PolicyTable::getNumberOfEndpoints()
+{
+    std::shared_lock<std::shared_mutex> readGuard(m_lock);
+    return m_endpoints.size();
+}
+
+/**
+ * @brief get number of interned roles
+ */
+uint64_t
+PolicyTable::getNumberOfRoles()
+{
+    std::shared_lock<std::shared_mutex> readGuard(m_lock);
+    return m_roleIds.size();
+}
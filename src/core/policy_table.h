@@ -0,0 +1,81 @@
+/**
+ * @file        policy_table.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_POLICY_TABLE_H
+#define MISAKIGUARD_POLICY_TABLE_H
+
+#include <string>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+namespace Kitsunemimi {
+namespace Hanami {
+class Policy;
+}
+}
+
+class PolicyTable
+{
+public:
+    PolicyTable(Kitsunemimi::Hanami::Policy* policy,
+                const std::string &policyFileContent);
+    ~PolicyTable();
+
+    bool checkUserAgainstPolicy(const std::string &component,
+                                const std::string &endpoint,
+                                const Kitsunemimi::Hanami::HttpRequestType type,
+                                const std::string &role);
+
+    uint64_t getNumberOfEndpoints();
+    uint64_t getNumberOfRoles();
+
+private:
+    // one bitset for each possible http-type (DELETE = 1, GET = 2, HEAD = 3, POST = 4, PUT = 5)
+    static const uint32_t NUMBER_OF_HTTP_TYPES = 6;
+    // one bit per role within the bitsets
+    static const uint32_t MAX_NUMBER_OF_ROLES = 64;
+
+    struct EndpointEntry
+    {
+        std::string component = "";
+        std::string endpoint = "";
+        uint64_t allowedRoles[NUMBER_OF_HTTP_TYPES];
+    };
+
+    Kitsunemimi::Hanami::Policy* m_policy = nullptr;
+    // decision for all endpoints, which are not named by the policy-file
+    bool m_noRuleDecision[NUMBER_OF_HTTP_TYPES];
+
+    std::shared_mutex m_lock;
+    std::unordered_map<std::string, uint32_t> m_roleIds;
+    // endpoints are only added by the constructor, so requests can not fill the table
+    std::unordered_map<uint64_t, EndpointEntry> m_endpoints;
+
+    void compileEndpoints(const std::string &policyFileContent);
+    uint64_t getEndpointKey(const std::string &component,
+                            const std::string &endpoint) const;
+    bool compileRole(const std::string &role);
+};
+
+#endif // MISAKIGUARD_POLICY_TABLE_H
@@ -0,0 +1,211 @@
+/**
+ * @file        rate_limiter.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "rate_limiter.h"
+
+#include <chrono>
+
+/**
+ * @brief constructor
+ *
+ * @param attemptsPerMinute number of attempts per minute, which are allowed for each key
+ * @param burstSize number of attempts, which are allowed directly one after another
+ * @param maxNumberOfEntries maximum number of keys, which are tracked at the same time
+ * @param numberOfStripes number of independent locked parts of the limiter
+ */
+RateLimiter::RateLimiter(const uint32_t attemptsPerMinute,
+                         const uint32_t burstSize,
+                         const uint64_t maxNumberOfEntries,
+                         const uint32_t numberOfStripes)
+{
+    m_numberOfStripes = numberOfStripes;
+    if(m_numberOfStripes == 0) {
+        m_numberOfStripes = 1;
+    }
+
+    m_maxEntriesPerStripe = maxNumberOfEntries / m_numberOfStripes;
+    if(m_maxEntriesPerStripe == 0) {
+        m_maxEntriesPerStripe = 1;
+    }
+
+    m_stripes = new Stripe[m_numberOfStripes];
+    m_refillRate = static_cast<double>(attemptsPerMinute) / 60000000.0;
+    m_burstSize = burstSize == 0 ? 1.0 : static_cast<double>(burstSize);
+
+    m_throttled = 0;
+}
+
+/**
+ * @brief destructor
+ */
+RateLimiter::~RateLimiter()
+{
+    delete[] m_stripes;
+}
+
+/**
+ * @brief get current time in micro-seconds
+ */
+int64_t
+RateLimiter::getCurrentTime() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief add the tokens to a bucket, which were generated since its last update
+ *
+ * @param bucket bucket to update
+ * @param now current time in micro-seconds
+ */
+void
+RateLimiter::refill(Bucket &bucket,
+                    const int64_t now) const
+{
+    const double newTokens = static_cast<double>(now - bucket.lastUpdate) * m_refillRate;
+    bucket.tokens += newTokens;
+    if(bucket.tokens > m_burstSize) {
+        bucket.tokens = m_burstSize;
+    }
+    bucket.lastUpdate = now;
+}
+
+/**
+ * @brief get the stripe, which is responsible for a key
+ *
+ * @param key key to check
+ *
+ * @return reference to the stripe
+ */
+RateLimiter::Stripe&
+RateLimiter::getStripe(const std::string &key)
+{
+    const uint64_t hash = std::hash<std::string>{}(key);
+    return m_stripes[hash % m_numberOfStripes];
+}
+
+/**
+ * @brief remove the least recently used bucket of a stripe, but only if it is completely
+ *        refilled and so has the same state like a new bucket. Buckets of throttled keys are
+ *        never removed, so they can not be reset by filling the stripe with new keys.
+ *
+ * @param stripe stripe to clean up
+ * @param now current time in micro-seconds
+ *
+ * @return true, if a bucket was removed, else false
+ */
+bool
+RateLimiter::removeIdleBucket(Stripe &stripe,
+                              const int64_t now)
+{
+    if(stripe.usageList.empty()) {
+        return false;
+    }
+
+    auto it = stripe.buckets.find(stripe.usageList.back());
+    refill(it->second, now);
+    if(it->second.tokens < m_burstSize) {
+        return false;
+    }
+
+    stripe.buckets.erase(it);
+    stripe.usageList.pop_back();
+
+    return true;
+}
+
+/**
+ * @brief check if a new attempt for a key is allowed and consume a token from its bucket. If
+ *        the stripe of a new key is full and its least recently used bucket is still in use,
+ *        the attempt is rejected, to limit the memory-usage without resetting other buckets.
+ *
+ * @param key key to check (for example an user-id)
+ *
+ * @return true, if attempt is allowed, else false
+ */
+bool
+RateLimiter::allow(const std::string &key)
+{
+    Stripe &stripe = getStripe(key);
+    const int64_t now = getCurrentTime();
+
+    std::lock_guard<std::mutex> guard(stripe.lock);
+
+    auto it = stripe.buckets.find(key);
+    if(it == stripe.buckets.end())
+    {
+        if(stripe.buckets.size() >= m_maxEntriesPerStripe
+                && removeIdleBucket(stripe, now) == false)
+        {
+            m_throttled++;
+            return false;
+        }
+
+        stripe.usageList.push_front(key);
+        Bucket newBucket;
+        newBucket.tokens = m_burstSize;
+        newBucket.lastUpdate = now;
+        newBucket.position = stripe.usageList.begin();
+        it = stripe.buckets.emplace(key, newBucket).first;
+    }
+    else
+    {
+        refill(it->second, now);
+        stripe.usageList.splice(stripe.usageList.begin(), stripe.usageList, it->second.position);
+    }
+
+    if(it->second.tokens < 1.0)
+    {
+        m_throttled++;
+        return false;
+    }
+
+    it->second.tokens -= 1.0;
+
+    return true;
+}
+
+/**
+ * @brief get number of rejected attempts
+ */
+uint64_t
+RateLimiter::getNumberOfThrottled() const
+{
+    return m_throttled;
+}
+
+/**
+ * @brief get number of keys, which are currently tracked
+ */
+uint64_t
+RateLimiter::getNumberOfEntries()
+{
+    uint64_t result = 0;
+    for(uint32_t i = 0; i < m_numberOfStripes; i++)
+    {
+        std::lock_guard<std::mutex> guard(m_stripes[i].lock);
+        result += m_stripes[i].buckets.size();
+    }
+
+    return result;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file        rate_limiter.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_RATE_LIMITER_H
+#define MISAKIGUARD_RATE_LIMITER_H
+
+#include <string>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+class RateLimiter
+{
+public:
+    RateLimiter(const uint32_t attemptsPerMinute,
+                const uint32_t burstSize,
+                const uint64_t maxNumberOfEntries,
+                const uint32_t numberOfStripes = 16);
+    ~RateLimiter();
+
+    bool allow(const std::string &key);
+
+    uint64_t getNumberOfThrottled() const;
+    uint64_t getNumberOfEntries();
+
+private:
+    struct Bucket
+    {
+        double tokens = 0.0;
+        int64_t lastUpdate = 0;
+        // position of the key within the usage-list of the stripe
+        std::list<std::string>::iterator position;
+    };
+
+    struct Stripe
+    {
+        std::mutex lock;
+        // keys sorted by their last usage, with the most recently used key at the front
+        std::list<std::string> usageList;
+        std::unordered_map<std::string, Bucket> buckets;
+    };
+
+    Stripe* m_stripes = nullptr;
+    uint32_t m_numberOfStripes = 0;
+    uint64_t m_maxEntriesPerStripe = 0;
+    // number of tokens, which are added to a bucket per micro-second
+    double m_refillRate = 0.0;
+    double m_burstSize = 0.0;
+
+    std::atomic<uint64_t> m_throttled;
+
+    Stripe &getStripe(const std::string &key);
+    void refill(Bucket &bucket, const int64_t now) const;
+    bool removeIdleBucket(Stripe &stripe, const int64_t now);
+    int64_t getCurrentTime() const;
+};
+
+#endif // MISAKIGUARD_RATE_LIMITER_H
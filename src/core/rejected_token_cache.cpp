@@ -0,0 +1,221 @@
+/**
+ * @file        rejected_token_cache.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "rejected_token_cache.h"
+
+#include <chrono>
+
+#include <cryptopp/sha.h>
+
+/**
+ * @brief constructor
+ *
+ * @param maxNumberOfEntries maximum number of rejected tokens, which are stored at the same time
+ * @param timeToLive number of seconds, how long a token is stored as rejected
+ * @param numberOfShards number of independent locked parts of the cache
+ */
+RejectedTokenCache::RejectedTokenCache(const uint64_t maxNumberOfEntries,
+                                       const uint32_t timeToLive,
+                                       const uint32_t numberOfShards)
+{
+    m_numberOfShards = numberOfShards;
+    if(m_numberOfShards == 0) {
+        m_numberOfShards = 1;
+    }
+
+    m_maxEntriesPerShard = maxNumberOfEntries / m_numberOfShards;
+    if(m_maxEntriesPerShard == 0) {
+        m_maxEntriesPerShard = 1;
+    }
+
+    m_timeToLive = timeToLive;
+    m_shards = new CacheShard[m_numberOfShards];
+
+    m_rejections = 0;
+    m_cachedRejections = 0;
+}
+
+/**
+ * @brief destructor
+ */
+RejectedTokenCache::~RejectedTokenCache()
+{
+    delete[] m_shards;
+}
+
+/**
+ * @brief get fingerprint of a token
+ *
+ * @param fingerprint reference for the sha256-digest of the complete token
+ * @param token token to hash
+ */
+void
+RejectedTokenCache::getFingerprint(Fingerprint &fingerprint,
+                                   const std::string &token) const
+{
+    CryptoPP::SHA256().CalculateDigest(fingerprint.data(),
+                                       reinterpret_cast<const uint8_t*>(token.c_str()),
+                                       token.size());
+}
+
+/**
+ * @brief get the shard, which is responsible for a fingerprint
+ *
+ * @param fingerprint fingerprint of the token
+ *
+ * @return pointer to the shard
+ */
+RejectedTokenCache::CacheShard*
+RejectedTokenCache::getShard(const Fingerprint &fingerprint) const
+{
+    // the map of the shard uses the first bytes, so the shard is selected by the last bytes
+    uint32_t shardId = 0;
+    memcpy(&shardId, fingerprint.data() + fingerprint.size() - sizeof(uint32_t), sizeof(uint32_t));
+    return &m_shards[shardId % m_numberOfShards];
+}
+
+/**
+ * @brief get current unix-time in seconds
+ */
+int64_t
+RejectedTokenCache::getCurrentTime() const
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief check if a token was recently rejected
+ *
+ * @param token token to check
+ *
+ * @return true, if token was rejected within the time-to-live, else false
+ */
+bool
+RejectedTokenCache::isRejected(const std::string &token)
+{
+    Fingerprint fingerprint;
+    getFingerprint(fingerprint, token);
+    CacheShard* shard = getShard(fingerprint);
+
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    // the map compares the complete digest and not only its hash
+    auto it = shard->entries.find(fingerprint);
+    if(it == shard->entries.end()) {
+        return false;
+    }
+
+    // remove outdated entry
+    if(getCurrentTime() >= it->second->expiresAt)
+    {
+        shard->entryList.erase(it->second);
+        shard->entries.erase(it);
+        return false;
+    }
+
+    m_rejections++;
+    m_cachedRejections++;
+
+    return true;
+}
+
+/**
+ * @brief register a token as rejected
+ *
+ * @param token rejected token
+ */
+void
+RejectedTokenCache::add(const std::string &token)
+{
+    Fingerprint fingerprint;
+    getFingerprint(fingerprint, token);
+    CacheShard* shard = getShard(fingerprint);
+    const int64_t now = getCurrentTime();
+
+    m_rejections++;
+
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    // remove an already existing entry, so it is added again as newest entry
+    auto it = shard->entries.find(fingerprint);
+    if(it != shard->entries.end())
+    {
+        shard->entryList.erase(it->second);
+        shard->entries.erase(it);
+    }
+
+    // remove outdated entries and the oldest entry, if shard is still full, from the end of
+    // the list, so no complete scan of the shard is necessary
+    while(shard->entryList.size() != 0)
+    {
+        const CacheEntry &oldestEntry = shard->entryList.back();
+        if(now < oldestEntry.expiresAt
+                && shard->entryList.size() < m_maxEntriesPerShard)
+        {
+            break;
+        }
+
+        shard->entries.erase(oldestEntry.fingerprint);
+        shard->entryList.pop_back();
+    }
+
+    CacheEntry newEntry;
+    newEntry.fingerprint = fingerprint;
+    newEntry.expiresAt = now + m_timeToLive;
+    shard->entryList.push_front(newEntry);
+    shard->entries.emplace(fingerprint, shard->entryList.begin());
+}
+
+/**
+ * @brief get number of all rejected validations
+ */
+uint64_t
+RejectedTokenCache::getNumberOfRejections() const
+{
+    return m_rejections;
+}
+
+/**
+ * @brief get number of rejected validations, which were answered by the cache
+ */
+uint64_t
+RejectedTokenCache::getNumberOfCachedRejections() const
+{
+    return m_cachedRejections;
+}
+
+/**
+ * @brief get number of tokens, which are currently stored as rejected
+ */
+uint64_t
+RejectedTokenCache::getNumberOfEntries()
+{
+    uint64_t result = 0;
+    for(uint32_t i = 0; i < m_numberOfShards; i++)
+    {
+        std::lock_guard<std::mutex> guard(m_shards[i].lock);
+        result += m_shards[i].entries.size();
+    }
+
+    return result;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file        rejected_token_cache.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_REJECTED_TOKEN_CACHE_H
+#define MISAKIGUARD_REJECTED_TOKEN_CACHE_H
+
+#include <string>
+#include <array>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <cstring>
+#include <unordered_map>
+
+class RejectedTokenCache
+{
+public:
+    RejectedTokenCache(const uint64_t maxNumberOfEntries,
+                       const uint32_t timeToLive,
+                       const uint32_t numberOfShards = 16);
+    ~RejectedTokenCache();
+
+    bool isRejected(const std::string &token);
+    void add(const std::string &token);
+
+    uint64_t getNumberOfRejections() const;
+    uint64_t getNumberOfCachedRejections() const;
+    uint64_t getNumberOfEntries();
+
+private:
+    // sha256-digest of a token, which is compared completely, so a valid token can not be
+    // rejected because of a collision with a rejected one
+    typedef std::array<uint8_t, 32> Fingerprint;
+
+    struct FingerprintHash
+    {
+        size_t operator()(const Fingerprint &fingerprint) const
+        {
+            size_t result = 0;
+            memcpy(&result, fingerprint.data(), sizeof(size_t));
+            return result;
+        }
+    };
+
+    struct CacheEntry
+    {
+        Fingerprint fingerprint;
+        int64_t expiresAt = 0;
+    };
+
+    struct CacheShard
+    {
+        std::mutex lock;
+        // ordered by the time of the rejection, where the newest entry is the first one. All
+        // entries have the same time-to-live, so the last entry is always the first to expire.
+        std::list<CacheEntry> entryList;
+        std::unordered_map<Fingerprint, std::list<CacheEntry>::iterator, FingerprintHash> entries;
+    };
+
+    CacheShard* m_shards = nullptr;
+    uint32_t m_numberOfShards = 0;
+    uint64_t m_maxEntriesPerShard = 0;
+    uint32_t m_timeToLive = 0;
+
+    std::atomic<uint64_t> m_rejections;
+    std::atomic<uint64_t> m_cachedRejections;
+
+    void getFingerprint(Fingerprint &fingerprint, const std::string &token) const;
+    CacheShard* getShard(const Fingerprint &fingerprint) const;
+    int64_t getCurrentTime() const;
+};
+
+#endif // MISAKIGUARD_REJECTED_TOKEN_CACHE_H
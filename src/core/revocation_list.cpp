@@ -0,0 +1,437 @@
+/**
+ * @file        revocation_list.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "revocation_list.h"
+
+#include <chrono>
+#include <mutex>
+
+#include <libKitsunemimiCommon/items/table_item.h>
+#include <libKitsunemimiCommon/items/data_items.h>
+
+#include <database/revocations_table.h>
+
+// timestamps below this value are seconds instead of micro-seconds (year 5138 in seconds)
+const int64_t MIN_MICROS_TIMESTAMP = 100000000000;
+
+/**
+ * @brief constructor of the bloom-filter
+ *
+ * @param numberOfBits number of bits of the filter
+ */
+RevocationList::BloomFilter::BloomFilter(const uint64_t numberOfBits)
+{
+    const uint64_t numberOfWords = (numberOfBits + 63) / 64;
+    this->numberOfBits = numberOfWords * 64;
+    words = new std::atomic<uint64_t>[numberOfWords];
+    for(uint64_t i = 0; i < numberOfWords; i++) {
+        words[i] = 0;
+    }
+}
+
+/**
+ * @brief destructor of the bloom-filter
+ */
+RevocationList::BloomFilter::~BloomFilter()
+{
+    delete[] words;
+}
+
+/**
+ * @brief constructor
+ *
+ * @param revocationsTable database-table, where the revocations are persisted
+ * @param maxTokenLifetime maximum number of seconds, which a token is valid
+ * @param numberOfFilterBits size of the bloom-filter in bits
+ */
+RevocationList::RevocationList(RevocationsTable* revocationsTable,
+                               const uint32_t maxTokenLifetime,
+                               const uint64_t numberOfFilterBits)
+{
+    m_revocationsTable = revocationsTable;
+    m_maxTokenLifetime = maxTokenLifetime;
+    m_numberOfFilterBits = numberOfFilterBits;
+    if(m_numberOfFilterBits == 0) {
+        m_numberOfFilterBits = 64;
+    }
+
+    m_filter = std::make_shared<BloomFilter>(m_numberOfFilterBits);
+    m_nextCleanup = getCurrentTime() + m_cleanupInterval;
+
+    m_filterHits = 0;
+    m_revokedRequests = 0;
+}
+
+/**
+ * @brief destructor
+ */
+RevocationList::~RevocationList() {}
+
+/**
+ * @brief get current time in seconds
+ */
+int64_t
+RevocationList::getCurrentTime() const
+{
+    return getCurrentTimeMicros() / 1000000;
+}
+
+/**
+ * @brief get current time in micro-seconds, which is used for the revocations of users
+ */
+int64_t
+RevocationList::getCurrentTimeMicros() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief add a key to a bloom-filter
+ *
+ * @param filter filter to update
+ * @param key key to add
+ */
+void
+RevocationList::addToFilter(BloomFilter* filter,
+                            const std::string &key)
+{
+    // double-hashing to get all positions out of a single hash
+    const uint64_t hash1 = std::hash<std::string>{}(key);
+    const uint64_t hash2 = ((hash1 >> 32) | (hash1 << 32)) * 0x9E3779B97F4A7C15ULL | 1;
+
+    for(uint32_t i = 0; i < m_numberOfHashes; i++)
+    {
+        const uint64_t bit = (hash1 + i * hash2) % filter->numberOfBits;
+        filter->words[bit / 64].fetch_or(1ULL << (bit % 64), std::memory_order_release);
+    }
+}
+
+/**
+ * @brief check if a key is possibly within a bloom-filter
+ *
+ * @param filter filter to check
+ * @param key key to search for
+ *
+ * @return false, if key is definitely not in the filter, else true
+ */
+bool
+RevocationList::checkFilter(const BloomFilter* filter,
+                            const std::string &key) const
+{
+    const uint64_t hash1 = std::hash<std::string>{}(key);
+    const uint64_t hash2 = ((hash1 >> 32) | (hash1 << 32)) * 0x9E3779B97F4A7C15ULL | 1;
+
+    for(uint32_t i = 0; i < m_numberOfHashes; i++)
+    {
+        const uint64_t bit = (hash1 + i * hash2) % filter->numberOfBits;
+        const uint64_t word = filter->words[bit / 64].load(std::memory_order_acquire);
+        if((word & (1ULL << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief load all revocations, which are not expired, from the database
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+RevocationList::loadRevocations(Kitsunemimi::ErrorContainer &error)
+{
+    Kitsunemimi::TableItem table;
+    if(m_revocationsTable->getAllRevocations(table, error) == false)
+    {
+        error.addMeesage("Failed to load revocations from database");
+        return false;
+    }
+
+    const int64_t now = getCurrentTime();
+    std::vector<std::string> expiredIds;
+
+    std::unique_lock<std::shared_mutex> guard(m_lock);
+
+    const std::shared_ptr<BloomFilter> filter = std::atomic_load(&m_filter);
+    for(uint64_t i = 0; i < table.getNumberOfRows(); i++)
+    {
+        const Kitsunemimi::DataArray* row = table.getRow(i, false);
+        const std::string id = row->get(0)->getString();
+        const std::string type = row->get(1)->getString();
+        int64_t notBefore = row->get(2)->getLong();
+        const int64_t expiresAt = row->get(3)->getLong();
+
+        if(expiresAt <= now)
+        {
+            expiredIds.push_back(id);
+            continue;
+        }
+
+        // revocations of older versions have the time in seconds and so revoke the whole
+        // second, like before
+        if(notBefore < MIN_MICROS_TIMESTAMP) {
+            notBefore = notBefore * 1000000 + 999999;
+        }
+
+        if(type == "token") {
+            m_revokedTokens[id] = expiresAt;
+        } else {
+            m_revokedUsers[id] = notBefore;
+        }
+        addToFilter(filter.get(), id);
+    }
+
+    guard.unlock();
+
+    // revocations of already expired tokens are not necessary anymore
+    for(const std::string &id : expiredIds)
+    {
+        if(m_revocationsTable->deleteRevocation(id, error) == false) {
+            LOG_ERROR(error);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief revoke a single token
+ *
+ * @param tokenId id of the token (jti-claim)
+ * @param expiresAt timestamp, when the token expires
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+RevocationList::revokeToken(const std::string &tokenId,
+                            const int64_t expiresAt,
+                            Kitsunemimi::ErrorContainer &error)
+{
+    if(m_revocationsTable->addRevocation(tokenId, "token", 0, expiresAt, error) == false)
+    {
+        error.addMeesage("Failed to revoke token with id '" + tokenId + "'");
+        return false;
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> guard(m_lock);
+        m_revokedTokens[tokenId] = expiresAt;
+        addToFilter(std::atomic_load(&m_filter).get(), tokenId);
+    }
+
+    removeExpired(error);
+
+    return true;
+}
+
+/**
+ * @brief revoke all tokens of a user, which were issued until now
+ *
+ * @param userId id of the user
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+RevocationList::revokeUser(const std::string &userId,
+                           Kitsunemimi::ErrorContainer &error)
+{
+    const int64_t nowMicros = getCurrentTimeMicros();
+    const int64_t expiresAt = nowMicros / 1000000 + m_maxTokenLifetime;
+
+    if(m_revocationsTable->addRevocation(userId, "user", nowMicros, expiresAt, error) == false)
+    {
+        error.addMeesage("Failed to revoke tokens of user with id '" + userId + "'");
+        return false;
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> guard(m_lock);
+        m_revokedUsers[userId] = nowMicros;
+        addToFilter(std::atomic_load(&m_filter).get(), userId);
+    }
+
+    removeExpired(error);
+
+    return true;
+}
+
+/**
+ * @brief check if a token was revoked. In the common case of a not revoked token, this is
+ *        only a lock-free probe of the bloom-filter and the exact sets are not touched.
+ *
+ * @param claims claims of the already verified token
+ *
+ * @return true, if the token or all tokens of its user were revoked, else false
+ */
+bool
+RevocationList::isRevoked(const TokenClaims &claims)
+{
+    const std::shared_ptr<const BloomFilter> filter = std::atomic_load(&m_filter);
+    const bool tokenHit = claims.tokenId != "" && checkFilter(filter.get(), claims.tokenId);
+    const bool userHit = checkFilter(filter.get(), claims.id);
+    if(tokenHit == false
+            && userHit == false)
+    {
+        return false;
+    }
+
+    // check exact sets, because the bloom-filter can have false positives
+    m_filterHits++;
+    std::shared_lock<std::shared_mutex> guard(m_lock);
+
+    if(tokenHit)
+    {
+        if(m_revokedTokens.find(claims.tokenId) != m_revokedTokens.end())
+        {
+            m_revokedRequests++;
+            return true;
+        }
+    }
+
+    if(userHit)
+    {
+        const auto it = m_revokedUsers.find(claims.id);
+        if(it != m_revokedUsers.end()
+                && claims.iatMicros <= it->second)
+        {
+            m_revokedRequests++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief remove expired revocations and rebuild the bloom-filter without them. This is only
+ *        done once per cleanup-interval.
+ *
+ * @param error reference for error-output
+ */
+void
+RevocationList::removeExpired(Kitsunemimi::ErrorContainer &error)
+{
+    const int64_t now = getCurrentTime();
+    std::vector<std::string> expiredIds;
+
+    {
+        std::unique_lock<std::shared_mutex> guard(m_lock);
+
+        if(now < m_nextCleanup) {
+            return;
+        }
+        m_nextCleanup = now + m_cleanupInterval;
+
+        for(auto it = m_revokedTokens.begin(); it != m_revokedTokens.end(); )
+        {
+            if(it->second <= now)
+            {
+                expiredIds.push_back(it->first);
+                it = m_revokedTokens.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+
+        for(auto it = m_revokedUsers.begin(); it != m_revokedUsers.end(); )
+        {
+            if(it->second / 1000000 + m_maxTokenLifetime <= now)
+            {
+                expiredIds.push_back(it->first);
+                it = m_revokedUsers.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+
+        if(expiredIds.size() == 0) {
+            return;
+        }
+
+        // bits can not be removed from a bloom-filter, so it is rebuilt and replaced. The old
+        // filter is deleted by the last reader, which still holds it.
+        const std::shared_ptr<BloomFilter> newFilter =
+                std::make_shared<BloomFilter>(m_numberOfFilterBits);
+        for(const auto &entry : m_revokedTokens) {
+            addToFilter(newFilter.get(), entry.first);
+        }
+        for(const auto &entry : m_revokedUsers) {
+            addToFilter(newFilter.get(), entry.first);
+        }
+        std::atomic_store(&m_filter, newFilter);
+    }
+
+    for(const std::string &id : expiredIds)
+    {
+        if(m_revocationsTable->deleteRevocation(id, error) == false) {
+            LOG_ERROR(error);
+        }
+    }
+}
+
+/**
+ * @brief get number of revoked single tokens
+ */
+uint64_t
+RevocationList::getNumberOfRevokedTokens()
+{
+    std::shared_lock<std::shared_mutex> guard(m_lock);
+    return m_revokedTokens.size();
+}
+
+/**
+ * @brief get number of users, whose tokens were revoked
+ */
+uint64_t
+RevocationList::getNumberOfRevokedUsers()
+{
+    std::shared_lock<std::shared_mutex> guard(m_lock);
+    return m_revokedUsers.size();
+}
+
+/**
+ * @brief get number of checks, which passed the bloom-filter and had to check the exact sets
+ */
+uint64_t
+RevocationList::getNumberOfFilterHits() const
+{
+    return m_filterHits;
+}
+
+/**
+ * @brief get number of requests with revoked tokens
+ */
+uint64_t
+RevocationList::getNumberOfRevokedRequests() const
+{
+    return m_revokedRequests;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file        revocation_list.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_REVOCATION_LIST_H
+#define MISAKIGUARD_REVOCATION_LIST_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <libKitsunemimiCommon/logger.h>
+
+#include <core/token_claims.h>
+
+class RevocationsTable;
+
+class RevocationList
+{
+public:
+    RevocationList(RevocationsTable* revocationsTable,
+                   const uint32_t maxTokenLifetime,
+                   const uint64_t numberOfFilterBits = 1 << 20);
+    ~RevocationList();
+
+    bool loadRevocations(Kitsunemimi::ErrorContainer &error);
+
+    bool revokeToken(const std::string &tokenId,
+                     const int64_t expiresAt,
+                     Kitsunemimi::ErrorContainer &error);
+    bool revokeUser(const std::string &userId,
+                    Kitsunemimi::ErrorContainer &error);
+
+    bool isRevoked(const TokenClaims &claims);
+
+    uint64_t getNumberOfRevokedTokens();
+    uint64_t getNumberOfRevokedUsers();
+    uint64_t getNumberOfFilterHits() const;
+    uint64_t getNumberOfRevokedRequests() const;
+
+private:
+    struct BloomFilter
+    {
+        std::atomic<uint64_t>* words = nullptr;
+        uint64_t numberOfBits = 0;
+
+        BloomFilter(const uint64_t numberOfBits);
+        ~BloomFilter();
+    };
+
+    // number of bits, which are set within the bloom-filter for each entry
+    const uint32_t m_numberOfHashes = 4;
+    // interval in seconds to remove expired revocations
+    const int64_t m_cleanupInterval = 60;
+
+    RevocationsTable* m_revocationsTable = nullptr;
+    uint32_t m_maxTokenLifetime = 0;
+    uint64_t m_numberOfFilterBits = 0;
+
+    // replaced filters are deleted, when the last reader has released them
+    std::shared_ptr<BloomFilter> m_filter;
+
+    std::shared_mutex m_lock;
+    // token-id -> timestamp, when the token expires
+    std::unordered_map<std::string, int64_t> m_revokedTokens;
+    // user-id -> all tokens of the user, which were issued at or before this timestamp in
+    //            micro-seconds
+    std::unordered_map<std::string, int64_t> m_revokedUsers;
+    int64_t m_nextCleanup = 0;
+
+    std::atomic<uint64_t> m_filterHits;
+    std::atomic<uint64_t> m_revokedRequests;
+
+    void addToFilter(BloomFilter* filter, const std::string &key);
+    bool checkFilter(const BloomFilter* filter, const std::string &key) const;
+    void removeExpired(Kitsunemimi::ErrorContainer &error);
+    int64_t getCurrentTime() const;
+    int64_t getCurrentTimeMicros() const;
+};
+
+#endif // MISAKIGUARD_REVOCATION_LIST_H
@@ -0,0 +1,332 @@
+/**
+ * @file        session_handler.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "session_handler.h"
+
+#include <chrono>
+
+#include <cryptopp/osrng.h>
+#include <cryptopp/sha.h>
+
+#include <libKitsunemimiJson/json_item.h>
+
+#include <database/sessions_table.h>
+#include <core/base64url.h>
+
+/**
+ * @brief constructor
+ *
+ * @param sessionsTable pointer to the database-table with the sessions
+ * @param sessionLifetime time in seconds, for which a refresh-token is valid
+ */
+SessionHandler::SessionHandler(SessionsTable* sessionsTable,
+                               const uint32_t sessionLifetime)
+{
+    m_sessionsTable = sessionsTable;
+    m_sessionLifetime = sessionLifetime;
+    m_abort = false;
+    m_createdSessions = 0;
+    m_refreshes = 0;
+}
+
+/**
+ * @brief destructor
+ */
+SessionHandler::~SessionHandler()
+{
+    if(m_cleanupThread != nullptr)
+    {
+        m_abort = true;
+        m_cleanupThread->join();
+        delete m_cleanupThread;
+    }
+}
+
+/**
+ * @brief get current time in seconds
+ */
+int64_t
+SessionHandler::getCurrentTime() const
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief hash a refresh-token, so the token itself is never written into the database
+ *
+ * @param tokenHash reference for the base64url-encoded hash
+ * @param refreshToken refresh-token to hash
+ */
+void
+SessionHandler::hashRefreshToken(std::string &tokenHash,
+                                 const std::string &refreshToken) const
+{
+    uint8_t hash[CryptoPP::SHA256::DIGESTSIZE];
+    CryptoPP::SHA256().CalculateDigest(hash,
+                                       reinterpret_cast<const uint8_t*>(refreshToken.c_str()),
+                                       refreshToken.size());
+
+    tokenHash.clear();
+    encodeBase64Url(tokenHash, hash, CryptoPP::SHA256::DIGESTSIZE);
+}
+
+/**
+ * @brief create a new session with a random opaque refresh-token
+ *
+ * @param refreshToken reference for the new refresh-token
+ * @param userId id of the user of the session
+ * @param projectId id of the project, which is used for the refreshed tokens
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SessionHandler::createSession(std::string &refreshToken,
+                              const std::string &userId,
+                              const std::string &projectId,
+                              Kitsunemimi::ErrorContainer &error)
+{
+    const int64_t expiresAt = getCurrentTime() + m_sessionLifetime;
+    if(addSession(refreshToken, userId, projectId, expiresAt, error) == false) {
+        return false;
+    }
+
+    m_createdSessions++;
+
+    return true;
+}
+
+/**
+ * @brief add a new session with a random opaque refresh-token to the database
+ *
+ * @param refreshToken reference for the new refresh-token
+ * @param userId id of the user of the session
+ * @param projectId id of the project, which is used for the refreshed tokens
+ * @param expiresAt timestamp, after which the refresh-token is not valid anymore
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SessionHandler::addSession(std::string &refreshToken,
+                           const std::string &userId,
+                           const std::string &projectId,
+                           const int64_t expiresAt,
+                           Kitsunemimi::ErrorContainer &error)
+{
+    // the random-pool is not thread-safe, so each thread uses its own
+    thread_local CryptoPP::AutoSeededRandomPool randomPool;
+    uint8_t randomBytes[REFRESH_TOKEN_SIZE];
+    randomPool.GenerateBlock(randomBytes, REFRESH_TOKEN_SIZE);
+
+    refreshToken.clear();
+    encodeBase64Url(refreshToken, randomBytes, REFRESH_TOKEN_SIZE);
+
+    std::string tokenHash;
+    hashRefreshToken(tokenHash, refreshToken);
+
+    if(m_sessionsTable->addSession(tokenHash, userId, projectId, expiresAt, error) == false)
+    {
+        error.addMeesage("Failed to create new session for user with id '" + userId + "'");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get the user and project of a session by its refresh-token
+ *
+ * @param userId reference for the id of the user of the session
+ * @param projectId reference for the id of the project of the session
+ * @param expiresAt reference for the timestamp, after which the session is not valid anymore
+ * @param refreshToken refresh-token of the session
+ * @param error reference for error-output
+ *
+ * @return true, if the session exists and is not expired, else false
+ */
+bool
+SessionHandler::getSession(std::string &userId,
+                           std::string &projectId,
+                           int64_t &expiresAt,
+                           const std::string &refreshToken,
+                           Kitsunemimi::ErrorContainer &error)
+{
+    std::string tokenHash;
+    hashRefreshToken(tokenHash, refreshToken);
+
+    Kitsunemimi::JsonItem session;
+    if(m_sessionsTable->getSession(session, tokenHash, error) == false) {
+        return false;
+    }
+
+    // expired sessions are rejected, even if the cleanup has not removed them so far
+    expiresAt = session.get("expires_at").getLong();
+    if(expiresAt < getCurrentTime())
+    {
+        error.addMeesage("Session is expired");
+        return false;
+    }
+
+    userId = session.get("user_id").getString();
+    projectId = session.get("project_id").getString();
+
+    return true;
+}
+
+/**
+ * @brief replace the refresh-token of a session by a new one after it was used. The new session
+ *        keeps the expiration of the old one, so the rotation doesn't extend the session.
+ *
+ * @param newRefreshToken reference for the new refresh-token
+ * @param refreshToken used refresh-token of the session
+ * @param userId id of the user of the session
+ * @param projectId id of the project of the session
+ * @param expiresAt timestamp, after which the session is not valid anymore
+ * @param error reference for error-output
+ *
+ * @return false, if the refresh-token was already used by another request or the rotation
+ *         failed, else true
+ */
+bool
+SessionHandler::rotateSession(std::string &newRefreshToken,
+                              const std::string &refreshToken,
+                              const std::string &userId,
+                              const std::string &projectId,
+                              const int64_t expiresAt,
+                              Kitsunemimi::ErrorContainer &error)
+{
+    // only the request, which deleted the old session, is allowed to create the new one, so
+    // a refresh-token can not be used twice by parallel requests
+    bool deleted = false;
+    if(deleteSession(deleted, refreshToken, error) == false) {
+        return false;
+    }
+
+    if(deleted == false)
+    {
+        error.addMeesage("Refresh-token was already used");
+        return false;
+    }
+
+    if(addSession(newRefreshToken, userId, projectId, expiresAt, error) == false) {
+        return false;
+    }
+
+    m_refreshes++;
+
+    return true;
+}
+
+/**
+ * @brief delete a session, so its refresh-token is not usable anymore
+ *
+ * @param deleted reference for the result, false, if the session didn't exist
+ * @param refreshToken refresh-token of the session
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SessionHandler::deleteSession(bool &deleted,
+                              const std::string &refreshToken,
+                              Kitsunemimi::ErrorContainer &error)
+{
+    std::string tokenHash;
+    hashRefreshToken(tokenHash, refreshToken);
+
+    return m_sessionsTable->deleteSession(deleted, tokenHash, error);
+}
+
+/**
+ * @brief delete all sessions of a user, so its refresh-tokens are not usable anymore
+ *
+ * @param userId id of the user
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SessionHandler::deleteSessionsOfUser(const std::string &userId,
+                                     Kitsunemimi::ErrorContainer &error)
+{
+    return m_sessionsTable->deleteSessionsOfUser(userId, error);
+}
+
+/**
+ * @brief start thread, which removes expired sessions from the database in an interval
+ *
+ * @param cleanupInterval interval in seconds
+ */
+void
+SessionHandler::startCleanupThread(const uint32_t cleanupInterval)
+{
+    if(m_cleanupThread != nullptr) {
+        return;
+    }
+
+    m_cleanupThread = new std::thread(&SessionHandler::cleanupLoop, this, cleanupInterval);
+}
+
+/**
+ * @brief loop of the cleanup-thread
+ *
+ * @param cleanupInterval interval in seconds
+ */
+void
+SessionHandler::cleanupLoop(const uint32_t cleanupInterval)
+{
+    uint32_t counter = 0;
+    while(m_abort == false)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        counter++;
+        if(counter < cleanupInterval) {
+            continue;
+        }
+        counter = 0;
+
+        Kitsunemimi::ErrorContainer error;
+        if(m_sessionsTable->deleteExpiredSessions(getCurrentTime(), error) == false) {
+            LOG_ERROR(error);
+        }
+    }
+}
+
+/**
+ * @brief get number of sessions, which were created since the start
+ */
+uint64_t
+SessionHandler::getNumberOfCreatedSessions() const
+{
+    return m_createdSessions;
+}
+
+/**
+ * @brief get number of successful refreshes since the start
+ */
+uint64_t
+SessionHandler::getNumberOfRefreshes() const
+{
+    return m_refreshes;
+}
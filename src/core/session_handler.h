@@ -0,0 +1,90 @@
+/**
+ * @file        session_handler.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_SESSION_HANDLER_H
+#define MISAKIGUARD_SESSION_HANDLER_H
+
+#include <string>
+#include <atomic>
+#include <thread>
+
+#include <libKitsunemimiCommon/logger.h>
+
+class SessionsTable;
+
+class SessionHandler
+{
+public:
+    SessionHandler(SessionsTable* sessionsTable,
+                   const uint32_t sessionLifetime);
+    ~SessionHandler();
+
+    bool createSession(std::string &refreshToken,
+                       const std::string &userId,
+                       const std::string &projectId,
+                       Kitsunemimi::ErrorContainer &error);
+    bool getSession(std::string &userId,
+                    std::string &projectId,
+                    int64_t &expiresAt,
+                    const std::string &refreshToken,
+                    Kitsunemimi::ErrorContainer &error);
+    bool rotateSession(std::string &newRefreshToken,
+                       const std::string &refreshToken,
+                       const std::string &userId,
+                       const std::string &projectId,
+                       const int64_t expiresAt,
+                       Kitsunemimi::ErrorContainer &error);
+    bool deleteSession(bool &deleted,
+                       const std::string &refreshToken,
+                       Kitsunemimi::ErrorContainer &error);
+    bool deleteSessionsOfUser(const std::string &userId,
+                              Kitsunemimi::ErrorContainer &error);
+
+    void startCleanupThread(const uint32_t cleanupInterval);
+
+    uint64_t getNumberOfCreatedSessions() const;
+    uint64_t getNumberOfRefreshes() const;
+
+private:
+    // number of random bytes of a refresh-token
+    static const uint32_t REFRESH_TOKEN_SIZE = 32;
+
+    SessionsTable* m_sessionsTable = nullptr;
+    uint32_t m_sessionLifetime = 0;
+
+    std::thread* m_cleanupThread = nullptr;
+    std::atomic<bool> m_abort;
+    std::atomic<uint64_t> m_createdSessions;
+    std::atomic<uint64_t> m_refreshes;
+
+    void hashRefreshToken(std::string &tokenHash,
+                          const std::string &refreshToken) const;
+    bool addSession(std::string &refreshToken,
+                    const std::string &userId,
+                    const std::string &projectId,
+                    const int64_t expiresAt,
+                    Kitsunemimi::ErrorContainer &error);
+    int64_t getCurrentTime() const;
+    void cleanupLoop(const uint32_t cleanupInterval);
+};
+
+#endif // MISAKIGUARD_SESSION_HANDLER_H
@@ -0,0 +1,258 @@
+/**
+ * @file        token_cache.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "token_cache.h"
+
+#include <chrono>
+#include <string_view>
+
+/**
+ * @brief constructor
+ *
+ * @param maxNumberOfEntries maximum number of tokens, which can be cached at the same time
+ * @param numberOfShards number of independent locked parts of the cache
+ */
+TokenCache::TokenCache(const uint64_t maxNumberOfEntries,
+                       const uint32_t numberOfShards)
+{
+    m_numberOfShards = numberOfShards;
+    if(m_numberOfShards == 0) {
+        m_numberOfShards = 1;
+    }
+
+    m_maxEntriesPerShard = maxNumberOfEntries / m_numberOfShards;
+    if(m_maxEntriesPerShard == 0) {
+        m_maxEntriesPerShard = 1;
+    }
+
+    m_shards = new CacheShard[m_numberOfShards];
+
+    m_generation = 0;
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+}
+
+/**
+ * @brief destructor
+ */
+TokenCache::~TokenCache()
+{
+    delete[] m_shards;
+}
+
+/**
+ * @brief get key of a token based on its signature
+ *
+ * @param token jwt-token
+ *
+ * @return hash of the signature-part of the token
+ */
+uint64_t
+TokenCache::getKey(const std::string &token) const
+{
+    const std::string_view tokenView(token);
+    const size_t pos = tokenView.rfind('.');
+    if(pos == std::string_view::npos) {
+        return std::hash<std::string_view>{}(tokenView);
+    }
+
+    return std::hash<std::string_view>{}(tokenView.substr(pos + 1));
+}
+
+/**
+ * @brief get claims of an already validated token
+ *
+ * @param result reference for the cached claims of the token
+ * @param token jwt-token to search for
+ *
+ * @return true, if token was found and is not expired, else false
+ */
+bool
+TokenCache::get(TokenClaims &result,
+                const std::string &token)
+{
+    const uint64_t key = getKey(token);
+    CacheShard* shard = &m_shards[key % m_numberOfShards];
+    const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                            std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    auto it = shard->entries.find(key);
+    if(it == shard->entries.end())
+    {
+        m_misses++;
+        return false;
+    }
+
+    // compare complete token, because the key is only based on the signature
+    std::list<CacheEntry>::iterator entry = it->second;
+    if(entry->token != token)
+    {
+        m_misses++;
+        return false;
+    }
+
+    // remove entry, if token is expired
+    if(now >= entry->claims.exp)
+    {
+        shard->lruList.erase(entry);
+        shard->entries.erase(it);
+        m_evictions++;
+        m_misses++;
+        return false;
+    }
+
+    // token not valid yet
+    if(now < entry->claims.nbf)
+    {
+        m_misses++;
+        return false;
+    }
+
+    // move entry to the front of the lru-list
+    shard->lruList.splice(shard->lruList.begin(), shard->lruList, entry);
+    result = entry->claims;
+    m_hits++;
+
+    return true;
+}
+
+/**
+ * @brief get the current generation of the cache. This has to be requested before a token is
+ *        validated, so a clear of the cache during the validation can be detected by add.
+ *
+ * @return current generation
+ */
+uint64_t
+TokenCache::getGeneration() const
+{
+    return m_generation;
+}
+
+/**
+ * @brief add the claims of a successfully validated token to the cache
+ *
+ * @param token validated jwt-token
+ * @param claims claims of the token
+ * @param generation generation of the cache, before the token was validated
+ */
+void
+TokenCache::add(const std::string &token,
+                const TokenClaims &claims,
+                const uint64_t generation)
+{
+    const uint64_t key = getKey(token);
+    CacheShard* shard = &m_shards[key % m_numberOfShards];
+
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    // the validation can be based on keys, which were removed by a clear in the meantime
+    if(generation != m_generation) {
+        return;
+    }
+
+    // replace old entry with the same key
+    auto it = shard->entries.find(key);
+    if(it != shard->entries.end())
+    {
+        shard->lruList.erase(it->second);
+        shard->entries.erase(it);
+    }
+
+    // remove least recently used entry, if shard is full
+    if(shard->entries.size() >= m_maxEntriesPerShard)
+    {
+        shard->entries.erase(shard->lruList.back().key);
+        shard->lruList.pop_back();
+        m_evictions++;
+    }
+
+    CacheEntry newEntry;
+    newEntry.key = key;
+    newEntry.token = token;
+    newEntry.claims = claims;
+    shard->lruList.push_front(newEntry);
+    shard->entries.emplace(key, shard->lruList.begin());
+}
+
+/**
+ * @brief remove all entries from the cache
+ */
+void
+TokenCache::clear()
+{
+    // generation is changed before the shards are cleared, so a parallel add with the old
+    // generation is either rejected or its entry is removed afterwards
+    m_generation++;
+
+    for(uint32_t i = 0; i < m_numberOfShards; i++)
+    {
+        std::lock_guard<std::mutex> guard(m_shards[i].lock);
+        m_shards[i].entries.clear();
+        m_shards[i].lruList.clear();
+    }
+}
+
+/**
+ * @brief get number of cache-hits
+ */
+uint64_t
+TokenCache::getNumberOfHits() const
+{
+    return m_hits;
+}
+
+/**
+ * @brief get number of cache-misses
+ */
+uint64_t
+TokenCache::getNumberOfMisses() const
+{
+    return m_misses;
+}
+
+/**
+ * @brief get number of entries, which were removed because of the size-limit or expiration
+ */
+uint64_t
+TokenCache::getNumberOfEvictions() const
+{
+    return m_evictions;
+}
+
+/**
+ * @brief get number of entries, which are currently in the cache
+ */
+uint64_t
+TokenCache::getNumberOfEntries()
+{
+    uint64_t result = 0;
+    for(uint32_t i = 0; i < m_numberOfShards; i++)
+    {
+        std::lock_guard<std::mutex> guard(m_shards[i].lock);
+        result += m_shards[i].entries.size();
+    }
+
+    return result;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file        token_cache.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_TOKEN_CACHE_H
+#define MISAKIGUARD_TOKEN_CACHE_H
+
+#include <string>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+#include <core/token_claims.h>
+
+class TokenCache
+{
+public:
+    TokenCache(const uint64_t maxNumberOfEntries,
+               const uint32_t numberOfShards = 16);
+    ~TokenCache();
+
+    bool get(TokenClaims &result, const std::string &token);
+    uint64_t getGeneration() const;
+    void add(const std::string &token,
+             const TokenClaims &claims,
+             const uint64_t generation);
+    void clear();
+
+    uint64_t getNumberOfHits() const;
+    uint64_t getNumberOfMisses() const;
+    uint64_t getNumberOfEvictions() const;
+    uint64_t getNumberOfEntries();
+
+private:
+    struct CacheEntry
+    {
+        uint64_t key = 0;
+        std::string token = "";
+        TokenClaims claims;
+    };
+
+    struct CacheShard
+    {
+        std::mutex lock;
+        std::list<CacheEntry> lruList;
+        std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> entries;
+    };
+
+    CacheShard* m_shards = nullptr;
+    uint32_t m_numberOfShards = 0;
+    uint64_t m_maxEntriesPerShard = 0;
+
+    // changed by each clear, so tokens, which were validated before, are not added afterwards
+    std::atomic<uint64_t> m_generation;
+
+    std::atomic<uint64_t> m_hits;
+    std::atomic<uint64_t> m_misses;
+    std::atomic<uint64_t> m_evictions;
+
+    uint64_t getKey(const std::string &token) const;
+};
+
+#endif // MISAKIGUARD_TOKEN_CACHE_H
@@ -0,0 +1,51 @@
+/**
+ * @file        token_claims.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_TOKEN_CLAIMS_H
+#define MISAKIGUARD_TOKEN_CLAIMS_H
+
+#include <string>
+#include <stdint.h>
+
+/**
+ * @brief claims of a user-token, which are relevant for misaki and returned by the validation
+ */
+struct TokenClaims
+{
+    std::string id = "";
+    std::string name = "";
+    bool isAdmin = false;
+    std::string projectId = "";
+    std::string role = "";
+    bool isProjectAdmin = false;
+    std::string tokenId = "";
+    int64_t iat = 0;
+    // creation-time in micro-seconds, because the revocation of all tokens of a user must not
+    // hit the tokens, which are created within the same second after the revocation
+    int64_t iatMicros = 0;
+    int64_t nbf = 0;
+    int64_t exp = 0;
+    std::string memberships = "";
+    int64_t membershipVersion = 0;
+};
+
+#endif // MISAKIGUARD_TOKEN_CLAIMS_H
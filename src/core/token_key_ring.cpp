@@ -0,0 +1,391 @@
+/**
+ * @file        token_key_ring.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "token_key_ring.h"
+
+#include <chrono>
+#include <algorithm>
+
+#include <cryptopp/secblock.h>
+#include <cryptopp/sha.h>
+
+#include <libKitsunemimiCommon/files/text_file.h>
+#include <libKitsunemimiCommon/methods/file_methods.h>
+
+#include <core/hmac_key.h>
+#include <core/ed25519_key.h>
+#include <core/base64url.h>
+#include <core/token_cache.h>
+
+/**
+ * @brief destructor of the key-set
+ */
+TokenKeySet::~TokenKeySet()
+{
+    for(TokenKey &tokenKey : keys) {
+        delete tokenKey.key;
+    }
+}
+
+/**
+ * @brief get a key of the set by its id
+ *
+ * @param keyId id of the requested key
+ *
+ * @return pointer to the key, if found, else nullptr
+ */
+const TokenKey*
+TokenKeySet::getKey(const std::string &keyId) const
+{
+    for(const TokenKey &tokenKey : keys)
+    {
+        if(tokenKey.keyId == keyId) {
+            return &tokenKey;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief constructor
+ *
+ * @param keyPath path to a single key-file or to a directory with key-files
+ * @param isDirectory true, if the path is a directory
+ * @param numberOfPreviousKeys number of previous keys, which are still accepted for verification
+ */
+TokenKeyRing::TokenKeyRing(const std::string &keyPath,
+                           const bool isDirectory,
+                           const uint32_t numberOfPreviousKeys)
+{
+    m_keyPath = keyPath;
+    m_isDirectory = isDirectory;
+    m_numberOfPreviousKeys = numberOfPreviousKeys;
+
+    m_tokenCache = nullptr;
+    m_abort = false;
+    m_rotations = 0;
+}
+
+/**
+ * @brief destructor
+ */
+TokenKeyRing::~TokenKeyRing()
+{
+    if(m_reloadThread != nullptr)
+    {
+        m_abort = true;
+        m_reloadThread->join();
+        delete m_reloadThread;
+    }
+}
+
+/**
+ * @brief set cache of the validated tokens, which has to be cleared, when the keys are replaced
+ *
+ * @param tokenCache pointer to the token-cache
+ */
+void
+TokenKeyRing::setTokenCache(TokenCache* tokenCache)
+{
+    m_tokenCache = tokenCache;
+}
+
+/**
+ * @brief add a key to verify EdDSA-tokens. Multiple keys can be added to accept the tokens of
+ *        a previous key after a rotation. This must only be called at the initialization.
+ *
+ * @param key key to add, which must exist as long as the key-ring
+ */
+void
+TokenKeyRing::addEd25519Key(const Ed25519Key* key)
+{
+    m_ed25519Keys.push_back(key);
+}
+
+/**
+ * @brief get a key to verify EdDSA-tokens by its key-id
+ *
+ * @param keyId id of the requested key
+ *
+ * @return pointer to the key, if found, else nullptr
+ */
+const Ed25519Key*
+TokenKeyRing::getEd25519Key(const std::string &keyId) const
+{
+    for(const Ed25519Key* key : m_ed25519Keys)
+    {
+        if(key->getKeyId() == keyId) {
+            return key;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief get all keys to verify EdDSA-tokens, for example to publish their public keys
+ */
+const std::vector<const Ed25519Key*>&
+TokenKeyRing::getEd25519Keys() const
+{
+    return m_ed25519Keys;
+}
+
+/**
+ * @brief get paths of the key-files, which should be used, where the newest is the first
+ *
+ * @param keyFiles reference for the resulting file-paths
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+TokenKeyRing::getKeyFiles(std::vector<std::string> &keyFiles,
+                          Kitsunemimi::ErrorContainer &error)
+{
+    keyFiles.clear();
+
+    if(m_isDirectory == false)
+    {
+        keyFiles.push_back(m_keyPath);
+        return true;
+    }
+
+    if(Kitsunemimi::listFiles(keyFiles, m_keyPath, false) == false)
+    {
+        error.addMeesage("Failed to list key-files in directory '" + m_keyPath + "'");
+        return false;
+    }
+    if(keyFiles.size() == 0)
+    {
+        error.addMeesage("No key-files found in directory '" + m_keyPath + "'");
+        return false;
+    }
+
+    // key-files are ordered by their names, so the name of a new key must be greater than the
+    // names of the old keys (for example a timestamp)
+    std::sort(keyFiles.begin(), keyFiles.end(), std::greater<std::string>());
+    if(keyFiles.size() > m_numberOfPreviousKeys + 1) {
+        keyFiles.resize(m_numberOfPreviousKeys + 1);
+    }
+
+    return true;
+}
+
+/**
+ * @brief create a key from a key-file
+ *
+ * @param tokenKey reference for the new key
+ * @param keyFilePath path to the file with the secret key
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+TokenKeyRing::createKey(TokenKey &tokenKey,
+                        const std::string &keyFilePath,
+                        Kitsunemimi::ErrorContainer &error)
+{
+    std::string keyString;
+    if(Kitsunemimi::readFile(keyString, keyFilePath, error) == false)
+    {
+        error.addMeesage("Failed to read token-file '" + keyFilePath + "'");
+        return false;
+    }
+    if(keyString.size() == 0)
+    {
+        error.addMeesage("Token-file '" + keyFilePath + "' is empty");
+        return false;
+    }
+
+    CryptoPP::SecByteBlock keyBlock((unsigned char*)keyString.c_str(), keyString.size());
+    tokenKey.key = new HmacKey(keyBlock);
+
+    // key-id is derived with the key itself, so it doesn't leak anything about the secret
+    const std::string keyIdInput = "misaki-key-id";
+    uint8_t mac[CryptoPP::SHA256::DIGESTSIZE];
+    tokenKey.key->calculateMac(mac, keyIdInput.c_str(), keyIdInput.size());
+    encodeBase64Url(tokenKey.keyId, mac, 12);
+
+    const std::string header = "{\"alg\":\"HS256\",\"typ\":\"JWT\",\"kid\":\""
+                               + tokenKey.keyId
+                               + "\"}";
+    encodeBase64Url(tokenKey.encodedHeader, header.c_str(), header.size());
+
+    return true;
+}
+
+/**
+ * @brief load the keys and swap the active key-set, if the keys have changed
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+TokenKeyRing::loadKeys(Kitsunemimi::ErrorContainer &error)
+{
+    std::lock_guard<std::mutex> guard(m_reloadLock);
+
+    std::vector<std::string> keyFiles;
+    if(getKeyFiles(keyFiles, error) == false) {
+        return false;
+    }
+
+    // create new key-set
+    TokenKeySet* newKeySet = new TokenKeySet();
+    for(const std::string &keyFile : keyFiles)
+    {
+        newKeySet->keys.emplace_back();
+        if(createKey(newKeySet->keys.back(), keyFile, error) == false)
+        {
+            delete newKeySet;
+            return false;
+        }
+    }
+
+    // keep old set, if nothing has changed
+    const std::shared_ptr<const TokenKeySet> oldKeySet = getKeySet();
+    if(oldKeySet != nullptr
+            && oldKeySet->keys.size() == newKeySet->keys.size())
+    {
+        bool changed = false;
+        for(uint64_t i = 0; i < newKeySet->keys.size(); i++) {
+            changed |= oldKeySet->keys[i].keyId != newKeySet->keys[i].keyId;
+        }
+
+        if(changed == false)
+        {
+            delete newKeySet;
+            return true;
+        }
+    }
+
+    // the key-id is derived from the secret, so a key with the same id is still the same key
+    bool keyRemoved = false;
+    if(oldKeySet != nullptr)
+    {
+        for(const TokenKey &oldKey : oldKeySet->keys) {
+            keyRemoved |= newKeySet->getKey(oldKey.keyId) == nullptr;
+        }
+    }
+
+    // swap active set without blocking the validations. The old set is deleted by the
+    // shared-pointer, after the last running validation has released it.
+    const std::string newKeyId = newKeySet->keys[0].keyId;
+    std::atomic_store(&m_keySet, std::shared_ptr<const TokenKeySet>(newKeySet));
+    if(oldKeySet != nullptr)
+    {
+        // tokens, which were validated with a removed key, must not be accepted anymore. If
+        // only a new key was added, the cached tokens are still valid.
+        TokenCache* tokenCache = m_tokenCache.load();
+        if(keyRemoved
+                && tokenCache != nullptr)
+        {
+            tokenCache->clear();
+        }
+
+        m_rotations++;
+        LOG_INFO("switched to new token-key with id '" + newKeyId + "'");
+    }
+
+    return true;
+}
+
+/**
+ * @brief start thread, which reloads the keys from the key-directory in an interval
+ *
+ * @param reloadInterval interval in seconds
+ */
+void
+TokenKeyRing::startReloadThread(const uint32_t reloadInterval)
+{
+    if(m_isDirectory == false
+            || m_reloadThread != nullptr)
+    {
+        return;
+    }
+
+    m_reloadThread = new std::thread(&TokenKeyRing::reloadLoop, this, reloadInterval);
+}
+
+/**
+ * @brief loop of the reload-thread
+ *
+ * @param reloadInterval interval in seconds
+ */
+void
+TokenKeyRing::reloadLoop(const uint32_t reloadInterval)
+{
+    uint32_t counter = 0;
+    while(m_abort == false)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        counter++;
+        if(counter < reloadInterval) {
+            continue;
+        }
+        counter = 0;
+
+        // in case of an error, the old keys are still used
+        Kitsunemimi::ErrorContainer error;
+        if(loadKeys(error) == false)
+        {
+            error.addMeesage("Failed to reload token-keys from '" + m_keyPath + "'");
+            LOG_ERROR(error);
+        }
+    }
+}
+
+/**
+ * @brief get the current key-set. The returned set stays valid as long as the returned
+ *        shared-pointer is hold, even when the keys are replaced in the meantime.
+ */
+std::shared_ptr<const TokenKeySet>
+TokenKeyRing::getKeySet() const
+{
+    return std::atomic_load(&m_keySet);
+}
+
+/**
+ * @brief get number of keys in the current key-set
+ */
+uint64_t
+TokenKeyRing::getNumberOfKeys() const
+{
+    const std::shared_ptr<const TokenKeySet> keySet = getKeySet();
+    if(keySet == nullptr) {
+        return 0;
+    }
+
+    return keySet->keys.size();
+}
+
+/**
+ * @brief get number of key-rotations since the start
+ */
+uint64_t
+TokenKeyRing::getNumberOfRotations() const
+{
+    return m_rotations;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file        token_key_ring.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_TOKEN_KEY_RING_H
+#define MISAKIGUARD_TOKEN_KEY_RING_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <libKitsunemimiCommon/logger.h>
+
+class HmacKey;
+class TokenCache;
+class Ed25519Key;
+
+/**
+ * @brief key to sign and verify HS256-tokens together with its key-id and the pre-encoded
+ *        token-header, which contains the key-id
+ */
+struct TokenKey
+{
+    HmacKey* key = nullptr;
+    std::string keyId = "";
+    std::string encodedHeader = "";
+};
+
+/**
+ * @brief immutable set of keys, where the first one is the current key to sign new tokens and
+ *        the others are previous keys, which are only used to verify older tokens
+ */
+struct TokenKeySet
+{
+    std::vector<TokenKey> keys;
+
+    ~TokenKeySet();
+    const TokenKey* getKey(const std::string &keyId) const;
+};
+
+class TokenKeyRing
+{
+public:
+    TokenKeyRing(const std::string &keyPath,
+                 const bool isDirectory,
+                 const uint32_t numberOfPreviousKeys);
+    ~TokenKeyRing();
+
+    bool loadKeys(Kitsunemimi::ErrorContainer &error);
+    void startReloadThread(const uint32_t reloadInterval);
+    void setTokenCache(TokenCache* tokenCache);
+    void addEd25519Key(const Ed25519Key* key);
+
+    std::shared_ptr<const TokenKeySet> getKeySet() const;
+    const Ed25519Key* getEd25519Key(const std::string &keyId) const;
+    const std::vector<const Ed25519Key*>& getEd25519Keys() const;
+
+    uint64_t getNumberOfKeys() const;
+    uint64_t getNumberOfRotations() const;
+
+private:
+    std::string m_keyPath = "";
+    bool m_isDirectory = false;
+    uint32_t m_numberOfPreviousKeys = 0;
+
+    // only accessed with std::atomic_load and std::atomic_store, so a replaced key-set is
+    // deleted, when the last validation, which uses it, has released it
+    std::shared_ptr<const TokenKeySet> m_keySet;
+    std::mutex m_reloadLock;
+    std::atomic<TokenCache*> m_tokenCache;
+
+    // keys to verify EdDSA-tokens, where the first one is the current key. They are only added
+    // at the initialization, before any token is verified.
+    std::vector<const Ed25519Key*> m_ed25519Keys;
+
+    std::thread* m_reloadThread = nullptr;
+    std::atomic<bool> m_abort;
+    std::atomic<uint64_t> m_rotations;
+
+    bool getKeyFiles(std::vector<std::string> &keyFiles,
+                     Kitsunemimi::ErrorContainer &error);
+    bool createKey(TokenKey &tokenKey,
+                   const std::string &keyFilePath,
+                   Kitsunemimi::ErrorContainer &error);
+    void reloadLoop(const uint32_t reloadInterval);
+};
+
+#endif // MISAKIGUARD_TOKEN_KEY_RING_H
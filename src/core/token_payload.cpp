@@ -0,0 +1,94 @@
+/**
+ * @file        token_payload.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "token_payload.h"
+
+#include <misaki_root.h>
+#include <core/memberships.h>
+#include <database/users_table.h>
+
+/**
+ * @brief create the claims of a new token from the user-data of the database by selecting
+ *        one of the projects of the user
+ *
+ * @param claims reference for the claims of the new token
+ * @param userData id, name, admin-status and projects of the user coming from database
+ * @param projectId id of the project to select. If empty, the admin-project is selected for
+ *                  admins and the first project of the user for all other users.
+ * @param membershipVersion version of the memberships, which was read before the user-data
+ *
+ * @return true, if the project is available for the user, else false
+ */
+bool
+selectTokenProject(TokenClaims &claims,
+                   const UserMemberships &userData,
+                   const std::string &projectId,
+                   const int64_t membershipVersion)
+{
+    claims.id = userData.id;
+    claims.name = userData.name;
+    claims.isAdmin = userData.isAdmin;
+
+    // add all projects of the user to the token, so they can be switched without database-access
+    if(MisakiRoot::tokenMemberships)
+    {
+        Memberships::encode(claims.memberships, userData.projects, claims.isAdmin);
+        claims.membershipVersion = membershipVersion;
+    }
+
+    // admin user get alway the admin-project per default and normal user get assigned to
+    // first project in their project-list
+    std::string selectedProjectId = projectId;
+    if(selectedProjectId == "")
+    {
+        if(claims.isAdmin) {
+            selectedProjectId = "admin";
+        } else if(userData.projects.size() != 0) {
+            selectedProjectId = userData.projects[0].projectId;
+        } else {
+            return false;
+        }
+    }
+
+    for(const CachedProject &project : userData.projects)
+    {
+        if(project.projectId == selectedProjectId)
+        {
+            claims.projectId = selectedProjectId;
+            claims.role = project.role;
+            claims.isProjectAdmin = project.isProjectAdmin;
+            return true;
+        }
+    }
+
+    // global admins are always member of the admin-project
+    if(claims.isAdmin
+            && selectedProjectId == "admin")
+    {
+        claims.projectId = "admin";
+        claims.role = "admin";
+        claims.isProjectAdmin = true;
+        return true;
+    }
+
+    return false;
+}
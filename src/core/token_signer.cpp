@@ -0,0 +1,199 @@
+/**
+ * @file        token_signer.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "token_signer.h"
+
+#include <chrono>
+
+#include <cryptopp/sha.h>
+
+#include <libKitsunemimiJson/json_item.h>
+#include <libKitsunemimiHanamiCommon/uuid.h>
+
+#include <core/hmac_key.h>
+#include <core/token_key_ring.h>
+#include <core/ed25519_key.h>
+#include <core/base64url.h>
+#include <core/json_writer.h>
+
+/**
+ * @brief constructor to create HS256-signed tokens with the current key of a key-ring
+ *
+ * @param keyRing key-ring with the keys to sign the tokens
+ */
+TokenSigner::TokenSigner(const TokenKeyRing* keyRing)
+{
+    m_keyRing = keyRing;
+}
+
+/**
+ * @brief constructor to create EdDSA-signed tokens, which can be verified by other components
+ *        with the published public key
+ *
+ * @param signingKey key to sign the tokens
+ */
+TokenSigner::TokenSigner(const Ed25519Key* signingKey)
+{
+    m_ed25519Key = signingKey;
+
+    // header is the same for all tokens, so it is encoded only once
+    const std::string header = "{\"alg\":\"EdDSA\",\"typ\":\"JWT\",\"kid\":\""
+                               + signingKey->getKeyId()
+                               + "\"}";
+    encodeBase64Url(m_encodedHeader, header.c_str(), header.size());
+}
+
+/**
+ * @brief destructor
+ */
+TokenSigner::~TokenSigner() {}
+
+/**
+ * @brief create a new signed jwt-token
+ *
+ * @param result reference for the new token
+ * @param payload payload of the token, which is extended by the token-id and the timestamps
+ * @param validSeconds number of seconds, until the token expires
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+TokenSigner::createToken(std::string &result,
+                         Kitsunemimi::JsonItem &payload,
+                         const uint32_t validSeconds,
+                         Kitsunemimi::ErrorContainer &error) const
+{
+    const long now = std::chrono::duration_cast<std::chrono::seconds>(
+                         std::chrono::system_clock::now().time_since_epoch()).count();
+
+    // add unique id, which allows to revoke this single token
+    payload.insert("jti", Kitsunemimi::Hanami::generateUuid().toString(), true);
+
+    // add timestamps to the payload
+    payload.insert("iat", now, true);
+    payload.insert("nbf", now, true);
+    payload.insert("exp", now + static_cast<long>(validSeconds), true);
+
+    const std::string payloadString = payload.toString();
+    if(payloadString.size() == 0)
+    {
+        error.addMeesage("Failed to convert payload of the token");
+        return false;
+    }
+
+    signPayload(result, payloadString.c_str(), payloadString.size());
+
+    return true;
+}
+
+/**
+ * @brief create a new signed jwt-token for a user with a fixed layout of the claims. The
+ *        payload is written directly into a reusable buffer, so no json-object is necessary.
+ *
+ * @param result reference for the new token
+ * @param claims claims of the token, where token-id and timestamps are set by this function
+ * @param validSeconds number of seconds, until the token expires
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+TokenSigner::createToken(std::string &result,
+                         TokenClaims &claims,
+                         const uint32_t validSeconds,
+                         Kitsunemimi::ErrorContainer &error) const
+{
+    if(claims.id.size() == 0)
+    {
+        error.addMeesage("Failed to create token, because the user-id is missing");
+        return false;
+    }
+
+    const int64_t nowMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::system_clock::now().time_since_epoch()).count();
+    const long now = static_cast<long>(nowMicros / 1000000);
+
+    // add unique id, which allows to revoke this single token, and the timestamps
+    claims.tokenId = Kitsunemimi::Hanami::generateUuid().toString();
+    claims.iat = now;
+    claims.iatMicros = nowMicros;
+    claims.nbf = now;
+    claims.exp = now + static_cast<long>(validSeconds);
+
+    // buffer is reused by all tokens of a thread, so it is allocated only once per thread
+    thread_local std::string payload;
+    writeTokenPayload(payload, claims);
+
+    signPayload(result, payload.c_str(), payload.size());
+
+    return true;
+}
+
+/**
+ * @brief encode and sign a payload and write the complete token into the result
+ *
+ * @param result reference for the new token
+ * @param payload serialized payload of the token
+ * @param payloadSize size of the payload
+ */
+void
+TokenSigner::signPayload(std::string &result,
+                         const char* payload,
+                         const uint64_t payloadSize) const
+{
+    if(m_ed25519Key != nullptr)
+    {
+        // create 'header.payload'
+        result.clear();
+        result.reserve(m_encodedHeader.size() + (payloadSize * 4) / 3 + 96);
+        result.append(m_encodedHeader);
+        result.push_back('.');
+        encodeBase64Url(result, payload, payloadSize);
+
+        // sign and append signature
+        uint8_t signature[Ed25519Key::SIGNATURE_SIZE];
+        m_ed25519Key->sign(signature, result.c_str(), result.size());
+        result.push_back('.');
+        encodeBase64Url(result, signature, Ed25519Key::SIGNATURE_SIZE);
+    }
+    else
+    {
+        // the key-set is taken once, so header and signature always belong to the same key,
+        // even when the keys are rotated at the same time
+        const std::shared_ptr<const TokenKeySet> keySet = m_keyRing->getKeySet();
+        const TokenKey &currentKey = keySet->keys[0];
+
+        // create 'header.payload'
+        result.clear();
+        result.reserve(currentKey.encodedHeader.size() + (payloadSize * 4) / 3 + 48);
+        result.append(currentKey.encodedHeader);
+        result.push_back('.');
+        encodeBase64Url(result, payload, payloadSize);
+
+        // sign with a single pass over 'header.payload' and append signature
+        uint8_t mac[CryptoPP::SHA256::DIGESTSIZE];
+        currentKey.key->calculateMac(mac, result.c_str(), result.size());
+        result.push_back('.');
+        encodeBase64Url(result, mac, CryptoPP::SHA256::DIGESTSIZE);
+    }
+}
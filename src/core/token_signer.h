@@ -0,0 +1,64 @@
+/**
+ * @file        token_signer.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_TOKEN_SIGNER_H
+#define MISAKIGUARD_TOKEN_SIGNER_H
+
+#include <string>
+
+#include <libKitsunemimiCommon/logger.h>
+
+#include <core/token_claims.h>
+
+namespace Kitsunemimi {
+class JsonItem;
+}
+class TokenKeyRing;
+class Ed25519Key;
+
+class TokenSigner
+{
+public:
+    TokenSigner(const TokenKeyRing* keyRing);
+    TokenSigner(const Ed25519Key* signingKey);
+    ~TokenSigner();
+
+    bool createToken(std::string &result,
+                     Kitsunemimi::JsonItem &payload,
+                     const uint32_t validSeconds,
+                     Kitsunemimi::ErrorContainer &error) const;
+    bool createToken(std::string &result,
+                     TokenClaims &claims,
+                     const uint32_t validSeconds,
+                     Kitsunemimi::ErrorContainer &error) const;
+
+private:
+    const TokenKeyRing* m_keyRing = nullptr;
+    const Ed25519Key* m_ed25519Key = nullptr;
+    std::string m_encodedHeader = "";
+
+    void signPayload(std::string &result,
+                     const char* payload,
+                     const uint64_t payloadSize) const;
+};
+
+#endif // MISAKIGUARD_TOKEN_SIGNER_H
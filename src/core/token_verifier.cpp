@@ -0,0 +1,803 @@
+/**
+ * @file        token_verifier.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "token_verifier.h"
+
+#include <chrono>
+
+#include <cryptopp/sha.h>
+
+#include <core/base64url.h>
+#include <core/hmac_key.h>
+#include <core/token_key_ring.h>
+#include <core/ed25519_key.h>
+
+/**
+ * @brief skip whitespaces within a json-string
+ *
+ * @param pos reference to the current position, which is moved
+ * @param end end of the json-string
+ */
+static inline void
+skipWhitespaces(const char* &pos,
+                const char* end)
+{
+    while(pos < end
+          && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+    {
+        pos++;
+    }
+}
+
+/**
+ * @brief append an unicode-codepoint utf8-encoded to a string
+ *
+ * @param output reference for the output
+ * @param codepoint codepoint to append
+ */
+static void
+appendUtf8(std::string &output,
+           const uint32_t codepoint)
+{
+    if(codepoint < 0x80)
+    {
+        output.push_back(static_cast<char>(codepoint));
+    }
+    else if(codepoint < 0x800)
+    {
+        output.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+        output.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    }
+    else if(codepoint < 0x10000)
+    {
+        output.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+        output.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    }
+    else
+    {
+        output.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+        output.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        output.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    }
+}
+
+/**
+ * @brief parse the 4 hex-characters of an unicode-escape
+ *
+ * @param result reference for the resulting value
+ * @param pos reference to the current position, which is moved behind the hex-characters
+ * @param end end of the json-string
+ *
+ * @return false, if invalid, else true
+ */
+static bool
+parseHex4(uint32_t &result,
+          const char* &pos,
+          const char* end)
+{
+    if(end - pos < 4) {
+        return false;
+    }
+
+    result = 0;
+    for(uint32_t i = 0; i < 4; i++)
+    {
+        const char c = *pos;
+        result <<= 4;
+        if(c >= '0' && c <= '9') {
+            result |= c - '0';
+        } else if(c >= 'a' && c <= 'f') {
+            result |= c - 'a' + 10;
+        } else if(c >= 'A' && c <= 'F') {
+            result |= c - 'A' + 10;
+        } else {
+            return false;
+        }
+        pos++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief parse a json-string
+ *
+ * @param output reference for the unescaped string
+ * @param pos reference to the current position, which must point to the opening quote
+ * @param end end of the json-string
+ *
+ * @return false, if invalid, else true
+ */
+static bool
+parseString(std::string &output,
+            const char* &pos,
+            const char* end)
+{
+    if(pos >= end
+            || *pos != '"')
+    {
+        return false;
+    }
+    pos++;
+
+    output.clear();
+    while(pos < end)
+    {
+        const char c = *pos;
+        pos++;
+
+        if(c == '"') {
+            return true;
+        }
+
+        if(c != '\\')
+        {
+            output.push_back(c);
+            continue;
+        }
+
+        // handle escaped characters
+        if(pos >= end) {
+            return false;
+        }
+        const char escaped = *pos;
+        pos++;
+
+        switch(escaped)
+        {
+            case '"':  output.push_back('"');  break;
+            case '\\': output.push_back('\\'); break;
+            case '/':  output.push_back('/');  break;
+            case 'b':  output.push_back('\b'); break;
+            case 'f':  output.push_back('\f'); break;
+            case 'n':  output.push_back('\n'); break;
+            case 'r':  output.push_back('\r'); break;
+            case 't':  output.push_back('\t'); break;
+            case 'u':
+            {
+                uint32_t codepoint = 0;
+                if(parseHex4(codepoint, pos, end) == false) {
+                    return false;
+                }
+
+                // a low surrogate is only valid behind a high surrogate
+                if(codepoint >= 0xDC00
+                        && codepoint <= 0xDFFF)
+                {
+                    return false;
+                }
+
+                // combine surrogate-pairs
+                if(codepoint >= 0xD800
+                        && codepoint <= 0xDBFF)
+                {
+                    if(end - pos < 6
+                            || pos[0] != '\\'
+                            || pos[1] != 'u')
+                    {
+                        return false;
+                    }
+                    pos += 2;
+                    uint32_t low = 0;
+                    if(parseHex4(low, pos, end) == false
+                            || low < 0xDC00
+                            || low > 0xDFFF)
+                    {
+                        return false;
+                    }
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+
+                appendUtf8(output, codepoint);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief skip a json-value of any type, including nested objects and arrays
+ *
+ * @param pos reference to the current position, which must point to the begin of the value
+ * @param end end of the json-string
+ *
+ * @return false, if invalid, else true
+ */
+static bool
+skipValue(const char* &pos,
+          const char* end)
+{
+    uint32_t depth = 0;
+    while(pos < end)
+    {
+        const char c = *pos;
+        if(c == '"')
+        {
+            // skip string without unescaping
+            pos++;
+            while(pos < end
+                  && *pos != '"')
+            {
+                if(*pos == '\\') {
+                    pos++;
+                }
+                pos++;
+            }
+            if(pos >= end) {
+                return false;
+            }
+            pos++;
+        }
+        else if(c == '{' || c == '[')
+        {
+            depth++;
+            pos++;
+        }
+        else if(c == '}' || c == ']')
+        {
+            if(depth == 0) {
+                return true;
+            }
+            depth--;
+            pos++;
+        }
+        else if(c == ',')
+        {
+            if(depth == 0) {
+                return true;
+            }
+            pos++;
+        }
+        else
+        {
+            pos++;
+        }
+
+        if(depth == 0)
+        {
+            // end of a simple value is reached with the next separator
+            skipWhitespaces(pos, end);
+            if(pos >= end
+                    || *pos == ','
+                    || *pos == '}'
+                    || *pos == ']')
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief parse a json-integer
+ *
+ * @param result reference for the result
+ * @param pos reference to the current position, which must point to the begin of the value
+ * @param end end of the json-string
+ *
+ * @return false, if invalid or out of the range of int64_t, else true
+ */
+static bool
+parseInt(int64_t &result,
+         const char* &pos,
+         const char* end)
+{
+    bool negative = false;
+    if(pos < end
+            && *pos == '-')
+    {
+        negative = true;
+        pos++;
+    }
+
+    if(pos >= end
+            || *pos < '0'
+            || *pos > '9')
+    {
+        return false;
+    }
+
+    result = 0;
+    while(pos < end
+          && *pos >= '0'
+          && *pos <= '9')
+    {
+        const int64_t digit = *pos - '0';
+        if(result > (INT64_MAX - digit) / 10) {
+            return false;
+        }
+        result = result * 10 + digit;
+        pos++;
+    }
+
+    if(negative) {
+        result = -result;
+    }
+
+    return true;
+}
+
+/**
+ * @brief parse a json-boolean
+ *
+ * @param result reference for the result
+ * @param pos reference to the current position, which must point to the begin of the value
+ * @param end end of the json-string
+ *
+ * @return false, if invalid, else true
+ */
+static bool
+parseBool(bool &result,
+          const char* &pos,
+          const char* end)
+{
+    if(end - pos >= 4
+            && pos[0] == 't'
+            && pos[1] == 'r'
+            && pos[2] == 'u'
+            && pos[3] == 'e')
+    {
+        result = true;
+        pos += 4;
+        return true;
+    }
+
+    if(end - pos >= 5
+            && pos[0] == 'f'
+            && pos[1] == 'a'
+            && pos[2] == 'l'
+            && pos[3] == 's'
+            && pos[4] == 'e')
+    {
+        result = false;
+        pos += 5;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief scan the json-payload of a token in a single pass and only take the claims, which are
+ *        relevant for misaki, without building a complete json-tree
+ *
+ * @param claims reference for the resulting claims
+ * @param payload pointer to the decoded json-payload
+ * @param payloadSize size of the payload
+ *
+ * @return false, if payload is invalid or has no exp-claim, else true
+ */
+bool
+parseClaims(TokenClaims &claims,
+            const char* payload,
+            const uint64_t payloadSize)
+{
+    thread_local std::string key;
+
+    const char* pos = payload;
+    const char* end = payload + payloadSize;
+    bool hasExp = false;
+
+    skipWhitespaces(pos, end);
+    if(pos >= end
+            || *pos != '{')
+    {
+        return false;
+    }
+    pos++;
+
+    while(true)
+    {
+        skipWhitespaces(pos, end);
+        if(pos >= end) {
+            return false;
+        }
+        if(*pos == '}') {
+            break;
+        }
+
+        // get key
+        if(parseString(key, pos, end) == false) {
+            return false;
+        }
+        skipWhitespaces(pos, end);
+        if(pos >= end
+                || *pos != ':')
+        {
+            return false;
+        }
+        pos++;
+        skipWhitespaces(pos, end);
+
+        // get value
+        bool success = true;
+        if(key == "id") {
+            success = parseString(claims.id, pos, end);
+        } else if(key == "name") {
+            success = parseString(claims.name, pos, end);
+        } else if(key == "project_id") {
+            success = parseString(claims.projectId, pos, end);
+        } else if(key == "role") {
+            success = parseString(claims.role, pos, end);
+        } else if(key == "is_admin") {
+            success = parseBool(claims.isAdmin, pos, end);
+        } else if(key == "is_project_admin") {
+            success = parseBool(claims.isProjectAdmin, pos, end);
+        } else if(key == "jti") {
+            success = parseString(claims.tokenId, pos, end);
+        } else if(key == "iat") {
+            success = parseInt(claims.iat, pos, end);
+        } else if(key == "iat_us") {
+            success = parseInt(claims.iatMicros, pos, end);
+        } else if(key == "nbf") {
+            success = parseInt(claims.nbf, pos, end);
+        } else if(key == "exp") {
+            success = parseInt(claims.exp, pos, end);
+            hasExp = success;
+        } else if(key == "pm") {
+            success = parseString(claims.memberships, pos, end);
+        } else if(key == "mv") {
+            success = parseInt(claims.membershipVersion, pos, end);
+        } else {
+            success = skipValue(pos, end);
+        }
+
+        if(success == false) {
+            return false;
+        }
+
+        // go to next key-value-pair
+        skipWhitespaces(pos, end);
+        if(pos >= end) {
+            return false;
+        }
+        if(*pos == ',')
+        {
+            pos++;
+            continue;
+        }
+        if(*pos == '}') {
+            break;
+        }
+
+        return false;
+    }
+
+    // tokens of older versions have only the seconds, so they are handled as created at the
+    // end of the second, like before, to not miss a revocation within the same second
+    if(claims.iatMicros == 0) {
+        claims.iatMicros = claims.iat * 1000000 + 999999;
+    }
+
+    return hasExp;
+}
+
+/**
+ * @brief scan the json-header of a token for the algorithm and the key-id
+ *
+ * @param algorithm reference for the resulting algorithm, which stays empty, if header has no alg
+ * @param keyId reference for the resulting key-id, which stays empty, if header has no kid
+ * @param header pointer to the decoded json-header
+ * @param headerSize size of the header
+ *
+ * @return false, if header is invalid, else true
+ */
+static bool
+parseHeader(std::string &algorithm,
+            std::string &keyId,
+            const char* header,
+            const uint64_t headerSize)
+{
+    thread_local std::string key;
+
+    const char* pos = header;
+    const char* end = header + headerSize;
+
+    algorithm.clear();
+    keyId.clear();
+
+    skipWhitespaces(pos, end);
+    if(pos >= end
+            || *pos != '{')
+    {
+        return false;
+    }
+    pos++;
+
+    while(true)
+    {
+        skipWhitespaces(pos, end);
+        if(pos >= end) {
+            return false;
+        }
+        if(*pos == '}') {
+            return true;
+        }
+
+        // get key
+        if(parseString(key, pos, end) == false) {
+            return false;
+        }
+        skipWhitespaces(pos, end);
+        if(pos >= end
+                || *pos != ':')
+        {
+            return false;
+        }
+        pos++;
+        skipWhitespaces(pos, end);
+
+        // get value
+        bool success = true;
+        if(key == "alg") {
+            success = parseString(algorithm, pos, end);
+        } else if(key == "kid") {
+            success = parseString(keyId, pos, end);
+        } else {
+            success = skipValue(pos, end);
+        }
+
+        if(success == false) {
+            return false;
+        }
+
+        // go to next key-value-pair
+        skipWhitespaces(pos, end);
+        if(pos >= end) {
+            return false;
+        }
+        if(*pos == ',')
+        {
+            pos++;
+            continue;
+        }
+        if(*pos == '}') {
+            return true;
+        }
+
+        return false;
+    }
+}
+
+/**
+ * @brief constructor
+ *
+ * @param keyRing key-ring with the keys, which were used to sign the HS256- and EdDSA-tokens
+ * @param acceptHs256 false to reject all HS256-tokens, after the migration to EdDSA is done
+ */
+TokenVerifier::TokenVerifier(const TokenKeyRing* keyRing,
+                             const bool acceptHs256)
+{
+    m_keyRing = keyRing;
+    m_acceptHs256 = acceptHs256;
+}
+
+/**
+ * @brief destructor
+ */
+TokenVerifier::~TokenVerifier() {}
+
+/**
+ * @brief check the signature of a token. The algorithm and the key are selected by the
+ *        alg- and kid-header, which must match the size of the signature. The header is small,
+ *        so decoding it before the signature-check is cheap.
+ *
+ * @param unknownKey set to true, if the kid-header names a key, which is not accepted
+ * @param signedPart pointer to the begin of the 'header.payload'-part of the token
+ * @param signedPartSize size of the 'header.payload'-part
+ * @param headerSize size of the base64url-encoded header at the begin of the signed part
+ * @param signature pointer to the base64url-encoded signature
+ * @param signatureSize size of the base64url-encoded signature
+ *
+ * @return true, if signature matches, else false
+ */
+bool
+TokenVerifier::checkSignature(bool &unknownKey,
+                              const char* signedPart,
+                              const uint64_t signedPartSize,
+                              const uint64_t headerSize,
+                              const char* signature,
+                              const uint64_t signatureSize) const
+{
+    thread_local std::string headerBuffer;
+    thread_local std::string algorithm;
+    thread_local std::string keyId;
+
+    if(decodeBase64Url(headerBuffer, signedPart, headerSize) == false
+            || parseHeader(algorithm, keyId, headerBuffer.c_str(), headerBuffer.size()) == false)
+    {
+        return false;
+    }
+
+    // decode given signature
+    uint8_t givenSignature[Ed25519Key::SIGNATURE_SIZE];
+    uint64_t givenSignatureSize = 0;
+    if(decodeBase64Url(givenSignature,
+                       givenSignatureSize,
+                       Ed25519Key::SIGNATURE_SIZE,
+                       signature,
+                       signatureSize) == false)
+    {
+        return false;
+    }
+
+    if(algorithm == "HS256")
+    {
+        if(m_acceptHs256 == false
+                || givenSignatureSize != CryptoPP::SHA256::DIGESTSIZE)
+        {
+            return false;
+        }
+
+        return checkHmac(unknownKey, givenSignature, keyId, signedPart, signedPartSize);
+    }
+
+    if(algorithm == "EdDSA")
+    {
+        // EdDSA-tokens always have a key-id, so the key can be rotated
+        const Ed25519Key* ed25519Key = m_keyRing->getEd25519Key(keyId);
+        if(ed25519Key == nullptr)
+        {
+            unknownKey = true;
+            return false;
+        }
+
+        if(givenSignatureSize != Ed25519Key::SIGNATURE_SIZE) {
+            return false;
+        }
+
+        return ed25519Key->verify(givenSignature, signedPart, signedPartSize);
+    }
+
+    return false;
+}
+
+/**
+ * @brief check a HMAC-SHA256-signature with the key of the key-ring, which is named by the
+ *        kid-header of the token
+ *
+ * @param unknownKey set to true, if the key-id is not within the key-ring
+ * @param mac decoded 32 byte signature of the token
+ * @param keyId key-id from the header of the token, or empty for tokens of older versions
+ * @param signedPart pointer to the begin of the 'header.payload'-part of the token
+ * @param signedPartSize size of the 'header.payload'-part
+ *
+ * @return true, if signature matches, else false
+ */
+bool
+TokenVerifier::checkHmac(bool &unknownKey,
+                         const uint8_t* mac,
+                         const std::string &keyId,
+                         const char* signedPart,
+                         const uint64_t signedPartSize) const
+{
+    // the key-set is taken only once, so it can not change during the check
+    const std::shared_ptr<const TokenKeySet> keySet = m_keyRing->getKeySet();
+
+    if(keyId != "")
+    {
+        const TokenKey* tokenKey = keySet->getKey(keyId);
+        if(tokenKey == nullptr)
+        {
+            unknownKey = true;
+            return false;
+        }
+
+        return tokenKey->key->verifyMac(mac, signedPart, signedPartSize);
+    }
+
+    // tokens from older versions have no key-id, so all accepted keys have to be tried
+    for(const TokenKey &tokenKey : keySet->keys)
+    {
+        if(tokenKey.key->verifyMac(mac, signedPart, signedPartSize)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief verify a jwt-token, where the signature is checked first, before the payload of the
+ *        token is decoded
+ *
+ * @param claims reference for the claims of the token
+ * @param unknownKey set to true, if the token names a key, which is not accepted at the moment.
+ *                   Such a token can become valid, after the key was added by a rotation.
+ * @param token token to verify
+ * @param publicError reference for error-message, which can be send back to the user
+ *
+ * @return true, if token is valid, else false
+ */
+bool
+TokenVerifier::verifyToken(TokenClaims &claims,
+                           bool &unknownKey,
+                           const std::string &token,
+                           std::string &publicError) const
+{
+    thread_local std::string payloadBuffer;
+
+    unknownKey = false;
+
+    // split token into its parts
+    const size_t firstDot = token.find('.');
+    const size_t lastDot = token.rfind('.');
+    if(firstDot == std::string::npos
+            || firstDot == lastDot)
+    {
+        publicError = "Invalid token";
+        return false;
+    }
+
+    // check signature over 'header.payload' before decoding anything
+    if(checkSignature(unknownKey,
+                      token.c_str(),
+                      lastDot,
+                      firstDot,
+                      token.c_str() + lastDot + 1,
+                      token.size() - lastDot - 1) == false)
+    {
+        publicError = "Invalid token";
+        return false;
+    }
+
+    // decode payload into reusable buffer
+    if(decodeBase64Url(payloadBuffer,
+                       token.c_str() + firstDot + 1,
+                       lastDot - firstDot - 1) == false)
+    {
+        publicError = "Invalid token";
+        return false;
+    }
+
+    // get claims from payload
+    claims = TokenClaims();
+    if(parseClaims(claims, payloadBuffer.c_str(), payloadBuffer.size()) == false)
+    {
+        publicError = "Invalid token";
+        return false;
+    }
+
+    // check timestamps
+    const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                            std::chrono::system_clock::now().time_since_epoch()).count();
+    if(now >= claims.exp)
+    {
+        publicError = "Token is expired";
+        return false;
+    }
+    if(now < claims.nbf)
+    {
+        publicError = "Token is not valid yet";
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file        token_verifier.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_TOKEN_VERIFIER_H
+#define MISAKIGUARD_TOKEN_VERIFIER_H
+
+#include <string>
+
+#include <core/token_claims.h>
+
+class TokenKeyRing;
+
+class TokenVerifier
+{
+public:
+    TokenVerifier(const TokenKeyRing* keyRing,
+                  const bool acceptHs256);
+    ~TokenVerifier();
+
+    bool verifyToken(TokenClaims &claims,
+                     bool &unknownKey,
+                     const std::string &token,
+                     std::string &publicError) const;
+
+private:
+    const TokenKeyRing* m_keyRing = nullptr;
+    bool m_acceptHs256 = true;
+
+    bool checkSignature(bool &unknownKey,
+                        const char* signedPart,
+                        const uint64_t signedPartSize,
+                        const uint64_t headerSize,
+                        const char* signature,
+                        const uint64_t signatureSize) const;
+    bool checkHmac(bool &unknownKey,
+                   const uint8_t* mac,
+                   const std::string &keyId,
+                   const char* signedPart,
+                   const uint64_t signedPartSize) const;
+};
+
+bool parseClaims(TokenClaims &claims,
+                 const char* payload,
+                 const uint64_t payloadSize);
+
+#endif // MISAKIGUARD_TOKEN_VERIFIER_H
@@ -0,0 +1,393 @@
+/**
+ * @file        prepared_sql_admin_table.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <database/prepared_sql_admin_table.h>
+
+#include <libKitsunemimiCommon/items/table_item.h>
+#include <libKitsunemimiJson/json_item.h>
+
+#include <database/sql_connection.h>
+#include <database/sql_connection_pool.h>
+
+#include <cerrno>
+#include <cstdlib>
+
+/**
+ * @brief convert the string of an integer-column, without throwing an exception for invalid
+ *        content of the database
+ *
+ * @param result reference for the converted value
+ * @param value string to convert, where an empty string is converted to 0
+ *
+ * @return false, if the string is not a valid integer or out of range, else true
+ */
+static bool
+convertToLong(long &result,
+              const std::string &value)
+{
+    if(value == "")
+    {
+        result = 0;
+        return true;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    const long long converted = std::strtoll(value.c_str(), &end, 10);
+    if(errno != 0
+            || end != value.c_str() + value.size())
+    {
+        return false;
+    }
+
+    result = static_cast<long>(converted);
+
+    return true;
+}
+
+/**
+ * @brief constructor
+ *
+ * @param db database for the generic table-operations
+ * @param connectionPool connections with prepared statements for the lookups
+ */
+PreparedSqlAdminTable::PreparedSqlAdminTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                                             SqlConnectionPool* connectionPool)
+    : HanamiSqlAdminTable(db)
+{
+    m_connectionPool = connectionPool;
+}
+
+/**
+ * @brief destructor
+ */
+PreparedSqlAdminTable::~PreparedSqlAdminTable() {}
+
+/**
+ * @brief get the position of the id-column within the rows of a page, which don't contain the
+ *        hidden columns
+ *
+ * @return position of the id-column
+ */
+uint32_t
+PreparedSqlAdminTable::getPageIdColumn() const
+{
+    uint32_t position = 0;
+    for(const DbHeaderEntry &entry : m_tableHeader)
+    {
+        if(entry.name == "id") {
+            return position;
+        }
+        if(entry.hide == false) {
+            position++;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief create the sql-statements for the lookups. This has to be called at the end of the
+ *        constructor of the derived table, after all columns are registered.
+ */
+void
+PreparedSqlAdminTable::initStatements()
+{
+    m_getStatement = createSelectStatement(false) + " WHERE id = ?;";
+    m_getWithHiddenStatement = createSelectStatement(true) + " WHERE id = ?;";
+    m_existsStatement = "SELECT 1 FROM " + m_tableName + " WHERE id = ? LIMIT 1;";
+    m_insertStatement = createInsertStatement();
+    m_getPageStatement = createSelectStatement(false) + " WHERE id > ? ORDER BY id LIMIT ?;";
+    m_deleteStatement = "DELETE FROM " + m_tableName + " WHERE id = ?;";
+}
+
+/**
+ * @brief create a select-statement for all columns of the table
+ *
+ * @param showHiddenValues true to also select the columns, which are marked as hidden
+ *
+ * @return sql-statement without condition
+ */
+std::string
+PreparedSqlAdminTable::createSelectStatement(const bool showHiddenValues) const
+{
+    std::string statement = "SELECT ";
+    bool first = true;
+    for(const DbHeaderEntry &entry : m_tableHeader)
+    {
+        if(showHiddenValues == false
+                && entry.hide)
+        {
+            continue;
+        }
+
+        if(first == false) {
+            statement.append(", ");
+        }
+        statement.append(entry.name);
+        first = false;
+    }
+    statement.append(" FROM " + m_tableName);
+
+    return statement;
+}
+
+/**
+ * @brief create an insert-statement for all columns of the table, which doesn't change anything,
+ *        if there is already an entry with the same id. The conflict is not bound to the
+ *        id-column, so it works independent of the column, which is the primary key.
+ *
+ * @return sql-statement with one placeholder for each column
+ */
+std::string
+PreparedSqlAdminTable::createInsertStatement() const
+{
+    std::string columns = "";
+    std::string placeholders = "";
+    for(const DbHeaderEntry &entry : m_tableHeader)
+    {
+        if(columns.size() != 0)
+        {
+            columns.append(", ");
+            placeholders.append(", ");
+        }
+        columns.append(entry.name);
+        placeholders.append("?");
+    }
+
+    return "INSERT OR IGNORE INTO " + m_tableName + " (" + columns + ") "
+           "VALUES (" + placeholders + ");";
+}
+
+/**
+ * @brief get a single entry by its id with a prepared statement
+ *
+ * @param result reference for the resulting entry
+ * @param id id of the requested entry
+ * @param error reference for error-output
+ * @param showHiddenValues set to true to also show as hidden marked fields
+ *
+ * @return false, if no entry was found or the request failed, else true
+ */
+bool
+PreparedSqlAdminTable::getByIdFromDb(Kitsunemimi::JsonItem &result,
+                                     const std::string &id,
+                                     Kitsunemimi::ErrorContainer &error,
+                                     const bool showHiddenValues)
+{
+    const std::string &statement = showHiddenValues ? m_getWithHiddenStatement : m_getStatement;
+
+    Kitsunemimi::TableItem table;
+    if(m_connectionPool->read(table, statement, {id}, error) == false) {
+        return false;
+    }
+
+    if(table.getNumberOfRows() == 0)
+    {
+        error.addMeesage("No entry with id '" + id + "' found in table '" + m_tableName + "'");
+        return false;
+    }
+
+    // convert the values of the row back into their types, like the generic lookup does
+    uint32_t column = 0;
+    for(const DbHeaderEntry &entry : m_tableHeader)
+    {
+        if(showHiddenValues == false
+                && entry.hide)
+        {
+            continue;
+        }
+
+        const std::string value = table.getCell(column, 0);
+        if(entry.type == BOOL_TYPE) {
+            result.insert(entry.name, value == "true" || value == "1", true);
+        } else if(entry.type == INT_TYPE) {
+            long intValue = 0;
+            if(convertToLong(intValue, value) == false)
+            {
+                error.addMeesage("Invalid integer-value in column '"
+                                 + entry.name
+                                 + "' of entry with id '"
+                                 + id
+                                 + "' in table '"
+                                 + m_tableName
+                                 + "'");
+                return false;
+            }
+            result.insert(entry.name, intValue, true);
+        } else {
+            result.insert(entry.name, value, true);
+        }
+        column++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief check if an entry exist by its id, without reading any values of the entry. A missing
+ *        entry is not handled as error.
+ *
+ * @param exists reference for the result, if the entry exist
+ * @param id id of the requested entry
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+PreparedSqlAdminTable::existsInDb(bool &exists,
+                                  const std::string &id,
+                                  Kitsunemimi::ErrorContainer &error)
+{
+    Kitsunemimi::TableItem table;
+    if(m_connectionPool->read(table, m_existsStatement, {id}, error) == false) {
+        return false;
+    }
+
+    exists = table.getNumberOfRows() != 0;
+
+    return true;
+}
+
+/**
+ * @brief add a new entry with a single statement, which relies on the primary key of the id
+ *        instead of checking the id with an additional request before
+ *
+ * @param inserted reference for the result, false, if an entry with the same id already exist
+ * @param values json-item with the values for all columns of the table
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+PreparedSqlAdminTable::insertNewToDb(bool &inserted,
+                                     Kitsunemimi::JsonItem &values,
+                                     Kitsunemimi::ErrorContainer &error)
+{
+    // convert the values into strings, like the generic insert does
+    std::vector<std::string> convertedValues;
+    convertedValues.reserve(m_tableHeader.size());
+    for(const DbHeaderEntry &entry : m_tableHeader)
+    {
+        Kitsunemimi::JsonItem value = values.get(entry.name);
+        if(value.isValid() == false)
+        {
+            error.addMeesage("Value for column '"
+                             + entry.name
+                             + "' is missing for new entry in table '"
+                             + m_tableName
+                             + "'");
+            return false;
+        }
+
+        if(value.isString()) {
+            convertedValues.push_back(value.getString());
+        } else {
+            convertedValues.push_back(value.toString());
+        }
+    }
+
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges,
+                               m_insertStatement,
+                               convertedValues,
+                               error) == false)
+    {
+        return false;
+    }
+
+    inserted = numberOfChanges != 0;
+
+    return true;
+}
+
+/**
+ * @brief get a page of entries ordered by their id without the hidden columns. The page starts
+ *        behind the given id, so the primary key is used to find the start instead of skipping
+ *        all previous rows.
+ *
+ * @param result reference for the resulting rows
+ * @param afterId id of the last entry of the previous page, or empty for the first page
+ * @param limit maximum number of entries of the page, or -1 for all remaining entries
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+PreparedSqlAdminTable::getPageFromDb(Kitsunemimi::TableItem &result,
+                                     const std::string &afterId,
+                                     const int64_t limit,
+                                     Kitsunemimi::ErrorContainer &error)
+{
+    const std::vector<std::string> values = {afterId, std::to_string(limit)};
+    return m_connectionPool->read(result, m_getPageStatement, values, error);
+}
+
+/**
+ * @brief delete a single entry by its id with a prepared statement
+ *
+ * @param deleted reference for the result, if an entry was deleted
+ * @param id id of the entry to delete
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+PreparedSqlAdminTable::deleteByIdFromDb(bool &deleted,
+                                        const std::string &id,
+                                        Kitsunemimi::ErrorContainer &error)
+{
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, m_deleteStatement, {id}, error) == false) {
+        return false;
+    }
+
+    deleted = numberOfChanges != 0;
+
+    return true;
+}
+
+/**
+ * @brief delete a single entry by its id within a running transaction of the writer
+ *
+ * @param deleted reference for the result, if an entry was deleted
+ * @param id id of the entry to delete
+ * @param writer writer-connection of the transaction
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+PreparedSqlAdminTable::deleteByIdFromDb(bool &deleted,
+                                        const std::string &id,
+                                        SqlConnection &writer,
+                                        Kitsunemimi::ErrorContainer &error)
+{
+    uint64_t numberOfChanges = 0;
+    if(writer.execute(numberOfChanges, m_deleteStatement, {id}, error) == false) {
+        return false;
+    }
+
+    deleted = numberOfChanges != 0;
+
+    return true;
+}
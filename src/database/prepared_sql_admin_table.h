@@ -0,0 +1,85 @@
+/**
+ * @file        prepared_sql_admin_table.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_PREPARED_SQL_ADMIN_TABLE_H
+#define MISAKIGUARD_PREPARED_SQL_ADMIN_TABLE_H
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiHanamiDatabase/hanami_sql_admin_table.h>
+
+namespace Kitsunemimi {
+class JsonItem;
+class TableItem;
+}
+class SqlConnectionPool;
+class SqlConnection;
+
+class PreparedSqlAdminTable
+        : public Kitsunemimi::Hanami::HanamiSqlAdminTable
+{
+public:
+    PreparedSqlAdminTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                          SqlConnectionPool* connectionPool);
+    virtual ~PreparedSqlAdminTable();
+
+    uint32_t getPageIdColumn() const;
+
+protected:
+    SqlConnectionPool* m_connectionPool = nullptr;
+
+    void initStatements();
+
+    bool getByIdFromDb(Kitsunemimi::JsonItem &result,
+                       const std::string &id,
+                       Kitsunemimi::ErrorContainer &error,
+                       const bool showHiddenValues);
+    bool existsInDb(bool &exists,
+                    const std::string &id,
+                    Kitsunemimi::ErrorContainer &error);
+    bool insertNewToDb(bool &inserted,
+                       Kitsunemimi::JsonItem &values,
+                       Kitsunemimi::ErrorContainer &error);
+    bool getPageFromDb(Kitsunemimi::TableItem &result,
+                       const std::string &afterId,
+                       const int64_t limit,
+                       Kitsunemimi::ErrorContainer &error);
+    bool deleteByIdFromDb(bool &deleted,
+                          const std::string &id,
+                          Kitsunemimi::ErrorContainer &error);
+    bool deleteByIdFromDb(bool &deleted,
+                          const std::string &id,
+                          SqlConnection &writer,
+                          Kitsunemimi::ErrorContainer &error);
+
+private:
+    std::string m_getStatement = "";
+    std::string m_getWithHiddenStatement = "";
+    std::string m_existsStatement = "";
+    std::string m_insertStatement = "";
+    std::string m_getPageStatement = "";
+    std::string m_deleteStatement = "";
+
+    std::string createSelectStatement(const bool showHiddenValues) const;
+    std::string createInsertStatement() const;
+};
+
+#endif // MISAKIGUARD_PREPARED_SQL_ADMIN_TABLE_H
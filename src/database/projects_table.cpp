@@ -29,13 +29,27 @@
 
 #include <libKitsunemimiSakuraDatabase/sql_database.h>
 
+#include <database/sql_connection.h>
+#include <database/sql_connection_pool.h>
+#include <database/user_projects_table.h>
+
 /**
  * @brief constructor
+ *
+ * @param db database for the generic table-operations
+ * @param connectionPool connections with prepared statements
+ * @param userProjectsTable table with the memberships, which are deleted together with the
+ *                          projects
  */
-ProjectsTable::ProjectsTable(Kitsunemimi::Sakura::SqlDatabase* db)
-    : HanamiSqlAdminTable(db)
+ProjectsTable::ProjectsTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                             SqlConnectionPool* connectionPool,
+                             UserProjectsTable* userProjectsTable)
+    : PreparedSqlAdminTable(db, connectionPool)
 {
     m_tableName = "projects";
+    m_userProjectsTable = userProjectsTable;
+
+    initStatements();
 }
 
 /**
@@ -46,16 +60,18 @@ ProjectsTable::~ProjectsTable() {}
 /**
  * @brief add a new project to the database
  *
+ * @param added reference for the result, false, if a project with the same id already exist
  * @param userData json-item with all information of the project to add to database
  * @param error reference for error-output
  *
  * @return true, if successful, else false
  */
 bool
-ProjectsTable::addProject(Kitsunemimi::JsonItem &userData,
+ProjectsTable::addProject(bool &added,
+                          Kitsunemimi::JsonItem &userData,
                           Kitsunemimi::ErrorContainer &error)
 {
-    if(insertToDb(userData, error) == false)
+    if(insertNewToDb(added, userData, error) == false)
     {
         error.addMeesage("Failed to add user to database");
         return false;
@@ -80,10 +96,7 @@ ProjectsTable::getProject(Kitsunemimi::JsonItem &result,
                           Kitsunemimi::ErrorContainer &error,
                           const bool showHiddenValues)
 {
-    std::vector<RequestCondition> conditions;
-    conditions.emplace_back("id", projectId);
-
-    if(getFromDb(result, conditions, error, showHiddenValues) == false)
+    if(getByIdFromDb(result, projectId, error, showHiddenValues) == false)
     {
         error.addMeesage("Failed to get user with id '"
                          + projectId
@@ -96,21 +109,49 @@ ProjectsTable::getProject(Kitsunemimi::JsonItem &result,
 }
 
 /**
- * @brief get all projects from the database table
+ * @brief check if a project exist, without reading any values of the project
+ *
+ * @param exists reference for the result, if the project exist
+ * @param projectId id of the requested project
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+ProjectsTable::existsProject(bool &exists,
+                             const std::string &projectId,
+                             Kitsunemimi::ErrorContainer &error)
+{
+    if(existsInDb(exists, projectId, error) == false)
+    {
+        error.addMeesage("Failed to check project with id '"
+                         + projectId
+                         + "' in database");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get a page of projects ordered by their id from the database table
  *
  * @param result reference for the result-output
+ * @param afterId id of the last project of the previous page, or empty for the first page
+ * @param limit maximum number of projects, or -1 for all remaining projects
  * @param error reference for error-output
  *
  * @return true, if successful, else false
  */
 bool
-ProjectsTable::getAllProjects(Kitsunemimi::TableItem &result,
+ProjectsTable::getProjectPage(Kitsunemimi::TableItem &result,
+                              const std::string &afterId,
+                              const int64_t limit,
                               Kitsunemimi::ErrorContainer &error)
 {
-    std::vector<RequestCondition> conditions;
-    if(getFromDb(result, conditions, error, false) == false)
+    if(getPageFromDb(result, afterId, limit, error) == false)
     {
-        error.addMeesage("Failed to get all users from database");
+        error.addMeesage("Failed to get projects from database");
         return false;
     }
 
@@ -118,25 +159,33 @@ ProjectsTable::getAllProjects(Kitsunemimi::TableItem &result,
 }
 
 /**
- * @brief delete a project from the table
+ * @brief delete a project together with all its memberships with bound statements in one
+ *        transaction on the writer-connection
  *
+ * @param deleted reference for the result, false, if the project didn't exist anymore
+ * @param memberIds reference for the ids of the users, which were member of the project
  * @param projectId id of the project to delete
  * @param error reference for error-output
  *
  * @return true, if successful, else false
  */
 bool
-ProjectsTable::deleteProject(const std::string &projectId,
-                             Kitsunemimi::ErrorContainer &error)
+ProjectsTable::deleteProjectWithMemberships(bool &deleted,
+                                            std::vector<std::string> &memberIds,
+                                            const std::string &projectId,
+                                            Kitsunemimi::ErrorContainer &error)
 {
-    std::vector<RequestCondition> conditions;
-    conditions.emplace_back("id", projectId);
+    const std::function<bool(SqlConnection&)> deleteTask = [&](SqlConnection &writer) {
+        return m_userProjectsTable->deleteMembershipsOfProject(memberIds,
+                                                               projectId,
+                                                               writer,
+                                                               error)
+               && deleteByIdFromDb(deleted, projectId, writer, error);
+    };
 
-    if(deleteFromDb(conditions, error) == false)
+    if(m_connectionPool->writeTransaction(deleteTask, error) == false)
     {
-        error.addMeesage("Failed to delete user with id '"
-                         + projectId
-                         + "' from database");
+        error.addMeesage("Failed to delete project with id '" + projectId + "' from database");
         return false;
     }
 
@@ -24,30 +24,45 @@
 #define MISAKIGUARD_PROJECTS_TABLE_H
 
 #include <libKitsunemimiCommon/logger.h>
-#include <libKitsunemimiHanamiDatabase/hanami_sql_admin_table.h>
+#include <database/prepared_sql_admin_table.h>
 
 namespace Kitsunemimi {
 namespace Json {
 class JsonItem;
 }
 }
+class UserProjectsTable;
+
 class ProjectsTable
-        : public Kitsunemimi::Hanami::HanamiSqlAdminTable
+        : public PreparedSqlAdminTable
 {
 public:
-    ProjectsTable(Kitsunemimi::Sakura::SqlDatabase* db);
+    ProjectsTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                  SqlConnectionPool* connectionPool,
+                  UserProjectsTable* userProjectsTable);
     ~ProjectsTable();
 
-    bool addProject(Kitsunemimi::JsonItem &userData,
+    bool addProject(bool &added,
+                    Kitsunemimi::JsonItem &userData,
                     Kitsunemimi::ErrorContainer &error);
     bool getProject(Kitsunemimi::JsonItem &result,
                     const std::string &projectName,
                     Kitsunemimi::ErrorContainer &error,
                     const bool showHiddenValues = false);
-    bool getAllProjects(Kitsunemimi::TableItem &result,
-                       Kitsunemimi::ErrorContainer &error);
-    bool deleteProject(const std::string &projectName,
+    bool existsProject(bool &exists,
+                       const std::string &projectId,
                        Kitsunemimi::ErrorContainer &error);
+    bool getProjectPage(Kitsunemimi::TableItem &result,
+                        const std::string &afterId,
+                        const int64_t limit,
+                        Kitsunemimi::ErrorContainer &error);
+    bool deleteProjectWithMemberships(bool &deleted,
+                                      std::vector<std::string> &memberIds,
+                                      const std::string &projectId,
+                                      Kitsunemimi::ErrorContainer &error);
+
+private:
+    UserProjectsTable* m_userProjectsTable = nullptr;
 };
 
 #endif // MISAKIGUARD_PROJECTS_TABLE_H
@@ -0,0 +1,156 @@
+/**
+ * @file        revocations_table.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <database/revocations_table.h>
+
+#include <libKitsunemimiCommon/items/table_item.h>
+
+#include <libKitsunemimiSakuraDatabase/sql_database.h>
+
+#include <database/sql_connection_pool.h>
+
+/**
+ * @brief constructor
+ *
+ * @param db database for the generic table-operations
+ * @param connectionPool connections with prepared statements
+ */
+RevocationsTable::RevocationsTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                                   SqlConnectionPool* connectionPool)
+    : SqlTable(db)
+{
+    m_tableName = "revocations";
+    m_connectionPool = connectionPool;
+
+    DbHeaderEntry id;
+    id.name = "id";
+    id.maxLength = 256;
+    id.isPrimary = true;
+    m_tableHeader.push_back(id);
+
+    DbHeaderEntry type;
+    type.name = "type";
+    type.maxLength = 16;
+    m_tableHeader.push_back(type);
+
+    DbHeaderEntry notBefore;
+    notBefore.name = "not_before";
+    notBefore.type = INT_TYPE;
+    m_tableHeader.push_back(notBefore);
+
+    DbHeaderEntry expiresAt;
+    expiresAt.name = "expires_at";
+    expiresAt.type = INT_TYPE;
+    m_tableHeader.push_back(expiresAt);
+}
+
+/**
+ * @brief destructor
+ */
+RevocationsTable::~RevocationsTable() {}
+
+/**
+ * @brief add a new revocation to the database or replace an existing one with the same id
+ *
+ * @param id id of the revoked token or the user, whose tokens are revoked
+ * @param type type of the revocation ('token' or 'user')
+ * @param notBefore tokens issued at or before this timestamp in micro-seconds are revoked
+ *                  (only for users)
+ * @param expiresAt timestamp, after which the revocation is not necessary anymore
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+RevocationsTable::addRevocation(const std::string &id,
+                                const std::string &type,
+                                const int64_t notBefore,
+                                const int64_t expiresAt,
+                                Kitsunemimi::ErrorContainer &error)
+{
+    // an existing revocation with the same id is replaced by a single atomic statement
+    static const std::string statement = "INSERT INTO revocations "
+                                         "(id, type, not_before, expires_at) "
+                                         "VALUES (?, ?, ?, ?) "
+                                         "ON CONFLICT(id) DO UPDATE SET "
+                                         "type = excluded.type, "
+                                         "not_before = excluded.not_before, "
+                                         "expires_at = excluded.expires_at;";
+
+    const std::vector<std::string> values = {id,
+                                             type,
+                                             std::to_string(notBefore),
+                                             std::to_string(expiresAt)};
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, statement, values, error) == false)
+    {
+        error.addMeesage("Failed to add revocation with id '" + id + "' to database");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get all revocations from the database table
+ *
+ * @param result reference for the result-output
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+RevocationsTable::getAllRevocations(Kitsunemimi::TableItem &result,
+                                    Kitsunemimi::ErrorContainer &error)
+{
+    if(getAllFromDb(result, error, false) == false)
+    {
+        error.addMeesage("Failed to get all revocations from database");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief delete a revocation from the table
+ *
+ * @param id id of the revocation to delete
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+RevocationsTable::deleteRevocation(const std::string &id,
+                                   Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "DELETE FROM revocations WHERE id = ?;";
+
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, statement, {id}, error) == false)
+    {
+        error.addMeesage("Failed to delete revocation with id '" + id + "' from database");
+        return false;
+    }
+
+    return true;
+}
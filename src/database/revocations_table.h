@@ -0,0 +1,57 @@
+/**
+ * @file        revocations_table.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_REVOCATIONS_TABLE_H
+#define MISAKIGUARD_REVOCATIONS_TABLE_H
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiSakuraDatabase/sql_table.h>
+
+namespace Kitsunemimi {
+class JsonItem;
+class TableItem;
+}
+class SqlConnectionPool;
+
+class RevocationsTable
+        : public Kitsunemimi::Sakura::SqlTable
+{
+public:
+    RevocationsTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                     SqlConnectionPool* connectionPool);
+    ~RevocationsTable();
+
+    bool addRevocation(const std::string &id,
+                       const std::string &type,
+                       const int64_t notBefore,
+                       const int64_t expiresAt,
+                       Kitsunemimi::ErrorContainer &error);
+    bool getAllRevocations(Kitsunemimi::TableItem &result,
+                           Kitsunemimi::ErrorContainer &error);
+    bool deleteRevocation(const std::string &id,
+                          Kitsunemimi::ErrorContainer &error);
+
+private:
+    SqlConnectionPool* m_connectionPool = nullptr;
+};
+
+#endif // MISAKIGUARD_REVOCATIONS_TABLE_H
@@ -0,0 +1,239 @@
+/**
+ * @file        sessions_table.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <database/sessions_table.h>
+
+#include <libKitsunemimiCommon/items/table_item.h>
+#include <libKitsunemimiJson/json_item.h>
+
+#include <libKitsunemimiSakuraDatabase/sql_database.h>
+
+#include <database/sql_connection_pool.h>
+
+/**
+ * @brief constructor
+ *
+ * @param db database for the generic table-operations
+ * @param connectionPool connections with prepared statements
+ */
+SessionsTable::SessionsTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                             SqlConnectionPool* connectionPool)
+    : SqlTable(db)
+{
+    m_tableName = "sessions";
+    m_connectionPool = connectionPool;
+
+    // only the hash of the refresh-token is stored and used as primary key, so the lookup
+    // of a refresh-token uses the index of the primary key
+    DbHeaderEntry id;
+    id.name = "id";
+    id.maxLength = 64;
+    id.isPrimary = true;
+    m_tableHeader.push_back(id);
+
+    DbHeaderEntry userId;
+    userId.name = "user_id";
+    userId.maxLength = 256;
+    m_tableHeader.push_back(userId);
+
+    DbHeaderEntry projectId;
+    projectId.name = "project_id";
+    projectId.maxLength = 256;
+    m_tableHeader.push_back(projectId);
+
+    DbHeaderEntry expiresAt;
+    expiresAt.name = "expires_at";
+    expiresAt.type = INT_TYPE;
+    m_tableHeader.push_back(expiresAt);
+}
+
+/**
+ * @brief destructor
+ */
+SessionsTable::~SessionsTable() {}
+
+/**
+ * @brief create additional indexes for the deletion of all sessions of a user and of the
+ *        expired sessions, which are not covered by the primary key
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SessionsTable::initIndexes(Kitsunemimi::ErrorContainer &error)
+{
+    const std::string command = "CREATE INDEX IF NOT EXISTS sessions_user_id "
+                                "ON sessions (user_id); "
+                                "CREATE INDEX IF NOT EXISTS sessions_expires_at "
+                                "ON sessions (expires_at);";
+
+    Kitsunemimi::TableItem result;
+    if(m_db->execSqlCommand(&result, command, error) == false)
+    {
+        error.addMeesage("Failed to create indexes of table 'sessions'");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief add a new session to the database
+ *
+ * @param tokenHash hash of the refresh-token of the session
+ * @param userId id of the user of the session
+ * @param projectId id of the project, which was selected at the login
+ * @param expiresAt timestamp, after which the refresh-token is not valid anymore
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SessionsTable::addSession(const std::string &tokenHash,
+                          const std::string &userId,
+                          const std::string &projectId,
+                          const int64_t expiresAt,
+                          Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "INSERT INTO sessions "
+                                         "(id, user_id, project_id, expires_at) "
+                                         "VALUES (?, ?, ?, ?);";
+
+    const std::vector<std::string> values = {tokenHash,
+                                             userId,
+                                             projectId,
+                                             std::to_string(expiresAt)};
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, statement, values, error) == false)
+    {
+        error.addMeesage("Failed to add session of user with id '" + userId + "' to database");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get a session from the database
+ *
+ * @param result reference for the result-output
+ * @param tokenHash hash of the refresh-token of the session
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SessionsTable::getSession(Kitsunemimi::JsonItem &result,
+                          const std::string &tokenHash,
+                          Kitsunemimi::ErrorContainer &error)
+{
+    std::vector<RequestCondition> conditions;
+    conditions.emplace_back("id", tokenHash);
+
+    if(getFromDb(result, conditions, error, false) == false)
+    {
+        error.addMeesage("Failed to get session from database");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief delete a session from the table
+ *
+ * @param deleted reference for the result, false, if the session didn't exist anymore
+ * @param tokenHash hash of the refresh-token of the session
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SessionsTable::deleteSession(bool &deleted,
+                             const std::string &tokenHash,
+                             Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "DELETE FROM sessions WHERE id = ?;";
+
+    // the number of changes shows, if a parallel request has already deleted the session
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, statement, {tokenHash}, error) == false)
+    {
+        error.addMeesage("Failed to delete session from database");
+        return false;
+    }
+
+    deleted = numberOfChanges != 0;
+
+    return true;
+}
+
+/**
+ * @brief delete all sessions of a user from the table
+ *
+ * @param userId id of the user
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SessionsTable::deleteSessionsOfUser(const std::string &userId,
+                                    Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "DELETE FROM sessions WHERE user_id = ?;";
+
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, statement, {userId}, error) == false)
+    {
+        error.addMeesage("Failed to delete sessions of user with id '"
+                         + userId
+                         + "' from database");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief delete all expired sessions from the table
+ *
+ * @param now current timestamp in seconds
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SessionsTable::deleteExpiredSessions(const int64_t now,
+                                     Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "DELETE FROM sessions WHERE expires_at < ?;";
+
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, statement, {std::to_string(now)}, error) == false)
+    {
+        error.addMeesage("Failed to delete expired sessions from database");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file        sessions_table.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_SESSIONS_TABLE_H
+#define MISAKIGUARD_SESSIONS_TABLE_H
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiSakuraDatabase/sql_table.h>
+
+namespace Kitsunemimi {
+class JsonItem;
+}
+class SqlConnectionPool;
+class SessionsTable
+        : public Kitsunemimi::Sakura::SqlTable
+{
+public:
+    SessionsTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                  SqlConnectionPool* connectionPool);
+    ~SessionsTable();
+
+    bool initIndexes(Kitsunemimi::ErrorContainer &error);
+
+    bool addSession(const std::string &tokenHash,
+                    const std::string &userId,
+                    const std::string &projectId,
+                    const int64_t expiresAt,
+                    Kitsunemimi::ErrorContainer &error);
+    bool getSession(Kitsunemimi::JsonItem &result,
+                    const std::string &tokenHash,
+                    Kitsunemimi::ErrorContainer &error);
+    bool deleteSession(bool &deleted,
+                       const std::string &tokenHash,
+                       Kitsunemimi::ErrorContainer &error);
+    bool deleteSessionsOfUser(const std::string &userId,
+                              Kitsunemimi::ErrorContainer &error);
+    bool deleteExpiredSessions(const int64_t now,
+                               Kitsunemimi::ErrorContainer &error);
+
+private:
+    SqlConnectionPool* m_connectionPool = nullptr;
+};
+
+#endif // MISAKIGUARD_SESSIONS_TABLE_H
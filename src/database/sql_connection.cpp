@@ -0,0 +1,363 @@
+/**
+ * @file        sql_connection.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "sql_connection.h"
+
+#include <libKitsunemimiCommon/items/table_item.h>
+
+/**
+ * @brief constructor
+ */
+SqlConnection::SqlConnection()
+{
+    m_reusedStatements = 0;
+}
+
+/**
+ * @brief destructor
+ */
+SqlConnection::~SqlConnection()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    for(auto it = m_statements.begin(); it != m_statements.end(); it++) {
+        sqlite3_finalize(it->second);
+    }
+    m_statements.clear();
+
+    if(m_db != nullptr) {
+        sqlite3_close(m_db);
+    }
+}
+
+/**
+ * @brief open a separate connection to the database, which keeps its prepared statements
+ *
+ * @param path path to the database-file, which must already exist
+ * @param readOnly true to open a connection, which can only be used for queries. A writable
+ *                 connection switches the database into WAL-mode.
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SqlConnection::openConnection(const std::string &path,
+                              const bool readOnly,
+                              Kitsunemimi::ErrorContainer &error)
+{
+    // the connection is protected by its own lock, so the internal mutex of sqlite is not needed
+    int flags = SQLITE_OPEN_NOMUTEX;
+    if(readOnly) {
+        flags |= SQLITE_OPEN_READONLY;
+    } else {
+        flags |= SQLITE_OPEN_READWRITE;
+    }
+
+    if(sqlite3_open_v2(path.c_str(), &m_db, flags, nullptr) != SQLITE_OK)
+    {
+        error.addMeesage("Failed to open database '"
+                         + path
+                         + "' with error: "
+                         + sqlite3_errmsg(m_db));
+        sqlite3_close(m_db);
+        m_db = nullptr;
+        return false;
+    }
+
+    sqlite3_busy_timeout(m_db, BUSY_TIMEOUT);
+
+    if(readOnly == false) {
+        return enableWal(error);
+    }
+
+    return true;
+}
+
+/**
+ * @brief switch the database into WAL-mode, so readers don't have to wait for a running write.
+ *        The mode is stored within the database-file and so it is also used by all other
+ *        connections.
+ *
+ * @param error reference for error-output
+ *
+ * @return false, if the command failed, else true
+ */
+bool
+SqlConnection::enableWal(Kitsunemimi::ErrorContainer &error)
+{
+    char* errorMessage = nullptr;
+    if(sqlite3_exec(m_db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, &errorMessage) != SQLITE_OK)
+    {
+        // sqlite doesn't provide a message for all errors
+        std::string message = "unknown error";
+        if(errorMessage != nullptr) {
+            message = errorMessage;
+        }
+
+        error.addMeesage("Failed to switch database into WAL-mode with error: " + message);
+        sqlite3_free(errorMessage);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief run a query and write the resulting rows into a table
+ *
+ * @param result reference for the resulting rows
+ * @param statement sql-statement with '?' as placeholders for the values
+ * @param values values for the placeholders in the order of the placeholders
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SqlConnection::execute(Kitsunemimi::TableItem &result,
+                       const std::string &statement,
+                       const std::vector<std::string> &values,
+                       Kitsunemimi::ErrorContainer &error)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    sqlite3_stmt* stmt = getStatement(statement, error);
+    if(stmt == nullptr) {
+        return false;
+    }
+
+    bool success = bindValues(stmt, values, error)
+                   && readRows(result, stmt, error);
+
+    // reset directly, so the statement doesn't hold a read-lock until its next usage
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    return success;
+}
+
+/**
+ * @brief run a changing statement
+ *
+ * @param numberOfChanges reference for the number of changed rows
+ * @param statement sql-statement with '?' as placeholders for the values
+ * @param values values for the placeholders in the order of the placeholders
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SqlConnection::execute(uint64_t &numberOfChanges,
+                       const std::string &statement,
+                       const std::vector<std::string> &values,
+                       Kitsunemimi::ErrorContainer &error)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    sqlite3_stmt* stmt = getStatement(statement, error);
+    if(stmt == nullptr) {
+        return false;
+    }
+
+    bool success = bindValues(stmt, values, error);
+    if(success)
+    {
+        if(sqlite3_step(stmt) == SQLITE_DONE)
+        {
+            // read under the lock, because the value belongs to the last statement of the
+            // connection
+            numberOfChanges = static_cast<uint64_t>(sqlite3_changes(m_db));
+        }
+        else
+        {
+            error.addMeesage("Failed to execute sql-statement '"
+                             + statement
+                             + "' with error: "
+                             + sqlite3_errmsg(m_db));
+            success = false;
+        }
+    }
+
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    return success;
+}
+
+/**
+ * @brief get number of statements, which are prepared within the connection
+ */
+uint64_t
+SqlConnection::getNumberOfPreparedStatements()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_statements.size();
+}
+
+/**
+ * @brief get number of executions, which could use an already prepared statement
+ */
+uint64_t
+SqlConnection::getNumberOfReusedStatements() const
+{
+    return m_reusedStatements;
+}
+
+/**
+ * @brief get the prepared statement for a sql-statement and prepare it at its first usage.
+ *        The lock of the connection must be hold by the caller.
+ *
+ * @param statement sql-statement
+ * @param error reference for error-output
+ *
+ * @return prepared statement, or nullptr if the statement is invalid
+ */
+sqlite3_stmt*
+SqlConnection::getStatement(const std::string &statement,
+                            Kitsunemimi::ErrorContainer &error)
+{
+    if(m_db == nullptr)
+    {
+        error.addMeesage("Sql-connection is not open");
+        return nullptr;
+    }
+
+    const auto it = m_statements.find(statement);
+    if(it != m_statements.end())
+    {
+        m_reusedStatements++;
+        return it->second;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    const int ret = sqlite3_prepare_v3(m_db,
+                                       statement.c_str(),
+                                       static_cast<int>(statement.size()) + 1,
+                                       SQLITE_PREPARE_PERSISTENT,
+                                       &stmt,
+                                       nullptr);
+    if(ret != SQLITE_OK)
+    {
+        error.addMeesage("Failed to prepare sql-statement '"
+                         + statement
+                         + "' with error: "
+                         + sqlite3_errmsg(m_db));
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+
+    m_statements.insert(std::make_pair(statement, stmt));
+
+    return stmt;
+}
+
+/**
+ * @brief bind values to the placeholders of a prepared statement
+ *
+ * @param stmt prepared statement
+ * @param values values for the placeholders
+ * @param error reference for error-output
+ *
+ * @return false, if the number of values doesn't match the placeholders, else true
+ */
+bool
+SqlConnection::bindValues(sqlite3_stmt* stmt,
+                          const std::vector<std::string> &values,
+                          Kitsunemimi::ErrorContainer &error)
+{
+    if(static_cast<int>(values.size()) != sqlite3_bind_parameter_count(stmt))
+    {
+        error.addMeesage("Number of values doesn't match the placeholders of sql-statement '"
+                         + std::string(sqlite3_sql(stmt))
+                         + "'");
+        return false;
+    }
+
+    for(uint32_t i = 0; i < values.size(); i++)
+    {
+        // values are only valid until the call returns, but the statement is reset before that
+        if(sqlite3_bind_text(stmt,
+                             static_cast<int>(i + 1),
+                             values[i].c_str(),
+                             static_cast<int>(values[i].size()),
+                             SQLITE_STATIC) != SQLITE_OK)
+        {
+            error.addMeesage("Failed to bind value to sql-statement with error: "
+                             + std::string(sqlite3_errmsg(m_db)));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief step through the rows of a prepared statement and convert them into a table
+ *
+ * @param result reference for the resulting rows
+ * @param stmt prepared statement with already bound values
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SqlConnection::readRows(Kitsunemimi::TableItem &result,
+                        sqlite3_stmt* stmt,
+                        Kitsunemimi::ErrorContainer &error)
+{
+    const int numberOfColumns = sqlite3_column_count(stmt);
+    for(int i = 0; i < numberOfColumns; i++) {
+        result.addColumn(sqlite3_column_name(stmt, i));
+    }
+
+    std::vector<std::string> row;
+    row.reserve(static_cast<uint64_t>(numberOfColumns));
+
+    int ret = sqlite3_step(stmt);
+    while(ret == SQLITE_ROW)
+    {
+        row.clear();
+        for(int i = 0; i < numberOfColumns; i++)
+        {
+            const unsigned char* value = sqlite3_column_text(stmt, i);
+            if(value == nullptr) {
+                row.push_back("");
+            } else {
+                row.emplace_back(reinterpret_cast<const char*>(value),
+                                 static_cast<uint64_t>(sqlite3_column_bytes(stmt, i)));
+            }
+        }
+        result.addRow(row);
+
+        ret = sqlite3_step(stmt);
+    }
+
+    if(ret != SQLITE_DONE)
+    {
+        error.addMeesage("Failed to execute sql-statement '"
+                         + std::string(sqlite3_sql(stmt))
+                         + "' with error: "
+                         + sqlite3_errmsg(m_db));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file        sql_connection.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_SQL_CONNECTION_H
+#define MISAKIGUARD_SQL_CONNECTION_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+#include <sqlite3.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi {
+class TableItem;
+}
+
+class SqlConnection
+{
+public:
+    SqlConnection();
+    ~SqlConnection();
+
+    bool openConnection(const std::string &path,
+                        const bool readOnly,
+                        Kitsunemimi::ErrorContainer &error);
+
+    bool execute(Kitsunemimi::TableItem &result,
+                 const std::string &statement,
+                 const std::vector<std::string> &values,
+                 Kitsunemimi::ErrorContainer &error);
+    bool execute(uint64_t &numberOfChanges,
+                 const std::string &statement,
+                 const std::vector<std::string> &values,
+                 Kitsunemimi::ErrorContainer &error);
+
+    uint64_t getNumberOfPreparedStatements();
+    uint64_t getNumberOfReusedStatements() const;
+
+private:
+    // time in milliseconds to wait for a lock, which is hold by another connection
+    static const int BUSY_TIMEOUT = 5000;
+
+    sqlite3* m_db = nullptr;
+    std::mutex m_lock;
+    std::unordered_map<std::string, sqlite3_stmt*> m_statements;
+    std::atomic<uint64_t> m_reusedStatements;
+
+    bool enableWal(Kitsunemimi::ErrorContainer &error);
+    sqlite3_stmt* getStatement(const std::string &statement,
+                               Kitsunemimi::ErrorContainer &error);
+    bool bindValues(sqlite3_stmt* stmt,
+                    const std::vector<std::string> &values,
+                    Kitsunemimi::ErrorContainer &error);
+    bool readRows(Kitsunemimi::TableItem &result,
+                  sqlite3_stmt* stmt,
+                  Kitsunemimi::ErrorContainer &error);
+};
+
+#endif // MISAKIGUARD_SQL_CONNECTION_H
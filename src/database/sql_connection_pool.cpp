@@ -0,0 +1,251 @@
+/**
+ * @file        sql_connection_pool.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "sql_connection_pool.h"
+
+#include <database/sql_connection.h>
+
+/**
+ * @brief constructor
+ */
+SqlConnectionPool::SqlConnectionPool()
+{
+    m_waitingReads = 0;
+}
+
+/**
+ * @brief destructor
+ */
+SqlConnectionPool::~SqlConnectionPool()
+{
+    for(SqlConnection* reader : m_readers) {
+        delete reader;
+    }
+    m_readers.clear();
+    m_freeReaders.clear();
+
+    if(m_writer != nullptr) {
+        delete m_writer;
+    }
+}
+
+/**
+ * @brief open the writer-connection, which also switches the database into WAL-mode, and the
+ *        read-only connections for the queries
+ *
+ * @param path path to the database-file, which must already exist
+ * @param numberOfReaders number of read-only connections
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SqlConnectionPool::initPool(const std::string &path,
+                            const uint32_t numberOfReaders,
+                            Kitsunemimi::ErrorContainer &error)
+{
+    // the writer has to be opened first, because the readers can not switch to WAL-mode
+    m_writer = new SqlConnection();
+    if(m_writer->openConnection(path, false, error) == false)
+    {
+        error.addMeesage("Failed to open writer-connection to the database");
+        return false;
+    }
+
+    for(uint32_t i = 0; i < numberOfReaders; i++)
+    {
+        SqlConnection* reader = new SqlConnection();
+        if(reader->openConnection(path, true, error) == false)
+        {
+            delete reader;
+            error.addMeesage("Failed to open read-only connection to the database");
+            return false;
+        }
+        m_readers.push_back(reader);
+    }
+    m_freeReaders = m_readers;
+
+    return true;
+}
+
+/**
+ * @brief run a query on one of the read-only connections. In WAL-mode this doesn't wait for a
+ *        running write or for queries on other connections.
+ *
+ * @param result reference for the resulting rows
+ * @param statement sql-statement with '?' as placeholders for the values
+ * @param values values for the placeholders in the order of the placeholders
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SqlConnectionPool::read(Kitsunemimi::TableItem &result,
+                        const std::string &statement,
+                        const std::vector<std::string> &values,
+                        Kitsunemimi::ErrorContainer &error)
+{
+    SqlConnection* reader = acquireReader();
+    const bool success = reader->execute(result, statement, values, error);
+    releaseReader(reader);
+
+    return success;
+}
+
+/**
+ * @brief run a changing statement on the single writer-connection
+ *
+ * @param numberOfChanges reference for the number of changed rows
+ * @param statement sql-statement with '?' as placeholders for the values
+ * @param values values for the placeholders in the order of the placeholders
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SqlConnectionPool::write(uint64_t &numberOfChanges,
+                         const std::string &statement,
+                         const std::vector<std::string> &values,
+                         Kitsunemimi::ErrorContainer &error)
+{
+    std::lock_guard<std::mutex> guard(m_writeLock);
+    return m_writer->execute(numberOfChanges, statement, values, error);
+}
+
+/**
+ * @brief run multiple statements on the writer-connection within a single transaction. The
+ *        transaction is committed, if the task was successful, else it is rolled back.
+ *
+ * @param task function, which runs the statements of the transaction on the given writer
+ * @param error reference for error-output
+ *
+ * @return true, if the task and the commit were successful, else false
+ */
+bool
+SqlConnectionPool::writeTransaction(const std::function<bool(SqlConnection &writer)> &task,
+                                    Kitsunemimi::ErrorContainer &error)
+{
+    std::lock_guard<std::mutex> guard(m_writeLock);
+
+    // take the write-lock of the database directly, so the transaction can not fail later
+    // because of a parallel writer of another process
+    uint64_t numberOfChanges = 0;
+    if(m_writer->execute(numberOfChanges, "BEGIN IMMEDIATE TRANSACTION;", {}, error) == false)
+    {
+        error.addMeesage("Failed to begin transaction");
+        return false;
+    }
+
+    if(task(*m_writer) == false
+            || m_writer->execute(numberOfChanges, "COMMIT;", {}, error) == false)
+    {
+        m_writer->execute(numberOfChanges, "ROLLBACK;", {}, error);
+        error.addMeesage("Transaction was rolled back");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get number of read-only connections
+ */
+uint64_t
+SqlConnectionPool::getNumberOfReaders() const
+{
+    return m_readers.size();
+}
+
+/**
+ * @brief get number of queries, which had to wait for a free read-only connection
+ */
+uint64_t
+SqlConnectionPool::getNumberOfWaitingReads() const
+{
+    return m_waitingReads;
+}
+
+/**
+ * @brief get number of prepared statements of all connections
+ */
+uint64_t
+SqlConnectionPool::getNumberOfPreparedStatements()
+{
+    uint64_t result = m_writer->getNumberOfPreparedStatements();
+    for(SqlConnection* reader : m_readers) {
+        result += reader->getNumberOfPreparedStatements();
+    }
+
+    return result;
+}
+
+/**
+ * @brief get number of reused prepared statements of all connections
+ */
+uint64_t
+SqlConnectionPool::getNumberOfReusedStatements() const
+{
+    uint64_t result = m_writer->getNumberOfReusedStatements();
+    for(const SqlConnection* reader : m_readers) {
+        result += reader->getNumberOfReusedStatements();
+    }
+
+    return result;
+}
+
+/**
+ * @brief take a free read-only connection and wait, if all are in use
+ *
+ * @return read-only connection, which has to be given back with releaseReader
+ */
+SqlConnection*
+SqlConnectionPool::acquireReader()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+
+    if(m_freeReaders.size() == 0)
+    {
+        m_waitingReads++;
+        m_cv.wait(guard, [this] { return m_freeReaders.size() != 0; });
+    }
+
+    // the last connection is taken, because its page-cache is most likely still warm
+    SqlConnection* reader = m_freeReaders.back();
+    m_freeReaders.pop_back();
+
+    return reader;
+}
+
+/**
+ * @brief give a read-only connection back to the pool
+ *
+ * @param reader connection, which was taken by acquireReader
+ */
+void
+SqlConnectionPool::releaseReader(SqlConnection* reader)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_freeReaders.push_back(reader);
+    }
+    m_cv.notify_one();
+}
@@ -0,0 +1,81 @@
+/**
+ * @file        sql_connection_pool.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_SQL_CONNECTION_POOL_H
+#define MISAKIGUARD_SQL_CONNECTION_POOL_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi {
+class TableItem;
+}
+class SqlConnection;
+
+class SqlConnectionPool
+{
+public:
+    SqlConnectionPool();
+    ~SqlConnectionPool();
+
+    bool initPool(const std::string &path,
+                  const uint32_t numberOfReaders,
+                  Kitsunemimi::ErrorContainer &error);
+
+    bool read(Kitsunemimi::TableItem &result,
+              const std::string &statement,
+              const std::vector<std::string> &values,
+              Kitsunemimi::ErrorContainer &error);
+    bool write(uint64_t &numberOfChanges,
+               const std::string &statement,
+               const std::vector<std::string> &values,
+               Kitsunemimi::ErrorContainer &error);
+    bool writeTransaction(const std::function<bool(SqlConnection &writer)> &task,
+                          Kitsunemimi::ErrorContainer &error);
+
+    uint64_t getNumberOfReaders() const;
+    uint64_t getNumberOfWaitingReads() const;
+    uint64_t getNumberOfPreparedStatements();
+    uint64_t getNumberOfReusedStatements() const;
+
+private:
+    SqlConnection* m_writer = nullptr;
+    // hold for each write, so no other write can run between the statements of a transaction
+    std::mutex m_writeLock;
+    std::vector<SqlConnection*> m_readers;
+
+    std::mutex m_lock;
+    std::condition_variable m_cv;
+    std::vector<SqlConnection*> m_freeReaders;
+    std::atomic<uint64_t> m_waitingReads;
+
+    SqlConnection* acquireReader();
+    void releaseReader(SqlConnection* reader);
+};
+
+#endif // MISAKIGUARD_SQL_CONNECTION_POOL_H
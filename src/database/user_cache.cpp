@@ -0,0 +1,409 @@
+/**
+ * @file        user_cache.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "user_cache.h"
+
+#include <chrono>
+
+/**
+ * @brief constructor
+ *
+ * @param maxNumberOfEntries maximum number of users, which can be cached at the same time
+ * @param timeToLive time in seconds, after which a cached user is read again from the
+ *                   database, even if no change of the user was registered by the cache
+ * @param numberOfShards number of independent locked parts of the cache
+ */
+UserCache::UserCache(const uint64_t maxNumberOfEntries,
+                     const uint32_t timeToLive,
+                     const uint32_t numberOfShards)
+{
+    m_timeToLive = timeToLive;
+
+    m_numberOfShards = numberOfShards;
+    if(m_numberOfShards == 0) {
+        m_numberOfShards = 1;
+    }
+
+    m_maxEntriesPerShard = maxNumberOfEntries / m_numberOfShards;
+    if(m_maxEntriesPerShard == 0) {
+        m_maxEntriesPerShard = 1;
+    }
+
+    m_shards = new CacheShard[m_numberOfShards];
+
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+}
+
+/**
+ * @brief destructor
+ */
+UserCache::~UserCache()
+{
+    delete[] m_shards;
+}
+
+/**
+ * @brief get the shard, which is responsible for a user
+ *
+ * @param userId id of the user
+ *
+ * @return pointer to the shard
+ */
+UserCache::CacheShard*
+UserCache::getShard(const std::string &userId) const
+{
+    return &m_shards[std::hash<std::string>{}(userId) % m_numberOfShards];
+}
+
+/**
+ * @brief get current time in seconds
+ */
+int64_t
+UserCache::getCurrentTime() const
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief get a copy of a cached user
+ *
+ * @param result reference for the cached user
+ * @param userId id of the requested user
+ *
+ * @return true, if user was found, else false
+ */
+bool
+UserCache::get(CachedUser &result,
+               const std::string &userId)
+{
+    CacheShard* shard = getShard(userId);
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    auto it = shard->entries.find(userId);
+    if(it == shard->entries.end())
+    {
+        m_misses++;
+        return false;
+    }
+
+    // expired entries are removed, so a missed invalidation can not be valid forever
+    if(it->second->expiresAt <= getCurrentTime())
+    {
+        shard->memoryUsage -= getSize(*it->second);
+        shard->lruList.erase(it->second);
+        shard->entries.erase(it);
+        m_misses++;
+        return false;
+    }
+
+    // move entry to the front of the lru-list
+    shard->lruList.splice(shard->lruList.begin(), shard->lruList, it->second);
+    result = *it->second;
+    m_hits++;
+
+    return true;
+}
+
+/**
+ * @brief get the current version of the shard of a user. This has to be requested before the
+ *        user is read from the database, so a change in the meantime can be detected by add.
+ *
+ * @param userId id of the user
+ *
+ * @return current version
+ */
+uint64_t
+UserCache::getVersion(const std::string &userId)
+{
+    CacheShard* shard = getShard(userId);
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    return shard->version;
+}
+
+/**
+ * @brief add a user, which was read from the database, to the cache
+ *
+ * @param user user to add
+ * @param readVersion version of the shard, before the user was read from the database
+ *
+ * @return false, if the shard was changed since the read and so the user was not added,
+ *         else true
+ */
+bool
+UserCache::add(const CachedUser &user,
+               const uint64_t readVersion)
+{
+    CacheShard* shard = getShard(user.id);
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    // the read can be older than a change of the user, which is already written to the database
+    if(shard->version != readVersion) {
+        return false;
+    }
+
+    // an entry, which was added by a parallel read, is at least as new as this one
+    if(shard->entries.find(user.id) != shard->entries.end()) {
+        return true;
+    }
+
+    // remove least recently used entry, if shard is full
+    if(shard->entries.size() >= m_maxEntriesPerShard)
+    {
+        shard->memoryUsage -= getSize(shard->lruList.back());
+        shard->entries.erase(shard->lruList.back().id);
+        shard->lruList.pop_back();
+        m_evictions++;
+    }
+
+    shard->lruList.push_front(user);
+    shard->lruList.front().version = shard->version;
+    shard->lruList.front().expiresAt = getCurrentTime() + m_timeToLive;
+    shard->entries.emplace(user.id, shard->lruList.begin());
+    shard->memoryUsage += getSize(shard->lruList.front());
+
+    return true;
+}
+
+/**
+ * @brief remove a user from the cache
+ *
+ * @param userId id of the user to remove
+ */
+void
+UserCache::remove(const std::string &userId)
+{
+    CacheShard* shard = getShard(userId);
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    // the version is also changed without entry, because a parallel read could add it again
+    shard->version++;
+
+    auto it = shard->entries.find(userId);
+    if(it == shard->entries.end()) {
+        return;
+    }
+
+    shard->memoryUsage -= getSize(*it->second);
+    shard->lruList.erase(it->second);
+    shard->entries.erase(it);
+}
+
+/**
+ * @brief add a project to a cached user, after it was added within the database
+ *
+ * @param userId id of the user
+ * @param project new project of the user
+ */
+void
+UserCache::addProject(const std::string &userId,
+                      const CachedProject &project)
+{
+    CacheShard* shard = getShard(userId);
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    shard->version++;
+
+    auto it = shard->entries.find(userId);
+    if(it == shard->entries.end()) {
+        return;
+    }
+
+    // the entry can already contain the project, if it was read after the change
+    for(const CachedProject &existingProject : it->second->projects)
+    {
+        if(existingProject.projectId == project.projectId) {
+            return;
+        }
+    }
+
+    CachedUser newValue = *it->second;
+    newValue.projects.push_back(project);
+    changeEntry(shard, it->second, newValue);
+}
+
+/**
+ * @brief remove a project from a cached user, after it was removed within the database
+ *
+ * @param userId id of the user
+ * @param projectId id of the removed project
+ */
+void
+UserCache::removeProject(const std::string &userId,
+                         const std::string &projectId)
+{
+    CacheShard* shard = getShard(userId);
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    shard->version++;
+
+    auto it = shard->entries.find(userId);
+    if(it == shard->entries.end()) {
+        return;
+    }
+
+    CachedUser newValue = *it->second;
+    for(uint64_t i = 0; i < newValue.projects.size(); i++)
+    {
+        if(newValue.projects[i].projectId == projectId)
+        {
+            newValue.projects.erase(newValue.projects.begin() + i);
+            changeEntry(shard, it->second, newValue);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief replace the password-hash of a cached user, but only if it was not changed in the
+ *        meantime, like the update within the database
+ *
+ * @param userId id of the user
+ * @param oldPwHash password-hash, which should be replaced
+ * @param newPwHash new password-hash
+ */
+void
+UserCache::updatePasswordHash(const std::string &userId,
+                              const std::string &oldPwHash,
+                              const std::string &newPwHash)
+{
+    CacheShard* shard = getShard(userId);
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    shard->version++;
+
+    auto it = shard->entries.find(userId);
+    if(it == shard->entries.end()
+            || it->second->pwHash != oldPwHash)
+    {
+        return;
+    }
+
+    CachedUser newValue = *it->second;
+    newValue.pwHash = newPwHash;
+    changeEntry(shard, it->second, newValue);
+}
+
+/**
+ * @brief replace the value of an entry and update the memory-usage of the shard. The lock of
+ *        the shard must be hold by the caller.
+ *
+ * @param shard shard of the entry
+ * @param entry entry to change
+ * @param newValue new value of the entry
+ */
+void
+UserCache::changeEntry(CacheShard* shard,
+                       std::list<CachedUser>::iterator entry,
+                       const CachedUser &newValue)
+{
+    shard->memoryUsage -= getSize(*entry);
+    *entry = newValue;
+    entry->version = shard->version;
+    shard->memoryUsage += getSize(*entry);
+}
+
+/**
+ * @brief estimate the memory, which is used by a cached user
+ *
+ * @param user cached user
+ *
+ * @return number of bytes
+ */
+uint64_t
+UserCache::getSize(const CachedUser &user) const
+{
+    // the map-entry contains a copy of the id
+    uint64_t size = sizeof(CachedUser) + 2 * user.id.capacity();
+    size += user.name.capacity();
+    size += user.creatorId.capacity();
+    size += user.pwHash.capacity();
+    size += user.salt.capacity();
+    size += user.projects.capacity() * sizeof(CachedProject);
+    for(const CachedProject &project : user.projects) {
+        size += project.projectId.capacity() + project.role.capacity();
+    }
+
+    return size;
+}
+
+/**
+ * @brief get number of cache-hits
+ */
+uint64_t
+UserCache::getNumberOfHits() const
+{
+    return m_hits;
+}
+
+/**
+ * @brief get number of cache-misses
+ */
+uint64_t
+UserCache::getNumberOfMisses() const
+{
+    return m_misses;
+}
+
+/**
+ * @brief get number of entries, which were removed because of the size-limit
+ */
+uint64_t
+UserCache::getNumberOfEvictions() const
+{
+    return m_evictions;
+}
+
+/**
+ * @brief get number of users, which are currently in the cache
+ */
+uint64_t
+UserCache::getNumberOfEntries()
+{
+    uint64_t result = 0;
+    for(uint32_t i = 0; i < m_numberOfShards; i++)
+    {
+        std::lock_guard<std::mutex> guard(m_shards[i].lock);
+        result += m_shards[i].entries.size();
+    }
+
+    return result;
+}
+
+/**
+ * @brief get estimated number of bytes, which are used by the cached users
+ */
+uint64_t
+UserCache::getMemoryUsage()
+{
+    uint64_t result = 0;
+    for(uint32_t i = 0; i < m_numberOfShards; i++)
+    {
+        std::lock_guard<std::mutex> guard(m_shards[i].lock);
+        result += m_shards[i].memoryUsage;
+    }
+
+    return result;
+}
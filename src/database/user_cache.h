@@ -0,0 +1,109 @@
+/**
+ * @file        user_cache.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_USER_CACHE_H
+#define MISAKIGUARD_USER_CACHE_H
+
+#include <string>
+#include <stdint.h>
+#include <list>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+struct CachedProject
+{
+    std::string projectId = "";
+    std::string role = "";
+    bool isProjectAdmin = false;
+};
+
+struct CachedUser
+{
+    std::string id = "";
+    std::string name = "";
+    std::string creatorId = "";
+    std::string pwHash = "";
+    std::string salt = "";
+    bool isAdmin = false;
+    std::vector<CachedProject> projects;
+
+    // version of the shard at the last change of the record
+    uint64_t version = 0;
+    // time in seconds, after which the record has to be read again from the database
+    int64_t expiresAt = 0;
+};
+
+class UserCache
+{
+public:
+    UserCache(const uint64_t maxNumberOfEntries,
+              const uint32_t timeToLive,
+              const uint32_t numberOfShards = 16);
+    ~UserCache();
+
+    bool get(CachedUser &result, const std::string &userId);
+    uint64_t getVersion(const std::string &userId);
+    bool add(const CachedUser &user, const uint64_t readVersion);
+
+    void remove(const std::string &userId);
+    void addProject(const std::string &userId, const CachedProject &project);
+    void removeProject(const std::string &userId, const std::string &projectId);
+    void updatePasswordHash(const std::string &userId,
+                            const std::string &oldPwHash,
+                            const std::string &newPwHash);
+
+    uint64_t getNumberOfHits() const;
+    uint64_t getNumberOfMisses() const;
+    uint64_t getNumberOfEvictions() const;
+    uint64_t getNumberOfEntries();
+    uint64_t getMemoryUsage();
+
+private:
+    struct CacheShard
+    {
+        std::mutex lock;
+        uint64_t version = 0;
+        uint64_t memoryUsage = 0;
+        std::list<CachedUser> lruList;
+        std::unordered_map<std::string, std::list<CachedUser>::iterator> entries;
+    };
+
+    CacheShard* m_shards = nullptr;
+    uint32_t m_numberOfShards = 0;
+    uint64_t m_maxEntriesPerShard = 0;
+    uint32_t m_timeToLive = 0;
+
+    std::atomic<uint64_t> m_hits;
+    std::atomic<uint64_t> m_misses;
+    std::atomic<uint64_t> m_evictions;
+
+    CacheShard* getShard(const std::string &userId) const;
+    int64_t getCurrentTime() const;
+    void changeEntry(CacheShard* shard,
+                     std::list<CachedUser>::iterator entry,
+                     const CachedUser &newValue);
+    uint64_t getSize(const CachedUser &user) const;
+};
+
+#endif // MISAKIGUARD_USER_CACHE_H
@@ -0,0 +1,434 @@
+/**
+ * @file        user_projects_table.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <database/user_projects_table.h>
+
+#include <libKitsunemimiCommon/items/table_item.h>
+#include <libKitsunemimiJson/json_item.h>
+
+#include <libKitsunemimiSakuraDatabase/sql_database.h>
+
+#include <database/sql_connection.h>
+#include <database/sql_connection_pool.h>
+#include <database/user_cache.h>
+
+// insert, which keeps an already existing assignment
+static const std::string addProjectStatement = "INSERT OR IGNORE INTO user_projects "
+                                               "(user_id, project_id, role, is_project_admin) "
+                                               "VALUES (?, ?, ?, ?);";
+
+/**
+ * @brief constructor
+ *
+ * @param db database for the creation of the table
+ * @param connectionPool connections with prepared statements for the lookups and all changes
+ */
+UserProjectsTable::UserProjectsTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                                     SqlConnectionPool* connectionPool)
+    : SqlTable(db)
+{
+    m_tableName = "user_projects";
+    m_connectionPool = connectionPool;
+
+    DbHeaderEntry userId;
+    userId.name = "user_id";
+    userId.maxLength = 256;
+    userId.isPrimary = true;
+    m_tableHeader.push_back(userId);
+
+    DbHeaderEntry projectId;
+    projectId.name = "project_id";
+    projectId.maxLength = 256;
+    projectId.isPrimary = true;
+    m_tableHeader.push_back(projectId);
+
+    DbHeaderEntry role;
+    role.name = "role";
+    role.maxLength = 256;
+    m_tableHeader.push_back(role);
+
+    DbHeaderEntry isProjectAdmin;
+    isProjectAdmin.name = "is_project_admin";
+    isProjectAdmin.type = INT_TYPE;
+    m_tableHeader.push_back(isProjectAdmin);
+}
+
+/**
+ * @brief destructor
+ */
+UserProjectsTable::~UserProjectsTable() {}
+
+/**
+ * @brief create the table with a composite primary key over user and project, which is used
+ *        by the lookups of the projects of a user, and a reverse index to find the users of
+ *        a project. The generic table-creation supports only single primary keys, so the
+ *        table is created here.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UserProjectsTable::createTable(Kitsunemimi::ErrorContainer &error)
+{
+    const std::string command = "CREATE TABLE IF NOT EXISTS user_projects ("
+                                "user_id varchar(256) NOT NULL, "
+                                "project_id varchar(256) NOT NULL, "
+                                "role varchar(256) NOT NULL, "
+                                "is_project_admin int NOT NULL, "
+                                "PRIMARY KEY (user_id, project_id)); "
+                                "CREATE INDEX IF NOT EXISTS user_projects_project_id "
+                                "ON user_projects (project_id, user_id);";
+
+    Kitsunemimi::TableItem result;
+    if(m_db->execSqlCommand(&result, command, error) == false)
+    {
+        error.addMeesage("Failed to create table 'user_projects'");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief create an entry for the project-list of a user
+ *
+ * @param projectId id of the project
+ * @param role role of the user within the project
+ * @param isProjectAdmin '1', if user is admin within the project
+ *
+ * @return new map with the values of the entry
+ */
+Kitsunemimi::DataItem*
+UserProjectsTable::createEntry(const std::string &projectId,
+                               const std::string &role,
+                               const std::string &isProjectAdmin) const
+{
+    Kitsunemimi::DataMap* entry = new Kitsunemimi::DataMap();
+    entry->insert("project_id", new Kitsunemimi::DataValue(projectId));
+    entry->insert("role", new Kitsunemimi::DataValue(role));
+    entry->insert("is_project_admin", new Kitsunemimi::DataValue(isProjectAdmin == "1"));
+
+    return entry;
+}
+
+/**
+ * @brief assign a project to a user with a single insert
+ *
+ * @param added reference for the result, false, if project was already assigned to the user
+ * @param userId id of the user
+ * @param projectId id of the project
+ * @param role role of the user within the project
+ * @param isProjectAdmin true, if user is admin within the project
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UserProjectsTable::addProjectToUser(bool &added,
+                                    const std::string &userId,
+                                    const std::string &projectId,
+                                    const std::string &role,
+                                    const bool isProjectAdmin,
+                                    Kitsunemimi::ErrorContainer &error)
+{
+    const std::vector<std::string> values = {userId,
+                                             projectId,
+                                             role,
+                                             isProjectAdmin ? "1" : "0"};
+
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, addProjectStatement, values, error) == false)
+    {
+        error.addMeesage("Failed to add project with id '"
+                         + projectId
+                         + "' to user with id '"
+                         + userId
+                         + "'");
+        return false;
+    }
+
+    added = numberOfChanges != 0;
+
+    return true;
+}
+
+/**
+ * @brief assign a project to a user within a running transaction of the writer
+ *
+ * @param added reference for the result, false, if project was already assigned to the user
+ * @param userId id of the user
+ * @param projectId id of the project
+ * @param role role of the user within the project
+ * @param isProjectAdmin true, if user is admin within the project
+ * @param writer writer-connection of the transaction
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UserProjectsTable::addProjectToUser(bool &added,
+                                    const std::string &userId,
+                                    const std::string &projectId,
+                                    const std::string &role,
+                                    const bool isProjectAdmin,
+                                    SqlConnection &writer,
+                                    Kitsunemimi::ErrorContainer &error)
+{
+    const std::vector<std::string> values = {userId,
+                                             projectId,
+                                             role,
+                                             isProjectAdmin ? "1" : "0"};
+
+    uint64_t numberOfChanges = 0;
+    if(writer.execute(numberOfChanges, addProjectStatement, values, error) == false)
+    {
+        error.addMeesage("Failed to add project with id '"
+                         + projectId
+                         + "' to user with id '"
+                         + userId
+                         + "'");
+        return false;
+    }
+
+    added = numberOfChanges != 0;
+
+    return true;
+}
+
+/**
+ * @brief remove a project from a user with a single delete
+ *
+ * @param removed reference for the result, false, if project was not assigned to the user
+ * @param userId id of the user
+ * @param projectId id of the project
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UserProjectsTable::removeProjectFromUser(bool &removed,
+                                         const std::string &userId,
+                                         const std::string &projectId,
+                                         Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "DELETE FROM user_projects "
+                                         "WHERE user_id = ? AND project_id = ?;";
+
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, statement, {userId, projectId}, error) == false)
+    {
+        error.addMeesage("Failed to remove project with id '"
+                         + projectId
+                         + "' from user with id '"
+                         + userId
+                         + "'");
+        return false;
+    }
+
+    removed = numberOfChanges != 0;
+
+    return true;
+}
+
+/**
+ * @brief get all projects of a user in the order, in which they were assigned
+ *
+ * @param result reference for the list of projects
+ * @param userId id of the user
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UserProjectsTable::getProjectsOfUser(std::vector<CachedProject> &result,
+                                     const std::string &userId,
+                                     Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "SELECT project_id, role, is_project_admin "
+                                         "FROM user_projects WHERE user_id = ? ORDER BY rowid;";
+
+    Kitsunemimi::TableItem table;
+    if(m_connectionPool->read(table, statement, {userId}, error) == false)
+    {
+        error.addMeesage("Failed to get projects of user with id '" + userId + "'");
+        return false;
+    }
+
+    result.resize(table.getNumberOfRows());
+    for(uint64_t row = 0; row < table.getNumberOfRows(); row++)
+    {
+        result[row].projectId = table.getCell(0, row);
+        result[row].role = table.getCell(1, row);
+        result[row].isProjectAdmin = table.getCell(2, row) == "1";
+    }
+
+    return true;
+}
+
+/**
+ * @brief get the projects of a range of users with one request, which uses the primary key
+ *        to find only the entries of the range
+ *
+ * @param result reference for the lists of projects per user-id, which have to be deleted by
+ *               the caller
+ * @param firstUserId first user-id of the range
+ * @param lastUserId last user-id of the range
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UserProjectsTable::getProjectsOfUsers(std::map<std::string, Kitsunemimi::DataArray*> &result,
+                                      const std::string &firstUserId,
+                                      const std::string &lastUserId,
+                                      Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "SELECT user_id, project_id, role, is_project_admin "
+                                         "FROM user_projects "
+                                         "WHERE user_id >= ? AND user_id <= ? "
+                                         "ORDER BY user_id, rowid;";
+
+    Kitsunemimi::TableItem table;
+    if(m_connectionPool->read(table, statement, {firstUserId, lastUserId}, error) == false)
+    {
+        error.addMeesage("Failed to get projects of the users from '"
+                         + firstUserId
+                         + "' to '"
+                         + lastUserId
+                         + "'");
+        return false;
+    }
+
+    for(uint64_t row = 0; row < table.getNumberOfRows(); row++)
+    {
+        Kitsunemimi::DataArray* &projects = result[table.getCell(0, row)];
+        if(projects == nullptr) {
+            projects = new Kitsunemimi::DataArray();
+        }
+        projects->append(createEntry(table.getCell(1, row),
+                                     table.getCell(2, row),
+                                     table.getCell(3, row)));
+    }
+
+    return true;
+}
+
+/**
+ * @brief remove all projects from a user
+ *
+ * @param userId id of the user
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UserProjectsTable::deleteProjectsOfUser(const std::string &userId,
+                                        Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "DELETE FROM user_projects WHERE user_id = ?;";
+
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, statement, {userId}, error) == false)
+    {
+        error.addMeesage("Failed to delete projects of user with id '" + userId + "'");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get all members of a project by the reverse index
+ *
+ * @param result reference for the list of members
+ * @param projectId id of the project
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UserProjectsTable::getMembersOfProject(Kitsunemimi::DataArray &result,
+                                       const std::string &projectId,
+                                       Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "SELECT user_id, role, is_project_admin "
+                                         "FROM user_projects WHERE project_id = ? "
+                                         "ORDER BY user_id;";
+
+    Kitsunemimi::TableItem table;
+    if(m_connectionPool->read(table, statement, {projectId}, error) == false)
+    {
+        error.addMeesage("Failed to get members of project with id '" + projectId + "'");
+        return false;
+    }
+
+    for(uint64_t row = 0; row < table.getNumberOfRows(); row++)
+    {
+        Kitsunemimi::DataMap* entry = new Kitsunemimi::DataMap();
+        entry->insert("user_id", new Kitsunemimi::DataValue(table.getCell(0, row)));
+        entry->insert("role", new Kitsunemimi::DataValue(table.getCell(1, row)));
+        entry->insert("is_project_admin", new Kitsunemimi::DataValue(table.getCell(2, row) == "1"));
+        result.append(entry);
+    }
+
+    return true;
+}
+
+/**
+ * @brief delete all memberships of a project within a running transaction of the writer. The
+ *        memberships are found by the reverse index, so the costs depend only on the number
+ *        of members.
+ *
+ * @param memberIds reference for the ids of the users, which were member of the project
+ * @param projectId id of the project
+ * @param writer writer-connection of the transaction
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UserProjectsTable::deleteMembershipsOfProject(std::vector<std::string> &memberIds,
+                                              const std::string &projectId,
+                                              SqlConnection &writer,
+                                              Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string selectStatement = "SELECT user_id FROM user_projects "
+                                               "WHERE project_id = ?;";
+    static const std::string deleteStatement = "DELETE FROM user_projects WHERE project_id = ?;";
+
+    Kitsunemimi::TableItem table;
+    uint64_t numberOfChanges = 0;
+    if(writer.execute(table, selectStatement, {projectId}, error) == false
+            || writer.execute(numberOfChanges, deleteStatement, {projectId}, error) == false)
+    {
+        error.addMeesage("Failed to delete memberships of project with id '" + projectId + "'");
+        return false;
+    }
+
+    memberIds.clear();
+    for(uint64_t row = 0; row < table.getNumberOfRows(); row++) {
+        memberIds.push_back(table.getCell(0, row));
+    }
+
+    return true;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file        user_projects_table.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2021 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MISAKIGUARD_USER_PROJECTS_TABLE_H
+#define MISAKIGUARD_USER_PROJECTS_TABLE_H
+
+#include <map>
+#include <vector>
+
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiSakuraDatabase/sql_table.h>
+
+namespace Kitsunemimi {
+class DataItem;
+class DataArray;
+}
+class SqlConnectionPool;
+class SqlConnection;
+struct CachedProject;
+
+class UserProjectsTable
+        : public Kitsunemimi::Sakura::SqlTable
+{
+public:
+    UserProjectsTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                      SqlConnectionPool* connectionPool);
+    ~UserProjectsTable();
+
+    bool createTable(Kitsunemimi::ErrorContainer &error);
+
+    bool addProjectToUser(bool &added,
+                          const std::string &userId,
+                          const std::string &projectId,
+                          const std::string &role,
+                          const bool isProjectAdmin,
+                          Kitsunemimi::ErrorContainer &error);
+    bool addProjectToUser(bool &added,
+                          const std::string &userId,
+                          const std::string &projectId,
+                          const std::string &role,
+                          const bool isProjectAdmin,
+                          SqlConnection &writer,
+                          Kitsunemimi::ErrorContainer &error);
+    bool removeProjectFromUser(bool &removed,
+                               const std::string &userId,
+                               const std::string &projectId,
+                               Kitsunemimi::ErrorContainer &error);
+    bool getProjectsOfUser(std::vector<CachedProject> &result,
+                           const std::string &userId,
+                           Kitsunemimi::ErrorContainer &error);
+    bool getProjectsOfUsers(std::map<std::string, Kitsunemimi::DataArray*> &result,
+                            const std::string &firstUserId,
+                            const std::string &lastUserId,
+                            Kitsunemimi::ErrorContainer &error);
+    bool deleteProjectsOfUser(const std::string &userId,
+                              Kitsunemimi::ErrorContainer &error);
+    bool getMembersOfProject(Kitsunemimi::DataArray &result,
+                             const std::string &projectId,
+                             Kitsunemimi::ErrorContainer &error);
+    bool deleteMembershipsOfProject(std::vector<std::string> &memberIds,
+                                    const std::string &projectId,
+                                    SqlConnection &writer,
+                                    Kitsunemimi::ErrorContainer &error);
+
+private:
+    SqlConnectionPool* m_connectionPool = nullptr;
+
+    Kitsunemimi::DataItem* createEntry(const std::string &projectId,
+                                       const std::string &role,
+                                       const std::string &isProjectAdmin) const;
+};
+
+#endif // MISAKIGUARD_USER_PROJECTS_TABLE_H
@@ -25,18 +25,30 @@
 #include <libKitsunemimiCommon/items/table_item.h>
 #include <libKitsunemimiCommon/methods/string_methods.h>
 #include <libKitsunemimiJson/json_item.h>
-#include <libKitsunemimiCrypto/hashes.h>
+#include <libKitsunemimiHanamiCommon/uuid.h>
 
 #include <libKitsunemimiSakuraDatabase/sql_database.h>
 
+#include <database/user_projects_table.h>
+#include <database/sql_connection.h>
+#include <database/sql_connection_pool.h>
+#include <core/password_hashing.h>
+
 /**
  * @brief constructor
  */
-UsersTable::UsersTable(Kitsunemimi::Sakura::SqlDatabase* db)
-    : HanamiSqlAdminTable(db)
+UsersTable::UsersTable(Kitsunemimi::Sakura::SqlDatabase* db,
+                       SqlConnectionPool* connectionPool,
+                       UserProjectsTable* userProjectsTable,
+                       UserCache* userCache)
+    : PreparedSqlAdminTable(db, connectionPool)
 {
     m_tableName = "users";
+    m_userProjectsTable = userProjectsTable;
+    m_userCache = userCache;
 
+    // projects are stored in the table 'user_projects'. This column only contains the projects
+    // of old entries until they are migrated at the start.
     DbHeaderEntry projects;
     projects.name = "projects";
     m_tableHeader.push_back(projects);
@@ -48,7 +60,8 @@ UsersTable::UsersTable(Kitsunemimi::Sakura::SqlDatabase* db)
 
     DbHeaderEntry pwHash;
     pwHash.name = "pw_hash";
-    pwHash.maxLength = 64;
+    // long enough for the versioned hash-formats
+    pwHash.maxLength = 256;
     pwHash.hide = true;
     m_tableHeader.push_back(pwHash);
 
@@ -57,6 +70,8 @@ UsersTable::UsersTable(Kitsunemimi::Sakura::SqlDatabase* db)
     saltVal.maxLength = 64;
     saltVal.hide = true;
     m_tableHeader.push_back(saltVal);
+
+    initStatements();
 }
 
 /**
@@ -113,12 +128,14 @@ UsersTable::getAllAdminUser(Kitsunemimi::ErrorContainer &error)
 /**
  * @brief try to initialize a new admin-user in database
  *
+ * @param hashIterations number of iterations for the hashing of the password
  * @param error reference for error-output
  *
  * @return true, if seccuessful, else false
  */
 bool
-UsersTable::initNewAdminUser(Kitsunemimi::ErrorContainer &error)
+UsersTable::initNewAdminUser(const uint32_t hashIterations,
+                             Kitsunemimi::ErrorContainer &error)
 {
     std::string userId = "";
     std::string userName = "";
@@ -157,11 +174,15 @@ UsersTable::initNewAdminUser(Kitsunemimi::ErrorContainer &error)
         return false;
     }
 
-    // generate hash from password
+    // generate hash from password and random salt
     std::string pwHash;
-    const std::string salt = "e307bee0-9286-49bd-9273-6f644c12da1d";
-    const std::string saltedPw = pw + salt;
-    Kitsunemimi::generate_SHA_256(pwHash, saltedPw);
+    const std::string salt = Kitsunemimi::Hanami::generateUuid().toString();
+    if(hashPassword(pwHash, pw, salt, hashIterations) == false)
+    {
+        error.addMeesage("Failed to hash password of new initial admin-user");
+        LOG_ERROR(error);
+        return false;
+    }
 
     Kitsunemimi::JsonItem userData;
     userData.insert("id", userId);
@@ -173,7 +194,9 @@ UsersTable::initNewAdminUser(Kitsunemimi::ErrorContainer &error)
     userData.insert("salt", salt);
 
     // add new admin-user to db
-    if(addUser(userData, error) == false)
+    bool added = false;
+    if(addUser(added, userData, error) == false
+            || added == false)
     {
         error.addMeesage("Failed to add new initial admin-user to database");
         LOG_ERROR(error);
@@ -186,26 +209,31 @@ UsersTable::initNewAdminUser(Kitsunemimi::ErrorContainer &error)
 /**
  * @brief add a new user to the database
  *
+ * @param added reference for the result, false, if a user with the same id already exist
  * @param userData json-item with all information of the user to add to database
  * @param error reference for error-output
  *
  * @return true, if successful, else false
  */
 bool
-UsersTable::addUser(Kitsunemimi::JsonItem &userData,
+UsersTable::addUser(bool &added,
+                    Kitsunemimi::JsonItem &userData,
                     Kitsunemimi::ErrorContainer &error)
 {
-    if(insertToDb(userData, error) == false)
+    if(insertNewToDb(added, userData, error) == false)
     {
         error.addMeesage("Failed to add user to database");
         return false;
     }
 
+    // the user is added to the cache at its first read
+    m_userCache->remove(userData.get("id").getString());
+
     return true;
 }
 
 /**
- * @brief get a user from the database
+ * @brief get a user from the cache or from the database, if not cached
  *
  * @param result reference for the result-output in case that a user with this name was found
  * @param userId id of the requested user
@@ -220,41 +248,291 @@ UsersTable::getUser(Kitsunemimi::JsonItem &result,
                     Kitsunemimi::ErrorContainer &error,
                     const bool showHiddenValues)
 {
-    std::vector<RequestCondition> conditions;
-    conditions.emplace_back("id", userId);
+    CachedUser user;
+    if(getCachedUser(user, userId, error) == false)
+    {
+        LOG_ERROR(error);
+        return false;
+    }
+
+    convertUser(result, user, showHiddenValues);
+
+    return true;
+}
+
+/**
+ * @brief get only the values of a user, which are necessary to select a project for a token.
+ *        If the user is not cached, only these columns are read from the database and the
+ *        incomplete entry is not added to the cache.
+ *
+ * @param result reference for the result-output
+ * @param userId id of the requested user
+ * @param error reference for error-output
+ *
+ * @return false, if user was not found or the request failed, else true
+ */
+bool
+UsersTable::getUserMemberships(UserMemberships &result,
+                               const std::string &userId,
+                               Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "SELECT name, is_admin FROM users WHERE id = ?;";
 
-    // get user from db
-    if(getFromDb(result, conditions, error, showHiddenValues) == false)
+    CachedUser user;
+    if(m_userCache->get(user, userId))
+    {
+        result.id = user.id;
+        result.name = user.name;
+        result.isAdmin = user.isAdmin;
+        result.projects = std::move(user.projects);
+        return true;
+    }
+
+    Kitsunemimi::TableItem table;
+    if(m_connectionPool->read(table, statement, {userId}, error) == false) {
+        return false;
+    }
+
+    if(table.getNumberOfRows() == 0)
+    {
+        error.addMeesage("User with id '" + userId + "' not found in database");
+        return false;
+    }
+
+    if(m_userProjectsTable->getProjectsOfUser(result.projects, userId, error) == false) {
+        return false;
+    }
+
+    const std::string isAdmin = table.getCell(1, 0);
+    result.id = userId;
+    result.name = table.getCell(0, 0);
+    result.isAdmin = isAdmin == "true" || isAdmin == "1";
+
+    return true;
+}
+
+/**
+ * @brief get the values of a user, which are necessary for a login. These are nearly all
+ *        values of the user, so the complete user is read and added to the cache.
+ *
+ * @param result reference for the result-output
+ * @param userId id of the requested user
+ * @param error reference for error-output
+ *
+ * @return false, if user was not found or the request failed, else true
+ */
+bool
+UsersTable::getUserCredentials(UserCredentials &result,
+                               const std::string &userId,
+                               Kitsunemimi::ErrorContainer &error)
+{
+    CachedUser user;
+    if(getCachedUser(user, userId, error) == false) {
+        return false;
+    }
+
+    result.user.id = user.id;
+    result.user.name = user.name;
+    result.user.isAdmin = user.isAdmin;
+    result.user.projects = std::move(user.projects);
+    result.pwHash = user.pwHash;
+    result.salt = user.salt;
+
+    return true;
+}
+
+/**
+ * @brief check if a user exist, without reading any values of the user
+ *
+ * @param exists reference for the result, if the user exist
+ * @param userId id of the requested user
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UsersTable::existsUser(bool &exists,
+                       const std::string &userId,
+                       Kitsunemimi::ErrorContainer &error)
+{
+    CachedUser user;
+    if(m_userCache->get(user, userId))
+    {
+        exists = true;
+        return true;
+    }
+
+    return existsInDb(exists, userId, error);
+}
+
+/**
+ * @brief get a user from the cache or from the database, if not cached
+ *
+ * @param user reference for the user
+ * @param userId id of the requested user
+ * @param error reference for error-output
+ *
+ * @return false, if user was not found or the request failed, else true
+ */
+bool
+UsersTable::getCachedUser(CachedUser &user,
+                          const std::string &userId,
+                          Kitsunemimi::ErrorContainer &error)
+{
+    if(m_userCache->get(user, userId)) {
+        return true;
+    }
+
+    // version has to be read before the database, so a change in the meantime is not cached
+    const uint64_t version = m_userCache->getVersion(userId);
+    if(loadUser(user, userId, error) == false) {
+        return false;
+    }
+    m_userCache->add(user, version);
+
+    return true;
+}
+
+/**
+ * @brief read a user together with its projects from the database
+ *
+ * @param user reference for the user
+ * @param userId id of the requested user
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UsersTable::loadUser(CachedUser &user,
+                     const std::string &userId,
+                     Kitsunemimi::ErrorContainer &error)
+{
+    // get user from db with all values, because the entry is also used for later requests
+    Kitsunemimi::JsonItem userData;
+    if(getByIdFromDb(userData, userId, error, true) == false)
     {
         error.addMeesage("Failed to get user with id '"
                          + userId
                          + "' from database");
-        LOG_ERROR(error);
         return false;
     }
 
+    // get projects of the user
+    if(m_userProjectsTable->getProjectsOfUser(user.projects, userId, error) == false) {
+        return false;
+    }
+
+    user.id = userData.get("id").getString();
+    user.name = userData.get("name").getString();
+    user.creatorId = userData.get("creator_id").getString();
+    user.isAdmin = userData.get("is_admin").getBool();
+    user.pwHash = userData.get("pw_hash").getString();
+    user.salt = userData.get("salt").getString();
+
     return true;
 }
 
 /**
- * @brief get all users from the database table
+ * @brief convert a user into the json-format of the generic table-requests
+ *
+ * @param result reference for the output
+ * @param user user to convert
+ * @param showHiddenValues set to true to also show as hidden marked fields
+ */
+void
+UsersTable::convertUser(Kitsunemimi::JsonItem &result,
+                        const CachedUser &user,
+                        const bool showHiddenValues) const
+{
+    Kitsunemimi::DataArray* projects = new Kitsunemimi::DataArray();
+    for(const CachedProject &project : user.projects)
+    {
+        Kitsunemimi::DataMap* entry = new Kitsunemimi::DataMap();
+        entry->insert("project_id", new Kitsunemimi::DataValue(project.projectId));
+        entry->insert("role", new Kitsunemimi::DataValue(project.role));
+        entry->insert("is_project_admin", new Kitsunemimi::DataValue(project.isProjectAdmin));
+        projects->append(entry);
+    }
+
+    result.insert("id", user.id, true);
+    result.insert("name", user.name, true);
+    result.insert("creator_id", user.creatorId, true);
+    result.insert("is_admin", user.isAdmin, true);
+    result.insert("projects", projects, true);
+
+    if(showHiddenValues)
+    {
+        result.insert("pw_hash", user.pwHash, true);
+        result.insert("salt", user.salt, true);
+    }
+}
+
+/**
+ * @brief get a page of users ordered by their id from the database table
  *
  * @param result reference for the result-output
+ * @param afterId id of the last user of the previous page, or empty for the first page
+ * @param limit maximum number of users, or -1 for all remaining users
  * @param error reference for error-output
  *
  * @return true, if successful, else false
  */
 bool
-UsersTable::getAllUser(Kitsunemimi::TableItem &result,
-                       Kitsunemimi::ErrorContainer &error)
+UsersTable::getUserPage(Kitsunemimi::TableItem &result,
+                        const std::string &afterId,
+                        const int64_t limit,
+                        Kitsunemimi::ErrorContainer &error)
 {
-    std::vector<RequestCondition> conditions;
-    if(getFromDb(result, conditions, error, false) == false)
+    if(getPageFromDb(result, afterId, limit, error) == false)
     {
-        error.addMeesage("Failed to get all users from database");
+        error.addMeesage("Failed to get users from database");
         return false;
     }
 
+    // get position of the columns within the result
+    uint32_t idColumn = 0;
+    uint32_t projectsColumn = 0;
+    for(uint32_t i = 0; i < m_tableHeader.size(); i++)
+    {
+        if(m_tableHeader[i].name == "id") {
+            idColumn = i;
+        }
+        if(m_tableHeader[i].name == "projects") {
+            projectsColumn = i;
+        }
+    }
+
+    const uint64_t numberOfRows = result.getNumberOfRows();
+    if(numberOfRows == 0) {
+        return true;
+    }
+
+    // get projects of all users of the page with one request instead of one request per user
+    std::map<std::string, Kitsunemimi::DataArray*> projectsOfUsers;
+    if(m_userProjectsTable->getProjectsOfUsers(projectsOfUsers,
+                                               result.getCell(idColumn, 0),
+                                               result.getCell(idColumn, numberOfRows - 1),
+                                               error) == false)
+    {
+        error.addMeesage("Failed to get users from database");
+        return false;
+    }
+
+    // replace the old project-column by the projects from the new table
+    for(uint64_t row = 0; row < numberOfRows; row++)
+    {
+        const auto it = projectsOfUsers.find(result.getCell(idColumn, row));
+        if(it == projectsOfUsers.end()) {
+            result.setCell(projectsColumn, row, "[]");
+        } else {
+            result.setCell(projectsColumn, row, it->second->toString());
+        }
+    }
+
+    for(auto it = projectsOfUsers.begin(); it != projectsOfUsers.end(); it++) {
+        delete it->second;
+    }
+
     return true;
 }
 
@@ -270,10 +548,14 @@ bool
 UsersTable::deleteUser(const std::string &userId,
                        Kitsunemimi::ErrorContainer &error)
 {
-    std::vector<RequestCondition> conditions;
-    conditions.emplace_back("id", userId);
+    bool deleted = false;
+    const bool success = deleteByIdFromDb(deleted, userId, error);
+
+    // remove the user from the cache before any other check, because even a failed delete can
+    // have removed the user from the database
+    m_userCache->remove(userId);
 
-    if(deleteFromDb(conditions, error) == false)
+    if(success == false)
     {
         error.addMeesage("Failed to delete user with id '"
                          + userId
@@ -281,36 +563,227 @@ UsersTable::deleteUser(const std::string &userId,
         return false;
     }
 
+    if(m_userProjectsTable->deleteProjectsOfUser(userId, error) == false) {
+        return false;
+    }
+
     return true;
 }
 
 /**
- * @brief update the projects-frild of a specific user
+ * @brief assign a project to a user and add it also to the cached user
  *
- * @param userId id of the user, who has to be updated
- * @param newProjects new projects-entry for the database
+ * @param added reference for the result, false, if project was already assigned to the user
+ * @param userId id of the user
+ * @param projectId id of the project
+ * @param role role of the user within the project
+ * @param isProjectAdmin true, if user is admin within the project
  * @param error reference for error-output
  *
  * @return true, if successful, else false
  */
 bool
-UsersTable::updateProjectsOfUser(const std::string &userId,
-                                 const std::string &newProjects,
-                                 Kitsunemimi::ErrorContainer &error)
+UsersTable::addProjectToUser(bool &added,
+                             const std::string &userId,
+                             const std::string &projectId,
+                             const std::string &role,
+                             const bool isProjectAdmin,
+                             Kitsunemimi::ErrorContainer &error)
 {
-    Kitsunemimi::JsonItem newValues;
-    newValues.insert("projects", Kitsunemimi::JsonItem(newProjects));
+    if(m_userProjectsTable->addProjectToUser(added,
+                                             userId,
+                                             projectId,
+                                             role,
+                                             isProjectAdmin,
+                                             error) == false)
+    {
+        return false;
+    }
+
+    if(added)
+    {
+        CachedProject project;
+        project.projectId = projectId;
+        project.role = role;
+        project.isProjectAdmin = isProjectAdmin;
+        m_userCache->addProject(userId, project);
+    }
+
+    return true;
+}
+
+/**
+ * @brief remove a project from a user and also from the cached user
+ *
+ * @param removed reference for the result, false, if project was not assigned to the user
+ * @param userId id of the user
+ * @param projectId id of the project
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UsersTable::removeProjectFromUser(bool &removed,
+                                  const std::string &userId,
+                                  const std::string &projectId,
+                                  Kitsunemimi::ErrorContainer &error)
+{
+    if(m_userProjectsTable->removeProjectFromUser(removed, userId, projectId, error) == false) {
+        return false;
+    }
 
+    if(removed) {
+        m_userCache->removeProject(userId, projectId);
+    }
+
+    return true;
+}
+
+/**
+ * @brief move the projects of all users, which were created by an older version, from the
+ *        json-column into the table 'user_projects'. Each user is migrated in its own
+ *        transaction, so an interrupted migration is continued at the next start. Older
+ *        instances still write into the json-column, so they must be stopped before the start.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UsersTable::migrateProjects(Kitsunemimi::ErrorContainer &error)
+{
     std::vector<RequestCondition> conditions;
-    conditions.emplace_back("id", userId);
+    Kitsunemimi::TableItem users;
+    if(getFromDb(users, conditions, error, false) == false)
+    {
+        error.addMeesage("Failed to get users for the migration of their projects");
+        return false;
+    }
+
+    // get position of the columns within the result
+    uint32_t idColumn = 0;
+    uint32_t projectsColumn = 0;
+    for(uint32_t i = 0; i < m_tableHeader.size(); i++)
+    {
+        if(m_tableHeader[i].name == "id") {
+            idColumn = i;
+        }
+        if(m_tableHeader[i].name == "projects") {
+            projectsColumn = i;
+        }
+    }
+
+    uint64_t numberOfMigratedUsers = 0;
+    for(uint64_t row = 0; row < users.getNumberOfRows(); row++)
+    {
+        const std::string projectsString = users.getCell(projectsColumn, row);
+        if(projectsString == ""
+                || projectsString == "[]")
+        {
+            continue;
+        }
+
+        Kitsunemimi::JsonItem legacyProjects;
+        if(legacyProjects.parse(projectsString, error) == false)
+        {
+            error.addMeesage("Failed to parse projects of user with id '"
+                             + users.getCell(idColumn, row)
+                             + "'");
+            return false;
+        }
+
+        if(migrateProjectsOfUser(users.getCell(idColumn, row), legacyProjects, error) == false) {
+            return false;
+        }
+        numberOfMigratedUsers++;
+    }
+
+    if(numberOfMigratedUsers != 0) {
+        LOG_INFO("migrated projects of " + std::to_string(numberOfMigratedUsers) + " users");
+    }
+
+    return true;
+}
 
-    if(updateInDb(conditions, newValues, error) == false)
+/**
+ * @brief move the projects of a single user from the json-column into the table
+ *        'user_projects' and clear the json-column within one transaction. Already existing
+ *        entries are kept.
+ *
+ * @param userId id of the user
+ * @param legacyProjects projects of the user from the json-column
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UsersTable::migrateProjectsOfUser(const std::string &userId,
+                                  Kitsunemimi::JsonItem &legacyProjects,
+                                  Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "UPDATE users SET projects = '[]' WHERE id = ?;";
+
+    const std::function<bool(SqlConnection&)> migrateTask = [&](SqlConnection &writer) {
+        for(uint64_t i = 0; i < legacyProjects.size(); i++)
+        {
+            Kitsunemimi::JsonItem project = legacyProjects.get(i);
+            bool added = false;
+            if(m_userProjectsTable->addProjectToUser(added,
+                                                     userId,
+                                                     project.get("project_id").getString(),
+                                                     project.get("role").getString(),
+                                                     project.get("is_project_admin").getBool(),
+                                                     writer,
+                                                     error) == false)
+            {
+                return false;
+            }
+        }
+
+        // clear the old column, so removed projects are not migrated again
+        uint64_t numberOfChanges = 0;
+        return writer.execute(numberOfChanges, statement, {userId}, error);
+    };
+
+    if(m_connectionPool->writeTransaction(migrateTask, error) == false)
     {
-        error.addMeesage("Failed to update projects for user with id '"
+        error.addMeesage("Failed to migrate projects of user with id '" + userId + "'");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief replace the password-hash of a user, but only if it was not changed in the meantime
+ *
+ * @param userId id of the user
+ * @param oldPwHash password-hash, which should be replaced
+ * @param newPwHash new password-hash
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+UsersTable::updatePasswordHash(const std::string &userId,
+                               const std::string &oldPwHash,
+                               const std::string &newPwHash,
+                               Kitsunemimi::ErrorContainer &error)
+{
+    static const std::string statement = "UPDATE users SET pw_hash = ? "
+                                         "WHERE id = ? AND pw_hash = ?;";
+
+    const std::vector<std::string> values = {newPwHash, userId, oldPwHash};
+    uint64_t numberOfChanges = 0;
+    if(m_connectionPool->write(numberOfChanges, statement, values, error) == false)
+    {
+        error.addMeesage("Failed to update password-hash for user with id '"
                          + userId
-                         + "' from database");
+                         + "' in database");
         return false;
     }
 
+    m_userCache->updatePasswordHash(userId, oldPwHash, newPwHash);
+
     return true;
 }
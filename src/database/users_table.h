@@ -24,35 +24,97 @@
 #define MISAKIGUARD_USERS_TABLE_H
 
 #include <libKitsunemimiCommon/logger.h>
-#include <libKitsunemimiHanamiDatabase/hanami_sql_admin_table.h>
+#include <database/prepared_sql_admin_table.h>
+#include <database/user_cache.h>
 
 namespace Kitsunemimi {
 class JsonItem;
 }
+class UserProjectsTable;
+
+struct UserMemberships
+{
+    std::string id = "";
+    std::string name = "";
+    bool isAdmin = false;
+    std::vector<CachedProject> projects;
+};
+
+struct UserCredentials
+{
+    UserMemberships user;
+    std::string pwHash = "";
+    std::string salt = "";
+};
+
 class UsersTable
-        : public Kitsunemimi::Hanami::HanamiSqlAdminTable
+        : public PreparedSqlAdminTable
 {
 public:
-    UsersTable(Kitsunemimi::Sakura::SqlDatabase* db);
+    UsersTable(Kitsunemimi::Sakura::SqlDatabase* db,
+               SqlConnectionPool* connectionPool,
+               UserProjectsTable* userProjectsTable,
+               UserCache* userCache);
     ~UsersTable();
 
-    bool initNewAdminUser(Kitsunemimi::ErrorContainer &error);
+    bool initNewAdminUser(const uint32_t hashIterations,
+                          Kitsunemimi::ErrorContainer &error);
 
-    bool addUser(Kitsunemimi::JsonItem &userData,
+    bool addUser(bool &added,
+                 Kitsunemimi::JsonItem &userData,
                  Kitsunemimi::ErrorContainer &error);
     bool getUser(Kitsunemimi::JsonItem &result,
                  const std::string &userId,
                  Kitsunemimi::ErrorContainer &error,
                  const bool showHiddenValues);
-    bool getAllUser(Kitsunemimi::TableItem &result,
+    bool getUserMemberships(UserMemberships &result,
+                            const std::string &userId,
+                            Kitsunemimi::ErrorContainer &error);
+    bool getUserCredentials(UserCredentials &result,
+                            const std::string &userId,
+                            Kitsunemimi::ErrorContainer &error);
+    bool existsUser(bool &exists,
+                    const std::string &userId,
                     Kitsunemimi::ErrorContainer &error);
+    bool getUserPage(Kitsunemimi::TableItem &result,
+                     const std::string &afterId,
+                     const int64_t limit,
+                     Kitsunemimi::ErrorContainer &error);
     bool deleteUser(const std::string &userId,
                     Kitsunemimi::ErrorContainer &error);
-    bool updateProjectsOfUser(const std::string &userId,
-                              const std::string &newProjects,
-                              Kitsunemimi::ErrorContainer &error);
+    bool addProjectToUser(bool &added,
+                          const std::string &userId,
+                          const std::string &projectId,
+                          const std::string &role,
+                          const bool isProjectAdmin,
+                          Kitsunemimi::ErrorContainer &error);
+    bool removeProjectFromUser(bool &removed,
+                               const std::string &userId,
+                               const std::string &projectId,
+                               Kitsunemimi::ErrorContainer &error);
+    bool migrateProjects(Kitsunemimi::ErrorContainer &error);
+    bool updatePasswordHash(const std::string &userId,
+                            const std::string &oldPwHash,
+                            const std::string &newPwHash,
+                            Kitsunemimi::ErrorContainer &error);
 
 private:
+    UserProjectsTable* m_userProjectsTable = nullptr;
+    UserCache* m_userCache = nullptr;
+
+    bool getCachedUser(CachedUser &user,
+                       const std::string &userId,
+                       Kitsunemimi::ErrorContainer &error);
+    bool loadUser(CachedUser &user,
+                  const std::string &userId,
+                  Kitsunemimi::ErrorContainer &error);
+    void convertUser(Kitsunemimi::JsonItem &result,
+                     const CachedUser &user,
+                     const bool showHiddenValues) const;
+
+    bool migrateProjectsOfUser(const std::string &userId,
+                               Kitsunemimi::JsonItem &legacyProjects,
+                               Kitsunemimi::ErrorContainer &error);
     bool getEnvVar(std::string &content, const std::string &key) const;
 
     bool getAllAdminUser(Kitsunemimi::ErrorContainer &error);
@@ -25,14 +25,58 @@
 #include <libKitsunemimiConfig/config_handler.h>
 #include <libKitsunemimiSakuraDatabase/sql_database.h>
 #include <libKitsunemimiCommon/files/text_file.h>
+#include <libKitsunemimiCommon/items/table_item.h>
+
+#include <core/token_cache.h>
+#include <core/rejected_token_cache.h>
+#include <core/policy_table.h>
+#include <core/token_verifier.h>
+#include <core/token_signer.h>
+#include <core/token_key_ring.h>
+#include <core/ed25519_key.h>
+#include <core/revocation_list.h>
+#include <core/credential_worker_pool.h>
+#include <core/latency_histogram.h>
+#include <core/rate_limiter.h>
+#include <core/memberships.h>
+#include <core/session_handler.h>
+#include <core/internal_token_cache.h>
+#include <database/sql_connection_pool.h>
+#include <database/user_cache.h>
 
 #include <api/blossom_initializing.h>
 
-Kitsunemimi::Jwt* MisakiRoot::jwt = nullptr;
+TokenKeyRing* MisakiRoot::tokenKeyRing = nullptr;
+Ed25519Key* MisakiRoot::ed25519Key = nullptr;
+TokenSigner* MisakiRoot::tokenSigner = nullptr;
+TokenVerifier* MisakiRoot::tokenVerifier = nullptr;
+Ed25519Key* MisakiRoot::internalKey = nullptr;
+TokenSigner* MisakiRoot::internalTokenSigner = nullptr;
+InternalTokenCache* MisakiRoot::internalTokenCache = nullptr;
 UsersTable* MisakiRoot::usersTable = nullptr;
+UserCache* MisakiRoot::userCache = nullptr;
+UserProjectsTable* MisakiRoot::userProjectsTable = nullptr;
 ProjectsTable* MisakiRoot::projectsTable = nullptr;
+RevocationsTable* MisakiRoot::revocationsTable = nullptr;
+SessionsTable* MisakiRoot::sessionsTable = nullptr;
 Kitsunemimi::Sakura::SqlDatabase* MisakiRoot::database = nullptr;
+SqlConnectionPool* MisakiRoot::sqlConnectionPool = nullptr;
 Kitsunemimi::Hanami::Policy* MisakiRoot::policies = nullptr;
+TokenCache* MisakiRoot::tokenCache = nullptr;
+RejectedTokenCache* MisakiRoot::rejectedTokenCache = nullptr;
+PolicyTable* MisakiRoot::policyTable = nullptr;
+RevocationList* MisakiRoot::revocationList = nullptr;
+CredentialWorkerPool* MisakiRoot::credentialWorkerPool = nullptr;
+RateLimiter* MisakiRoot::loginLimiter = nullptr;
+MembershipVersions* MisakiRoot::membershipVersions = nullptr;
+SessionHandler* MisakiRoot::sessionHandler = nullptr;
+LatencyHistogram* MisakiRoot::loginLatency = nullptr;
+LatencyHistogram* MisakiRoot::validateLatency = nullptr;
+LatencyHistogram* MisakiRoot::validateBatchLatency = nullptr;
+uint32_t MisakiRoot::passwordHashIterations = 0;
+bool MisakiRoot::tokenMemberships = false;
+uint32_t MisakiRoot::tokenLifetime = 0;
+std::atomic<bool> MisakiRoot::isReady(false);
 
 /**
  * @brief constructor
@@ -49,26 +93,62 @@ MisakiRoot::MisakiRoot() {}
 bool
 MisakiRoot::init(Kitsunemimi::ErrorContainer &error)
 {
+    loginLatency = new LatencyHistogram();
+    validateLatency = new LatencyHistogram();
+    validateBatchLatency = new LatencyHistogram();
+
     if(initDatabase(error) == false)
     {
         error.addMeesage("Failed to initialize database");
         return false;
     }
 
-    initBlossoms();
-
     if(initJwt(error) == false)
     {
         error.addMeesage("Failed to initialize jwt");
         return false;
     }
 
+    if(initInternalTokens(error) == false)
+    {
+        error.addMeesage("Failed to initialize internal tokens");
+        return false;
+    }
+
+    if(initTokenCaches(error) == false)
+    {
+        error.addMeesage("Failed to initialize token-caches");
+        return false;
+    }
+
+    if(initRevocations(error) == false)
+    {
+        error.addMeesage("Failed to initialize revocations");
+        return false;
+    }
+
+    if(initSessions(error) == false)
+    {
+        error.addMeesage("Failed to initialize sessions");
+        return false;
+    }
+
+    if(initCredentialWorkers(error) == false)
+    {
+        error.addMeesage("Failed to initialize credential-workers");
+        return false;
+    }
+
     if(initPolicies(error) == false)
     {
         error.addMeesage("Failed to initialize policies");
         return false;
     }
 
+    // blossoms are registered at the end, so no request can reach an uninitialized object
+    initBlossoms();
+    isReady = true;
+
     return true;
 }
 
@@ -100,27 +180,112 @@ MisakiRoot::initDatabase(Kitsunemimi::ErrorContainer &error)
         return false;
     }
 
+    // the generic connection is still used for the creation of the tables, so it has to wait
+    // for locks of the writer-connection instead of failing directly with SQLITE_BUSY
+    Kitsunemimi::TableItem busyTimeoutResult;
+    if(database->execSqlCommand(&busyTimeoutResult, "PRAGMA busy_timeout = 5000;", error) == false)
+    {
+        error.addMeesage("Failed to set busy-timeout of sql-database.");
+        return false;
+    }
+
+    // read cost of the password-hashing, which is also used for the initial admin-user
+    const long hashIterations = GET_INT_CONFIG("misaki", "password_hash_iterations", success);
+    if(success == false
+            || hashIterations <= 0
+            || hashIterations > 0xFFFFFFFF)
+    {
+        error.addMeesage("Invalid password_hash_iterations defined in config.");
+        return false;
+    }
+    passwordHashIterations = hashIterations;
+
+    // open separate connections for the prepared statements of the frequent lookups, where
+    // the queries are spread over multiple read-only connections
+    const long readConnections = GET_INT_CONFIG("misaki", "database_read_connections", success);
+    if(success == false
+            || readConnections <= 0)
+    {
+        error.addMeesage("Invalid database_read_connections defined in config.");
+        return false;
+    }
+
+    sqlConnectionPool = new SqlConnectionPool();
+    if(sqlConnectionPool->initPool(databasePath, readConnections, error) == false)
+    {
+        error.addMeesage("Failed to open sql-connections for prepared statements.");
+        return false;
+    }
+
+    // initialize table with the projects of the users
+    userProjectsTable = new UserProjectsTable(database, sqlConnectionPool);
+    if(userProjectsTable->createTable(error) == false)
+    {
+        error.addMeesage("Failed to initialize user-projects-table in database.");
+        return false;
+    }
+
     // initialize projects-table
-    projectsTable = new ProjectsTable(database);
+    projectsTable = new ProjectsTable(database, sqlConnectionPool, userProjectsTable);
     if(projectsTable->initTable(error) == false)
     {
         error.addMeesage("Failed to initialize project-table in database.");
         return false;
     }
 
+    // read size of the cache for the users from config
+    const long userCacheSize = GET_INT_CONFIG("misaki", "user_cache_size", success);
+    if(success == false
+            || userCacheSize <= 0)
+    {
+        error.addMeesage("Invalid user_cache_size defined in config.");
+        return false;
+    }
+    const long userCacheTtl = GET_INT_CONFIG("misaki", "user_cache_ttl", success);
+    if(success == false
+            || userCacheTtl <= 0
+            || userCacheTtl > 0xFFFFFFFF)
+    {
+        error.addMeesage("Invalid user_cache_ttl defined in config.");
+        return false;
+    }
+    userCache = new UserCache(userCacheSize, userCacheTtl);
+
     // initialize users-table
-    usersTable = new UsersTable(database);
+    usersTable = new UsersTable(database, sqlConnectionPool, userProjectsTable, userCache);
     if(usersTable->initTable(error) == false)
     {
         error.addMeesage("Failed to initialize user-table in database.");
         return false;
     }
-    if(usersTable->initNewAdminUser(error) == false)
+    if(usersTable->migrateProjects(error) == false)
+    {
+        error.addMeesage("Failed to migrate projects of the users into the user-projects-table.");
+        return false;
+    }
+    if(usersTable->initNewAdminUser(passwordHashIterations, error) == false)
     {
         error.addMeesage("Failed to initialize new admin-user even this is necessary.");
         return false;
     }
 
+    // initialize revocations-table
+    revocationsTable = new RevocationsTable(database, sqlConnectionPool);
+    if(revocationsTable->initTable(error) == false)
+    {
+        error.addMeesage("Failed to initialize revocations-table in database.");
+        return false;
+    }
+
+    // initialize sessions-table
+    sessionsTable = new SessionsTable(database, sqlConnectionPool);
+    if(sessionsTable->initTable(error) == false
+            || sessionsTable->initIndexes(error) == false)
+    {
+        error.addMeesage("Failed to initialize sessions-table in database.");
+        return false;
+    }
+
     return true;
 }
 
@@ -160,6 +325,9 @@ MisakiRoot::initPolicies(Kitsunemimi::ErrorContainer &error)
         return false;
     }
 
+    // create table for the compiled policy-decisions
+    policyTable = new PolicyTable(policies, policyFileContent);
+
     return true;
 }
 
@@ -175,24 +343,471 @@ MisakiRoot::initJwt(Kitsunemimi::ErrorContainer &error)
 {
     bool success = false;
 
+    const std::string algorithm = GET_STRING_CONFIG("misaki", "token_algorithm", success);
+    if(success == false)
+    {
+        error.addMeesage("token_algorithm not found in config.");
+        return false;
+    }
+    if(algorithm != "HS256"
+            && algorithm != "EdDSA")
+    {
+        error.addMeesage("Unsupported token_algorithm '" + algorithm + "' defined in config. "
+                         "Supported are 'HS256' and 'EdDSA'.");
+        return false;
+    }
+
+    // the shared secrets are still used for verification, when EdDSA is enabled, so tokens,
+    // which were created before the switch, stay valid until HS256 is disabled
+    const bool acceptHs256 = GET_BOOL_CONFIG("misaki", "token_accept_hs256", success);
+    if(success == false)
+    {
+        error.addMeesage("token_accept_hs256 not found in config.");
+        return false;
+    }
+    if(algorithm == "HS256"
+            && acceptHs256 == false)
+    {
+        error.addMeesage("token_accept_hs256 can not be disabled, while the tokens are signed "
+                         "with HS256.");
+        return false;
+    }
+
+    if(acceptHs256)
+    {
+        if(initTokenKeyRing(error) == false) {
+            return false;
+        }
+    }
+    else
+    {
+        // empty key-ring without shared secrets, which only holds the EdDSA-keys
+        tokenKeyRing = new TokenKeyRing("", false, 0);
+    }
+
+    if(algorithm == "HS256")
+    {
+        tokenSigner = new TokenSigner(tokenKeyRing);
+    }
+    else
+    {
+        if(initEd25519Key(error) == false) {
+            return false;
+        }
+        tokenSigner = new TokenSigner(ed25519Key);
+    }
+
+    tokenVerifier = new TokenVerifier(tokenKeyRing, acceptHs256);
+
+    // the lifetime is also used for the revocations, which must not expire before the tokens
+    const long lifetime = GET_INT_CONFIG("misaki", "token_lifetime", success);
+    if(success == false
+            || lifetime <= 0)
+    {
+        error.addMeesage("Invalid token_lifetime defined in config.");
+        return false;
+    }
+    tokenLifetime = static_cast<uint32_t>(lifetime);
+
+    // versions are always tracked, so the option can be enabled without losing changes
+    const long maxVersions = GET_INT_CONFIG("misaki", "membership_versions_size", success);
+    if(success == false
+            || maxVersions <= 0)
+    {
+        error.addMeesage("Invalid membership_versions_size defined in config.");
+        return false;
+    }
+    membershipVersions = new MembershipVersions(tokenLifetime, maxVersions);
+    tokenMemberships = GET_BOOL_CONFIG("misaki", "token_memberships", success);
+    if(success == false)
+    {
+        error.addMeesage("token_memberships not found in config.");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief init key-ring with the shared secrets to sign and verify HS256-tokens. If a
+ *        key-directory is defined, the keys are reloaded in the background, so they can be
+ *        rotated without restart.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+MisakiRoot::initTokenKeyRing(Kitsunemimi::ErrorContainer &error)
+{
+    bool success = false;
+
+    const std::string keyDirectory = GET_STRING_CONFIG("misaki", "token_key_dir", success);
+    if(keyDirectory != "")
+    {
+        const long previousKeys = GET_INT_CONFIG("misaki", "token_previous_keys", success);
+        if(success == false
+                || previousKeys < 0)
+        {
+            error.addMeesage("Invalid token_previous_keys defined in config.");
+            return false;
+        }
+
+        const long reloadInterval = GET_INT_CONFIG("misaki", "token_key_reload_interval", success);
+        if(success == false
+                || reloadInterval <= 0)
+        {
+            error.addMeesage("Invalid token_key_reload_interval defined in config.");
+            return false;
+        }
+
+        tokenKeyRing = new TokenKeyRing(keyDirectory, true, previousKeys);
+        if(tokenKeyRing->loadKeys(error) == false)
+        {
+            error.addMeesage("Failed to load token-keys from directory '" + keyDirectory + "'");
+            return false;
+        }
+        tokenKeyRing->startReloadThread(reloadInterval);
+
+        return true;
+    }
+
     // read jwt-token-key from config
     const std::string tokenKeyPath = GET_STRING_CONFIG("misaki", "token_key_path", success);
-    if(success == false)
+    if(success == false
+            || tokenKeyPath == "")
+    {
+        error.addMeesage("Neither token_key_dir nor token_key_path defined in config.");
+        return false;
+    }
+
+    tokenKeyRing = new TokenKeyRing(tokenKeyPath, false, 0);
+    if(tokenKeyRing->loadKeys(error) == false)
+    {
+        error.addMeesage("Failed to load token-key from file '" + tokenKeyPath + "'");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief init key to create EdDSA-signed tokens and add it, together with an optional
+ *        previous key, to the key-ring for the verification
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+MisakiRoot::initEd25519Key(Kitsunemimi::ErrorContainer &error)
+{
+    bool success = false;
+
+    const std::string keyPath = GET_STRING_CONFIG("misaki", "token_private_key_path", success);
+    if(success == false
+            || keyPath == "")
+    {
+        error.addMeesage("No token_private_key_path defined in config, which is necessary "
+                         "for EdDSA.");
+        return false;
+    }
+
+    ed25519Key = readEd25519Key(keyPath, error);
+    if(ed25519Key == nullptr) {
+        return false;
+    }
+    tokenKeyRing->addEd25519Key(ed25519Key);
+
+    // the previous key is still accepted for verification, so the key can be rotated without
+    // invalidating all existing tokens
+    const std::string previousKeyPath = GET_STRING_CONFIG("misaki",
+                                                          "token_previous_private_key_path",
+                                                          success);
+    if(success
+            && previousKeyPath != "")
+    {
+        Ed25519Key* previousKey = readEd25519Key(previousKeyPath, error);
+        if(previousKey == nullptr) {
+            return false;
+        }
+        if(previousKey->getKeyId() == ed25519Key->getKeyId())
+        {
+            error.addMeesage("token_previous_private_key_path contains the same key as "
+                             "token_private_key_path.");
+            delete previousKey;
+            return false;
+        }
+        tokenKeyRing->addEd25519Key(previousKey);
+    }
+
+    return true;
+}
+
+/**
+ * @brief read an Ed25519 private key from a file
+ *
+ * @param keyPath path to the file, which must contain the raw 32 byte private key
+ * @param error reference for error-output
+ *
+ * @return new key, or nullptr if the file could not be read or has an invalid size
+ */
+Ed25519Key*
+MisakiRoot::readEd25519Key(const std::string &keyPath,
+                           Kitsunemimi::ErrorContainer &error)
+{
+    std::string privateKey;
+    if(Kitsunemimi::readFile(privateKey, keyPath, error) == false)
+    {
+        error.addMeesage("Failed to read private key-file '" + keyPath + "'");
+        return nullptr;
+    }
+    if(privateKey.size() != Ed25519Key::PRIVATE_KEY_SIZE)
+    {
+        error.addMeesage("Private key in file '" + keyPath + "' has an invalid size. "
+                         "It must contain exactly 32 bytes.");
+        return nullptr;
+    }
+
+    return new Ed25519Key((const uint8_t*)privateKey.c_str());
+}
+
+/**
+ * @brief init key, signer and cache for the tokens of internal services. The internal tokens
+ *        are EdDSA-signed with a separate key, so services can verify them with the public key
+ *        only and internal tokens are never accepted as user-tokens and the other way round.
+ *        Without an internal key, the internal tokens are disabled.
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+MisakiRoot::initInternalTokens(Kitsunemimi::ErrorContainer &error)
+{
+    bool success = false;
+
+    const std::string keyPath = GET_STRING_CONFIG("misaki", "internal_token_key_path", success);
+    if(success == false
+            || keyPath == "")
+    {
+        LOG_WARNING("No internal_token_key_path defined in config, so internal tokens are "
+                    "disabled.");
+        return true;
+    }
+
+    internalKey = readEd25519Key(keyPath, error);
+    if(internalKey == nullptr)
+    {
+        error.addMeesage("Failed to load internal token-key from '" + keyPath + "'");
+        return false;
+    }
+
+    const long lifetime = GET_INT_CONFIG("misaki", "internal_token_lifetime", success);
+    if(success == false
+            || lifetime <= 0)
+    {
+        error.addMeesage("Invalid internal_token_lifetime defined in config.");
+        return false;
+    }
+
+    const long renewBefore = GET_INT_CONFIG("misaki", "internal_token_renew_before", success);
+    if(success == false
+            || renewBefore <= 0
+            || renewBefore >= lifetime)
+    {
+        error.addMeesage("Invalid internal_token_renew_before defined in config. "
+                         "It must be smaller than internal_token_lifetime.");
+        return false;
+    }
+
+    internalTokenSigner = new TokenSigner(internalKey);
+    internalTokenCache = new InternalTokenCache(internalTokenSigner, lifetime, renewBefore);
+    internalTokenCache->startRenewThread();
+
+    return true;
+}
+
+/**
+ * @brief init caches for already validated and recently rejected tokens
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+MisakiRoot::initTokenCaches(Kitsunemimi::ErrorContainer &error)
+{
+    bool success = false;
+
+    // read size of the cache from config
+    const long cacheSize = GET_INT_CONFIG("misaki", "token_cache_size", success);
+    if(success == false
+            || cacheSize <= 0)
+    {
+        error.addMeesage("Invalid token_cache_size defined in config.");
+        return false;
+    }
+
+    tokenCache = new TokenCache(cacheSize);
+
+    // the cache is cleared with each key-rotation, so removed keys are not accepted anymore
+    tokenKeyRing->setTokenCache(tokenCache);
+
+    // read size and time-to-live of the cache for rejected tokens from config
+    const long rejectedCacheSize = GET_INT_CONFIG("misaki", "rejected_token_cache_size", success);
+    if(success == false
+            || rejectedCacheSize <= 0)
+    {
+        error.addMeesage("Invalid rejected_token_cache_size defined in config.");
+        return false;
+    }
+
+    const long rejectedCacheTime = GET_INT_CONFIG("misaki", "rejected_token_cache_time", success);
+    if(success == false
+            || rejectedCacheTime <= 0)
+    {
+        error.addMeesage("Invalid rejected_token_cache_time defined in config.");
+        return false;
+    }
+
+    rejectedTokenCache = new RejectedTokenCache(rejectedCacheSize, rejectedCacheTime);
+
+    return true;
+}
+
+/**
+ * @brief init list of revoked tokens and load the persisted revocations from the database
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+MisakiRoot::initRevocations(Kitsunemimi::ErrorContainer &error)
+{
+    revocationList = new RevocationList(revocationsTable, tokenLifetime);
+    if(revocationList->loadRevocations(error) == false)
+    {
+        error.addMeesage("Failed to load revocations from database");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief init handler for the sessions of the refresh-tokens and start the removal of the
+ *        expired sessions in the background
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+MisakiRoot::initSessions(Kitsunemimi::ErrorContainer &error)
+{
+    bool success = false;
+
+    const long sessionLifetime = GET_INT_CONFIG("misaki", "refresh_token_lifetime", success);
+    if(success == false
+            || sessionLifetime <= 0)
+    {
+        error.addMeesage("Invalid refresh_token_lifetime defined in config.");
+        return false;
+    }
+
+    const long cleanupInterval = GET_INT_CONFIG("misaki", "session_cleanup_interval", success);
+    if(success == false
+            || cleanupInterval <= 0)
+    {
+        error.addMeesage("Invalid session_cleanup_interval defined in config.");
+        return false;
+    }
+
+    sessionHandler = new SessionHandler(sessionsTable, sessionLifetime);
+    sessionHandler->startCleanupThread(cleanupInterval);
+
+    return true;
+}
+
+/**
+ * @brief init worker-pool and rate-limiter for the credentials of login-requests
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+MisakiRoot::initCredentialWorkers(Kitsunemimi::ErrorContainer &error)
+{
+    bool success = false;
+
+    const long numberOfWorkers = GET_INT_CONFIG("misaki", "password_workers", success);
+    if(success == false
+            || numberOfWorkers <= 0)
+    {
+        error.addMeesage("Invalid password_workers defined in config.");
+        return false;
+    }
+
+    const long queueSize = GET_INT_CONFIG("misaki", "password_queue_size", success);
+    if(success == false
+            || queueSize <= 0)
+    {
+        error.addMeesage("Invalid password_queue_size defined in config.");
+        return false;
+    }
+
+    // has to be well below the number of messaging-threads, because each waiting request blocks
+    // one of these threads
+    const long maxWaiting = GET_INT_CONFIG("misaki", "password_max_waiting_requests", success);
+    if(success == false
+            || maxWaiting <= 0)
+    {
+        error.addMeesage("Invalid password_max_waiting_requests defined in config.");
+        return false;
+    }
+
+    const long waitTimeout = GET_INT_CONFIG("misaki", "password_wait_timeout", success);
+    if(success == false
+            || waitTimeout <= 0)
+    {
+        error.addMeesage("Invalid password_wait_timeout defined in config.");
+        return false;
+    }
+
+    credentialWorkerPool = new CredentialWorkerPool(numberOfWorkers,
+                                                    queueSize,
+                                                    maxWaiting,
+                                                    waitTimeout);
+
+    // limiter for the login-attempts in front of the worker-pool
+    const long attemptsPerMinute = GET_INT_CONFIG("misaki", "login_attempts_per_minute", success);
+    if(success == false
+            || attemptsPerMinute <= 0)
+    {
+        error.addMeesage("Invalid login_attempts_per_minute defined in config.");
+        return false;
+    }
+
+    const long burstSize = GET_INT_CONFIG("misaki", "login_burst_size", success);
+    if(success == false
+            || burstSize <= 0)
     {
-        error.addMeesage("No token_key_path defined in config.");
+        error.addMeesage("Invalid login_burst_size defined in config.");
         return false;
     }
 
-    std::string tokenKeyString;
-    if(Kitsunemimi::readFile(tokenKeyString, tokenKeyPath, error) == false)
+    const long limiterSize = GET_INT_CONFIG("misaki", "login_limiter_size", success);
+    if(success == false
+            || limiterSize <= 0)
     {
-        error.addMeesage("Failed to read token-file '" + tokenKeyPath + "'");
+        error.addMeesage("Invalid login_limiter_size defined in config.");
         return false;
     }
 
-    // init jwt for token create and sign
-    CryptoPP::SecByteBlock tokenKey((unsigned char*)tokenKeyString.c_str(), tokenKeyString.size());
-    jwt = new Kitsunemimi::Jwt(tokenKey);
+    loginLimiter = new RateLimiter(attemptsPerMinute, burstSize, limiterSize);
 
     return true;
 }
@@ -23,10 +23,31 @@
 #ifndef MISAKIGUARD_MISAKIROOT_H
 #define MISAKIGUARD_MISAKIROOT_H
 
-#include <libKitsunemimiJwt/jwt.h>
+#include <atomic>
+
 #include <libKitsunemimiHanamiPolicies/policy.h>
 #include <database/users_table.h>
+#include <database/user_projects_table.h>
 #include <database/projects_table.h>
+#include <database/revocations_table.h>
+#include <database/sessions_table.h>
+
+class TokenCache;
+class RejectedTokenCache;
+class PolicyTable;
+class TokenVerifier;
+class TokenSigner;
+class TokenKeyRing;
+class Ed25519Key;
+class RevocationList;
+class CredentialWorkerPool;
+class LatencyHistogram;
+class RateLimiter;
+class MembershipVersions;
+class SessionHandler;
+class InternalTokenCache;
+class SqlConnectionPool;
+class UserCache;
 
 class MisakiRoot
 {
@@ -35,16 +56,52 @@ public:
 
     bool init(Kitsunemimi::ErrorContainer &error);
 
-    static Kitsunemimi::Jwt* jwt;
+    static TokenKeyRing* tokenKeyRing;
+    static Ed25519Key* ed25519Key;
+    static TokenSigner* tokenSigner;
+    static TokenVerifier* tokenVerifier;
+    static Ed25519Key* internalKey;
+    static TokenSigner* internalTokenSigner;
+    static InternalTokenCache* internalTokenCache;
     static UsersTable* usersTable;
+    static UserCache* userCache;
+    static UserProjectsTable* userProjectsTable;
     static ProjectsTable* projectsTable;
+    static RevocationsTable* revocationsTable;
+    static SessionsTable* sessionsTable;
     static Kitsunemimi::Sakura::SqlDatabase* database;
+    static SqlConnectionPool* sqlConnectionPool;
     static Kitsunemimi::Hanami::Policy* policies;
+    static TokenCache* tokenCache;
+    static RejectedTokenCache* rejectedTokenCache;
+    static PolicyTable* policyTable;
+    static RevocationList* revocationList;
+    static CredentialWorkerPool* credentialWorkerPool;
+    static RateLimiter* loginLimiter;
+    static MembershipVersions* membershipVersions;
+    static SessionHandler* sessionHandler;
+    static LatencyHistogram* loginLatency;
+    static LatencyHistogram* validateLatency;
+    static LatencyHistogram* validateBatchLatency;
+    static uint32_t passwordHashIterations;
+    static bool tokenMemberships;
+    static uint32_t tokenLifetime;
+    // set at the end of the initialization, because the callbacks of the messaging are
+    // already registered before and must reject the requests until then
+    static std::atomic<bool> isReady;
 
 private:
     bool initDatabase(Kitsunemimi::ErrorContainer &error);
     bool initPolicies(Kitsunemimi::ErrorContainer &error);
     bool initJwt(Kitsunemimi::ErrorContainer &error);
+    bool initTokenKeyRing(Kitsunemimi::ErrorContainer &error);
+    bool initEd25519Key(Kitsunemimi::ErrorContainer &error);
+    Ed25519Key* readEd25519Key(const std::string &keyPath, Kitsunemimi::ErrorContainer &error);
+    bool initInternalTokens(Kitsunemimi::ErrorContainer &error);
+    bool initTokenCaches(Kitsunemimi::ErrorContainer &error);
+    bool initRevocations(Kitsunemimi::ErrorContainer &error);
+    bool initSessions(Kitsunemimi::ErrorContainer &error);
+    bool initCredentialWorkers(Kitsunemimi::ErrorContainer &error);
 };
 
 #endif // MISAKIGUARD_MISAKIROOT_H